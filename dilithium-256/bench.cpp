@@ -0,0 +1,367 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include "bench.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_RDTSC
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define BENCH_PERF
+#endif
+
+int bench_pin(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+
+    if (cpu < 0)
+    {
+        cpu = sched_getcpu();
+    }
+    if (cpu < 0)
+    {
+        return -1;
+    }
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set))
+    {
+        return -1;
+    }
+    return cpu;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+const char *bench_unit(void)
+{
+#ifdef BENCH_RDTSC
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+uint64_t bench_now(void)
+{
+#ifdef BENCH_RDTSC
+    uint64_t t;
+
+    // Keep the kernel's instructions on their side of the timestamp
+    _mm_lfence();
+    t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+// Cost of an empty timed region, smallest of many
+static uint64_t bench_overhead(void)
+{
+    static uint64_t overhead = UINT64_MAX;
+    uint64_t t0, t1;
+
+    if (overhead == UINT64_MAX)
+    {
+        for (unsigned i = 0; i < 10000; i++)
+        {
+            t0 = bench_now();
+            t1 = bench_now();
+            overhead = std::min(overhead, t1 - t0);
+        }
+    }
+    return overhead;
+}
+
+void bench_stats(bench_result *r, uint64_t *samples, unsigned n)
+{
+    std::sort(samples, samples + n);
+    r->runs = n;
+    r->min = n ? samples[0] : 0;
+    r->median = n ? samples[n / 2] : 0;
+    r->p99 = n ? samples[(n * 99ULL) / 100] : 0;
+}
+
+// ================ HARDWARE COUNTERS ========================
+
+static const char *const counter_names[BENCH_COUNTERS] = {
+    "cycles", "instructions", "branch_misses", "l1d_misses"};
+
+#ifdef BENCH_PERF
+
+/*
+ * One group, led by the first event that opened, so all events count
+ * over the same instructions. fd[c] is -1 for a missing event, slot[c]
+ * its position in the group read.
+ */
+static int fd[BENCH_COUNTERS] = {-1, -1, -1, -1};
+static unsigned slot[BENCH_COUNTERS];
+static unsigned opened, nr;
+static int leader = -1;
+
+static int counter_open(unsigned c)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled = (leader < 0);
+
+    switch (c)
+    {
+    case BENCH_CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case BENCH_INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case BENCH_BRANCH_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    }
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+}
+
+unsigned bench_counters_open(void)
+{
+    bench_counters_close();
+
+    for (unsigned c = 0; c < BENCH_COUNTERS; c++)
+    {
+        fd[c] = counter_open(c);
+        if (fd[c] < 0)
+        {
+            continue;
+        }
+        if (leader < 0)
+        {
+            leader = fd[c];
+        }
+        slot[c] = nr++;
+        opened |= 1u << c;
+    }
+    return opened;
+}
+
+void bench_counters_close(void)
+{
+    for (unsigned c = 0; c < BENCH_COUNTERS; c++)
+    {
+        if (fd[c] >= 0)
+        {
+            close(fd[c]);
+        }
+        fd[c] = -1;
+    }
+    leader = -1;
+    opened = nr = 0;
+}
+
+static void bench_count(bench_result *r, void (*fn)(void *), void (*reset)(void *),
+                        void *arg, unsigned runs)
+{
+    // nr, time_enabled, time_running, values
+    uint64_t buf[3 + BENCH_COUNTERS];
+
+    r->counters = 0;
+    if (opened == 0 || runs == 0)
+    {
+        return;
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    for (unsigned i = 0; i < runs; i++)
+    {
+        if (reset)
+            reset(arg);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        fn(arg);
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    // A group the kernel never scheduled counted nothing, report no counters
+    if (read(leader, buf, sizeof(buf)) < (ssize_t)((3 + nr) * sizeof(uint64_t)) ||
+        buf[0] != nr || buf[2] == 0)
+    {
+        return;
+    }
+    for (unsigned c = 0; c < BENCH_COUNTERS; c++)
+    {
+        if (opened & (1u << c))
+        {
+            r->count[c] = (double)buf[3 + slot[c]] / runs;
+        }
+    }
+    r->counters = opened;
+}
+
+#else
+
+unsigned bench_counters_open(void)
+{
+    return 0;
+}
+
+void bench_counters_close(void)
+{
+}
+
+static void bench_count(bench_result *r, void (*fn)(void *), void (*reset)(void *),
+                        void *arg, unsigned runs)
+{
+    (void)fn;
+    (void)reset;
+    (void)arg;
+    (void)runs;
+    r->counters = 0;
+}
+
+#endif
+
+static int has_ipc(const bench_result *r)
+{
+    const unsigned need = (1u << BENCH_CYCLES) | (1u << BENCH_INSTRUCTIONS);
+
+    return (r->counters & need) == need && r->count[BENCH_CYCLES] > 0;
+}
+
+void bench_run(bench_result *r, const char *name,
+               void (*fn)(void *), void (*reset)(void *), void *arg,
+               unsigned warmup, unsigned runs)
+{
+    const uint64_t overhead = bench_overhead();
+    std::vector<uint64_t> samples(runs);
+    uint64_t t0, t1;
+
+    for (unsigned i = 0; i < warmup; i++)
+    {
+        if (reset)
+            reset(arg);
+        fn(arg);
+    }
+
+    for (unsigned i = 0; i < runs; i++)
+    {
+        if (reset)
+            reset(arg);
+        t0 = bench_now();
+        fn(arg);
+        t1 = bench_now();
+        samples[i] = (t1 - t0 > overhead) ? t1 - t0 - overhead : 0;
+    }
+
+    r->name = name;
+    bench_stats(r, samples.data(), runs);
+    bench_count(r, fn, reset, arg, runs);
+}
+
+void bench_print(FILE *f, const bench_result *r)
+{
+    fprintf(f, "%-24s median %10llu  p99 %10llu  min %10llu %s", r->name,
+            (unsigned long long)r->median, (unsigned long long)r->p99,
+            (unsigned long long)r->min, bench_unit());
+    if (has_ipc(r))
+    {
+        fprintf(f, "  ipc %5.2f", r->count[BENCH_INSTRUCTIONS] / r->count[BENCH_CYCLES]);
+    }
+    for (unsigned c = BENCH_INSTRUCTIONS; c < BENCH_COUNTERS; c++)
+    {
+        if (r->counters & (1u << c))
+        {
+            fprintf(f, "  %s %.1f", counter_names[c], r->count[c]);
+        }
+    }
+    fprintf(f, "\n");
+}
+
+void bench_json(FILE *f, const char *suite, int cpu, const bench_result *r, size_t n)
+{
+    unsigned counters = n ? r[0].counters : 0;
+
+    fprintf(f, "{\n  \"suite\": \"%s\",\n  \"unit\": \"%s\",\n  \"cpu\": %d,\n",
+            suite, bench_unit(), cpu);
+    fprintf(f, "  \"counters\": [");
+    for (unsigned c = 0, first = 1; c < BENCH_COUNTERS; c++)
+    {
+        if (counters & (1u << c))
+        {
+            fprintf(f, "%s\"%s\"", first ? "" : ", ", counter_names[c]);
+            first = 0;
+        }
+    }
+    fprintf(f, "],\n  \"results\": [\n");
+
+    for (size_t i = 0; i < n; i++)
+    {
+        fprintf(f, "    {\"name\": \"%s\", \"runs\": %u, \"min\": %llu, \"median\": %llu, \"p99\": %llu",
+                r[i].name, r[i].runs, (unsigned long long)r[i].min,
+                (unsigned long long)r[i].median, (unsigned long long)r[i].p99);
+        if (has_ipc(&r[i]))
+        {
+            fprintf(f, ", \"ipc\": %.3f", r[i].count[BENCH_INSTRUCTIONS] / r[i].count[BENCH_CYCLES]);
+        }
+        for (unsigned c = BENCH_INSTRUCTIONS; c < BENCH_COUNTERS; c++)
+        {
+            if (r[i].counters & (1u << c))
+            {
+                fprintf(f, ", \"%s\": %.1f", counter_names[c], r[i].count[c]);
+            }
+        }
+        fprintf(f, "}%s\n", (i + 1 < n) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
@@ -0,0 +1,107 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Benchmark harness shared by the bench_* programs.
+ * A kernel runs `warmup` untimed times, then `runs` times with one
+ * timestamp pair around every call. Counts are rdtsc cycles on x86,
+ * CLOCK_MONOTONIC nanoseconds elsewhere, minus the cost of an empty
+ * timed region.
+ */
+#define BENCH_WARMUP 1000
+#define BENCH_RUNS 10000
+
+/*
+ * Hardware counters, per call of the kernel. Only filled when
+ * bench_counters_open succeeded; bit c of `counters` is set when
+ * count[c] is valid.
+ */
+enum
+{
+    BENCH_CYCLES,
+    BENCH_INSTRUCTIONS,
+    BENCH_BRANCH_MISSES,
+    BENCH_L1D_MISSES,
+    BENCH_COUNTERS
+};
+
+typedef struct
+{
+    const char *name;
+    unsigned runs;
+    uint64_t min;
+    uint64_t median;
+    uint64_t p99;
+    unsigned counters;
+    double count[BENCH_COUNTERS];
+} bench_result;
+
+// Pin the calling thread to cpu, -1 for the one it is on. Return the CPU, -1 on failure
+int bench_pin(int cpu);
+
+// "cycles" or "ns"
+const char *bench_unit(void);
+
+uint64_t bench_now(void);
+
+/*
+ * Open cycles, instructions, branch-misses and L1D read misses with
+ * perf_event_open, user space only, for the calling thread. Events the
+ * CPU or kernel does not give are skipped. Return the mask of the opened
+ * ones, 0 when there are none: bench_run then reports cycles only.
+ */
+unsigned bench_counters_open(void);
+void bench_counters_close(void);
+
+/*
+ * Time fn(arg). reset(arg), if not NULL, runs untimed before every call,
+ * e.g. to reload the input of an in-place kernel.
+ * With counters open, a second pass of `runs` calls counts events with
+ * the counters enabled around fn only, so the timed pass never pays for
+ * the ioctls.
+ */
+void bench_run(bench_result *r, const char *name,
+               void (*fn)(void *), void (*reset)(void *), void *arg,
+               unsigned warmup, unsigned runs);
+
+// Median and p99 of n samples, sorts them
+void bench_stats(bench_result *r, uint64_t *samples, unsigned n);
+
+// One line per result, for people
+void bench_print(FILE *f, const bench_result *r);
+
+/*
+ * {"suite", "unit", "cpu", "counters", "results": [{"name", "runs", "min",
+ * "median", "p99", and per call "instructions", "ipc", "branch_misses",
+ * "l1d_misses" when counted}]}
+ */
+void bench_json(FILE *f, const char *suite, int cpu, const bench_result *r, size_t n);
+
+#endif
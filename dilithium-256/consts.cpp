@@ -25,7 +25,8 @@
 #include "params.h"
 #include "consts.h"
 
-/*  const int32_t zetas[DILITHIUM_N] = {
+// Same roots times 2^32 mod Q, for the Montgomery butterflies of software_code/poly.cpp
+const data_t zetas_mont[DILITHIUM_N] = {
          0,    25847, -2608894,  -518909,   237124,  -777960,  -876248,   466468,
    1826347,  2353451,  -359251, -2091905,  3119733, -2884855,  3111497,  2680103,
    2725464,  1024112, -1079900,  3585928,  -549488, -1119584,  2619752, -2108549,
@@ -59,7 +60,6 @@
   -2939036, -2235985,  -420899, -2286327,   183443,  -976891,  1612842, -3545687,
    -554416,  3919660,   -48306, -1362209,  3937738,  1400424,  -846154,  1976782
 };
- */
 
 const data_t zetas_barrett[DILITHIUM_N] = {
         0, -3572223,  3765607,  3761513, -3201494, -2883726, -3145678, -3201430, 
@@ -28,5 +28,6 @@
 #include "params.h"
 
 extern const data_t zetas_barrett[DILITHIUM_N];
+extern const data_t zetas_mont[DILITHIUM_N];
 
 #endif 
@@ -0,0 +1,211 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../params.h"
+#include "../reference_code/ref_ntt2x2.h"
+#include "../reference_code/ref_ntt.h"
+#include "../bench.h"
+#include "config.h"
+#include "ntt2x2.h"
+#include "util.h"
+
+/*
+ * Cycles of the reference and hardware-model NTT kernels.
+ * In-place kernels reload their input untimed before every call.
+ * --perf adds hardware counters: IPC, and instructions, branch misses
+ * and L1D read misses per polynomial operation.
+ * Usage: bench_ntt [--perf] [out.json]
+ */
+
+typedef struct
+{
+    data_t a[DILITHIUM_N], b[DILITHIUM_N];
+    data_t x[DILITHIUM_N], y[DILITHIUM_N];
+    bram ram_a, ram_b;
+} bench_data;
+
+static void reload(void *arg)
+{
+    bench_data *d = (bench_data *)arg;
+
+    memcpy(d->x, d->a, sizeof(d->x));
+    memcpy(d->y, d->b, sizeof(d->y));
+}
+
+static void reload_bram(void *arg)
+{
+    bench_data *d = (bench_data *)arg;
+
+    reshape(&d->ram_a, d->a);
+    reshape(&d->ram_b, d->b);
+}
+
+// ================ REFERENCE ========================
+
+static void run_ntt(void *arg)
+{
+    ntt(((bench_data *)arg)->x);
+}
+
+static void run_invntt(void *arg)
+{
+    invntt(((bench_data *)arg)->x);
+}
+
+static void run_ntt2x2_ref(void *arg)
+{
+    ntt2x2_ref(((bench_data *)arg)->x);
+}
+
+static void run_invntt2x2_ref(void *arg)
+{
+    invntt2x2_ref(((bench_data *)arg)->x);
+}
+
+static void run_pointwise_barrett(void *arg)
+{
+    bench_data *d = (bench_data *)arg;
+
+    pointwise_barrett(d->x, d->a, d->b);
+}
+
+// a * b in Z_q[X]/(X^N + 1)
+static void run_polymul(void *arg)
+{
+    bench_data *d = (bench_data *)arg;
+
+    ntt(d->x);
+    ntt(d->y);
+    pointwise_barrett(d->x, d->x, d->y);
+    invntt(d->x);
+}
+
+// ================ HARDWARE MODEL ========================
+
+static void run_hw_fwdntt(void *arg)
+{
+    ntt2x2_fwdntt(&((bench_data *)arg)->ram_a, FORWARD_NTT_MODE, NATURAL);
+}
+
+static void run_hw_invntt(void *arg)
+{
+    ntt2x2_invntt(&((bench_data *)arg)->ram_a, INVERSE_NTT_MODE, NATURAL);
+}
+
+static void run_hw_mul(void *arg)
+{
+    bench_data *d = (bench_data *)arg;
+
+    ntt2x2_mul(&d->ram_a, &d->ram_b, NATURAL);
+}
+
+static void run_hw_polymul(void *arg)
+{
+    bench_data *d = (bench_data *)arg;
+
+    ntt2x2_fwdntt(&d->ram_a, FORWARD_NTT_MODE, NATURAL);
+    ntt2x2_fwdntt(&d->ram_b, FORWARD_NTT_MODE, NATURAL);
+    ntt2x2_mul(&d->ram_a, &d->ram_b, NATURAL);
+    ntt2x2_invntt(&d->ram_a, INVERSE_NTT_MODE, AFTER_NTT);
+}
+
+typedef struct
+{
+    const char *name;
+    void (*fn)(void *);
+    void (*reset)(void *);
+} kernel;
+
+static const kernel kernels[] = {
+    {"ntt", run_ntt, reload},
+    {"invntt", run_invntt, reload},
+    {"ntt2x2_ref", run_ntt2x2_ref, reload},
+    {"invntt2x2_ref", run_invntt2x2_ref, reload},
+    {"pointwise_barrett", run_pointwise_barrett, NULL},
+    {"polymul", run_polymul, reload},
+    {"ntt2x2_fwdntt", run_hw_fwdntt, reload_bram},
+    {"ntt2x2_invntt", run_hw_invntt, reload_bram},
+    {"ntt2x2_mul", run_hw_mul, reload_bram},
+    {"ntt2x2_polymul", run_hw_polymul, reload_bram},
+};
+
+#define KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+int main(int argc, char **argv)
+{
+    static bench_data d;
+    bench_result r[KERNELS];
+    const char *json = NULL;
+    FILE *f;
+    int cpu;
+
+    srand(0);
+    for (int i = 0; i < DILITHIUM_N; i++)
+    {
+        d.a[i] = rand() % DILITHIUM_Q;
+        d.b[i] = rand() % DILITHIUM_Q;
+    }
+
+    cpu = bench_pin(-1);
+    printf("NTT kernels, pinned to CPU %d, %s\n", cpu, bench_unit());
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--perf") == 0)
+        {
+            if (bench_counters_open() == 0)
+                printf("Hardware counters not available, cycles only\n");
+        }
+        else
+        {
+            json = argv[i];
+        }
+    }
+
+    for (unsigned k = 0; k < KERNELS; k++)
+    {
+        bench_run(&r[k], kernels[k].name, kernels[k].fn, kernels[k].reset, &d,
+                  BENCH_WARMUP, BENCH_RUNS);
+        bench_print(stdout, &r[k]);
+    }
+
+    bench_counters_close();
+
+    if (json)
+    {
+        f = fopen(json, "w");
+        if (f == NULL)
+        {
+            printf("Cannot write %s\n", json);
+            return 1;
+        }
+        bench_json(f, "ntt", cpu, r, KERNELS);
+        fclose(f);
+    }
+    return 0;
+}
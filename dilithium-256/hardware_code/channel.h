@@ -0,0 +1,168 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+/*
+ * Latency-insensitive valid/ready channels to join the C++ stage models
+ * the way the RTL blocks are joined (DecoupledStage in Barrett_8380417.v,
+ * the samplers, encoder and decoder).
+ * A channel is a bounded queue of DEPTH entries between two stages.
+ * Within a cycle the consumer sees what was queued at the start of the
+ * cycle and pops at most one entry; a push lands at the clock edge, as
+ * into a register. ready counts the pop already made this cycle, so
+ * stages stepped from the sink back to the source get the in_ready =
+ * ~valid | out_ready of DecoupledStage: full throughput at DEPTH 1.
+ * Stepped the other way round the channel still works, one entry short.
+ */
+
+template <typename T, unsigned DEPTH>
+struct channel
+{
+    T q[DEPTH];
+    unsigned head, count;
+    T in; // pushed this cycle, queued at the clock edge
+    bool pushed, popped;
+
+    // Per cycle: an entry moved, the producer held off, the consumer starved
+    unsigned long long cycles, transfers, full, empty, occupancy;
+};
+
+template <typename T, unsigned DEPTH>
+void ch_init(channel<T, DEPTH> *c)
+{
+    c->head = c->count = 0;
+    c->pushed = c->popped = false;
+    c->cycles = c->transfers = c->full = c->empty = c->occupancy = 0;
+}
+
+template <typename T, unsigned DEPTH>
+bool ch_valid(const channel<T, DEPTH> *c)
+{
+    return c->count > 0 && !c->popped;
+}
+
+template <typename T, unsigned DEPTH>
+bool ch_ready(const channel<T, DEPTH> *c)
+{
+    return c->count < DEPTH && !c->pushed;
+}
+
+template <typename T, unsigned DEPTH>
+const T *ch_front(const channel<T, DEPTH> *c)
+{
+    return &c->q[c->head];
+}
+
+// Take the front entry, false and a starved cycle when there is none
+template <typename T, unsigned DEPTH>
+bool ch_pop(channel<T, DEPTH> *c, T *out)
+{
+    if (!ch_valid(c))
+    {
+        c->empty += !c->popped;
+        return false;
+    }
+    if (out != NULL)
+        *out = c->q[c->head];
+    c->head = (c->head + 1) % DEPTH;
+    c->count--;
+    c->popped = true;
+    c->transfers++;
+    return true;
+}
+
+// Offer v, false and a backpressure cycle when the channel is full
+template <typename T, unsigned DEPTH>
+bool ch_push(channel<T, DEPTH> *c, const T &v)
+{
+    if (!ch_ready(c))
+    {
+        c->full += !c->pushed;
+        return false;
+    }
+    c->in = v;
+    c->pushed = true;
+    return true;
+}
+
+// Rising edge of clk
+template <typename T, unsigned DEPTH>
+void ch_clock(channel<T, DEPTH> *c)
+{
+    if (c->pushed)
+    {
+        c->q[(c->head + c->count) % DEPTH] = c->in;
+        c->count++;
+    }
+    c->pushed = c->popped = false;
+    c->cycles++;
+    c->occupancy += c->count;
+}
+
+/*
+ * LATENCY DecoupledStages in a row with f applied on the way in: an
+ * operator with an initiation interval of 1 that holds up to LATENCY
+ * entries when its output is blocked.
+ */
+template <typename T, unsigned LATENCY>
+struct delay_stage
+{
+    T data[LATENCY];
+    bool valid[LATENCY];
+    void (*f)(T *);
+};
+
+template <typename T, unsigned LATENCY>
+void ds_init(delay_stage<T, LATENCY> *d, void (*f)(T *))
+{
+    for (unsigned i = 0; i < LATENCY; i++)
+        d->valid[i] = false;
+    d->f = f;
+}
+
+// One cycle, registers moved from the output back, as in_ready would pass
+template <typename T, unsigned LATENCY, unsigned DEPTH_IN, unsigned DEPTH_OUT>
+void ds_step(delay_stage<T, LATENCY> *d, channel<T, DEPTH_IN> *in, channel<T, DEPTH_OUT> *out)
+{
+    if (d->valid[LATENCY - 1] && ch_push(out, d->data[LATENCY - 1]))
+        d->valid[LATENCY - 1] = false;
+    for (unsigned i = LATENCY - 1; i > 0; i--)
+    {
+        if (d->valid[i - 1] && !d->valid[i])
+        {
+            d->data[i] = d->data[i - 1];
+            d->valid[i] = true;
+            d->valid[i - 1] = false;
+        }
+    }
+    if (!d->valid[0] && ch_pop(in, &d->data[0]))
+    {
+        if (d->f != NULL)
+            d->f(&d->data[0]);
+        d->valid[0] = true;
+    }
+}
+
+#endif
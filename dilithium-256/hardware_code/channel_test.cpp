@@ -0,0 +1,140 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "channel.h"
+#include "pipeline.h"
+
+/*
+ * Channels and delay stages: order, no loss under backpressure, and the
+ * throughput of the DecoupledStage pass-through. Then the keygen t1
+ * pipeline of pipeline.h against its models run one after the other.
+ */
+
+#define ITEMS 1000
+
+static void plus_one(unsigned *v)
+{
+    (*v)++;
+}
+
+/*
+ * source -> channel -> delay_stage -> channel -> sink, the sink ready on
+ * `every`-th cycles. Return the cycles to move ITEMS, 0 on a lost or
+ * reordered item.
+ */
+template <unsigned DEPTH>
+static unsigned run(unsigned every)
+{
+    channel<unsigned, DEPTH> a, b;
+    delay_stage<unsigned, 3> d;
+    unsigned sent = 0, got = 0, cycles = 0, v;
+
+    ch_init(&a);
+    ch_init(&b);
+    ds_init(&d, plus_one);
+    while (got < ITEMS && cycles < 100 * ITEMS)
+    {
+        if (cycles % every == 0 && ch_pop(&b, &v))
+        {
+            if (v != got + 1)
+                return 0;
+            got++;
+        }
+        ds_step(&d, &a, &b);
+        if (sent < ITEMS && ch_push(&a, sent))
+            sent++;
+        ch_clock(&a);
+        ch_clock(&b);
+        cycles++;
+    }
+    return got == ITEMS ? cycles : 0;
+}
+
+static int check_channels()
+{
+    unsigned c;
+    int ret = 0;
+
+    // Full rate at depth 1: ITEMS cycles plus the fill of the stages
+    c = run<1>(1);
+    if (c == 0 || c > ITEMS + 5)
+    {
+        printf("channel: depth 1, %u cycles for %u items\n", c, ITEMS);
+        ret = 1;
+    }
+    // Backpressure: the sink sets the rate, nothing lost
+    for (unsigned every = 2; every <= 4; every++)
+    {
+        c = run<2>(every);
+        if (c == 0 || c > every * ITEMS + 5)
+        {
+            printf("channel: sink every %u cycles, %u cycles for %u items\n", every, c, ITEMS);
+            ret = 1;
+        }
+    }
+    return ret;
+}
+
+static int check_pipeline()
+{
+    const int levels[3] = {2, 3, 5};
+    pipe_config c;
+    pipe_result r;
+    int ret = 0;
+
+    c.samplers = 2;
+    c.rounds = 1;
+    c.depth = 4096;
+    tlm_timing_default(&c.t);
+    for (int l = 0; l < 3; l++)
+    {
+        c.sec_lvl = levels[l];
+        c.axi_ready = 100;
+        c.paced = 0;
+        ret |= pipe_run(&r, &c) || !r.ok;
+
+        // The encoder as in encoder.v overflows when AXI is slow, paced it does not
+        c.axi_ready = 25;
+        ret |= pipe_run(&r, &c) || r.ok || r.enc_overflow == 0;
+        c.paced = 1;
+        ret |= pipe_run(&r, &c) || !r.ok;
+        if (ret)
+        {
+            printf("pipeline: level %d wrong\n", levels[l]);
+            break;
+        }
+    }
+    return ret;
+}
+
+int main()
+{
+    int ret = check_channels();
+
+    ret |= check_pipeline();
+    printf(ret ? "ERROR\n" : "OK\n");
+    return ret;
+}
@@ -0,0 +1,360 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <string.h>
+#include "combined_tlm.h"
+#include "gen_a_model.h"
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+#define SEEDBYTES 32
+#define CRHBYTES 64
+#define SHAKE128_RATE 168
+#define SHAKE256_RATE 136
+#define KECCAK_ROUNDS 24
+
+/* ===================== keccak_top and the samplers ===================== */
+
+static unsigned keccak_perm(const tlm_timing *t)
+{
+    return (KECCAK_ROUNDS + t->keccak_rounds - 1) / t->keccak_rounds;
+}
+
+/*
+ * Header word to the last block permuted. keccak_fsm1 loads a block a
+ * word per cycle, padding included, while keccak_fsm2 permutes the
+ * previous one.
+ */
+static unsigned keccak_absorb(const tlm_timing *t, unsigned bytes, unsigned rate)
+{
+    unsigned words = rate / 8, blocks = bytes / rate + 1;
+
+    return 1 + words + (blocks - 1) * MAX(words, keccak_perm(t)) + keccak_perm(t);
+}
+
+/*
+ * End of absorb to the last of `out` words. finalization_SHAKE hands a
+ * block to sha3_fsm3 and shake_process permutes the next one meanwhile.
+ */
+static unsigned keccak_squeeze(const tlm_timing *t, unsigned out, unsigned rate)
+{
+    unsigned words = rate / 8, blocks = (out + words - 1) / words;
+
+    return 1 + (blocks - 1) * MAX(keccak_perm(t) + 1, words + 1) + 1 + out - (blocks - 1) * words;
+}
+
+// Accepted coefficients per block decide how many blocks a polynomial takes
+static unsigned blocks_for(double coeffs_per_block)
+{
+    unsigned b = 1;
+
+    while (b * coeffs_per_block < DILITHIUM_N)
+        b++;
+    return b;
+}
+
+/*
+ * gen_a_ext from the cycle model of gen_a_model.h on a fixed rho. The
+ * samplers run in lockstep rounds, so one polynomial on one sampler
+ * takes a round. rejection_a drains slower than keccak_top squeezes,
+ * which a block count from the acceptance rate does not see.
+ */
+static int gen_a_stats_of(gen_a_stats *st, const tlm_timing *t, int sec_lvl)
+{
+    uint8_t rho[SEEDBYTES];
+
+    for (unsigned i = 0; i < SEEDBYTES; i++)
+        rho[i] = i;
+    return gen_a_model(st, NULL, rho, sec_lvl, t->sampler_a, t->keccak_rounds);
+}
+
+unsigned tlm_poly_a(const tlm_timing *t)
+{
+    gen_a_stats st;
+
+    if (gen_a_stats_of(&st, t, 2))
+        return 0;
+    return (st.cycles + st.rounds - 1) / st.rounds;
+}
+
+// rejection_s: 4-bit candidates up to 2 * ETA out of 16
+unsigned tlm_poly_s(const tlm_timing *t, const hw_level *p)
+{
+    unsigned b = blocks_for(SHAKE256_RATE * 2 * ((2 * p->ETA + 1) / 16.0));
+
+    return keccak_absorb(t, CRHBYTES + 2, SHAKE256_RATE) + keccak_squeeze(t, b * SHAKE256_RATE / 8, SHAKE256_RATE);
+}
+
+// sampler_y_ext: no rejection, 18 or 20 bits per coefficient
+unsigned tlm_poly_y(const tlm_timing *t, const hw_level *p)
+{
+    unsigned bits = p->Z_LEN / p->L * 8 / DILITHIUM_N;
+    unsigned b = blocks_for(SHAKE256_RATE * 8.0 / bits);
+
+    return keccak_absorb(t, CRHBYTES + 2, SHAKE256_RATE) + keccak_squeeze(t, b * SHAKE256_RATE / 8, SHAKE256_RATE);
+}
+
+// gen_a_ext: K * L polynomials over sampler_a keccak_top
+unsigned tlm_gen_a(const tlm_timing *t, const hw_level *p)
+{
+    gen_a_stats st;
+
+    if (gen_a_stats_of(&st, t, p->sec_lvl))
+        return 0;
+    return st.cycles;
+}
+
+/*
+ * gen_c from the 32-byte c~: 8 bytes of signs, then one byte per cycle
+ * until TAU positions are accepted, then UNLOAD_C at 4 coefficients per
+ * cycle.
+ */
+unsigned tlm_sample_c(const tlm_timing *t, const hw_level *p)
+{
+    double bytes = 8;
+
+    for (unsigned i = DILITHIUM_N - p->TAU; i < DILITHIUM_N; i++)
+        bytes += (double)DILITHIUM_N / (i + 1);
+    return keccak_absorb(t, SEEDBYTES, SHAKE256_RATE) + keccak_squeeze(t, 1, SHAKE256_RATE) +
+           (unsigned)(bytes + 0.5) + BRAM_DEPT;
+}
+
+// FSM2_DECOMP streams w1 behind mu into H(mu || w1), then GEN_C samples c
+unsigned tlm_decomp_c(const tlm_timing *t, const hw_level *p)
+{
+    unsigned hash = MAX(keccak_absorb(t, CRHBYTES + p->W1_LEN, SHAKE256_RATE),
+                        p->K * BRAM_DEPT + 6 + keccak_perm(t) + 1);
+
+    return hash + keccak_squeeze(t, SEEDBYTES / 8, SHAKE256_RATE) + tlm_sample_c(t, p);
+}
+
+// n polynomials back to back on one operator
+static unsigned ops(const tlm_timing *t, unsigned n, unsigned latency)
+{
+    return n * (latency + t->op_issue);
+}
+
+/* ===================== state log ===================== */
+
+static void start(tlm_result *r, enum tlm_mode mode, const hw_level *p, unsigned attempts)
+{
+    memset(r, 0, sizeof(*r));
+    r->mode = mode;
+    r->sec_lvl = p->sec_lvl;
+    r->attempts = attempts;
+}
+
+// Add one visit of `name`, `cycles` long, and return them
+static unsigned state(tlm_result *r, const char *name, unsigned cycles)
+{
+    unsigned i;
+
+    for (i = 0; i < r->n; i++)
+    {
+        if (strcmp(r->state[i].name, name) == 0)
+            break;
+    }
+    if (i == r->n)
+    {
+        if (r->n == TLM_STATES_MAX)
+            return cycles;
+        r->state[r->n++].name = name;
+    }
+    r->state[i].visits++;
+    r->state[i].cycles += cycles;
+    return cycles;
+}
+
+// Cycles from now to a unit finishing at `done`
+static unsigned until(unsigned now, unsigned done)
+{
+    return done > now ? done - now : 0;
+}
+
+/* ===================== KG ===================== */
+
+int tlm_keygen(tlm_result *r, const tlm_timing *t, int sec_lvl)
+{
+    const hw_level *p = hw_get_level(sec_lvl);
+    unsigned now = 0, tr_done;
+
+    if (p == NULL)
+        return -1;
+    start(r, TLM_KEYGEN, p, 0);
+
+    // zeta in, rho || rho' || K out; rho goes to gen_a_ext
+    now += state(r, "KG_HASH_Z", keccak_absorb(t, SEEDBYTES, SHAKE256_RATE));
+    now += state(r, "KG_UNLOAD_HASH", keccak_squeeze(t, (2 * SEEDBYTES + CRHBYTES) / 8, SHAKE256_RATE));
+    r->a_done = now + tlm_gen_a(t, p);
+
+    // s1 to the encoder, then s2 while s1 is transformed on operator 0
+    now += state(r, "KG_SAMPLE_S1", MAX(p->L * tlm_poly_s(t, p), p->S1_LEN / 8));
+    now += state(r, "KG_SAMPLE_S2", MAX(MAX(p->K * tlm_poly_s(t, p), ops(t, p->L, t->ntt)), until(now, r->a_done)));
+
+    now += state(r, "KG_MULT_AS1", ops(t, p->K * p->L, t->mult));
+    now += state(r, "KG_NTTI_T", ops(t, p->K, t->intt));
+    now += state(r, "KG_ADD_T_S2", MAX(ops(t, p->K, t->add), p->T1_LEN / 8));
+
+    // tr = H(rho || t1) absorbs t1 while t0 goes out
+    tr_done = now + keccak_absorb(t, SEEDBYTES + p->T1_LEN, SHAKE256_RATE);
+    now += state(r, "KG_ENCODE_T0", p->T0_LEN / 8);
+    now += state(r, "KG_UNLOAD_TR", until(now, tr_done) + keccak_squeeze(t, SEEDBYTES / 8, SHAKE256_RATE));
+
+    r->total = now;
+    return 0;
+}
+
+/* ===================== VY ===================== */
+
+int tlm_verify(tlm_result *r, const tlm_timing *t, int sec_lvl, size_t mlen)
+{
+    const hw_level *p = hw_get_level(sec_lvl);
+    unsigned now = 0, c_done, tr_done, mu_done, ch_done;
+
+    if (p == NULL)
+        return -1;
+    start(r, TLM_VERIFY, p, 0);
+
+    now += state(r, "VY_LOAD_RHO", SEEDBYTES / 8);
+    r->a_done = now + tlm_gen_a(t, p);
+    now += state(r, "VY_LOAD_C", SEEDBYTES / 8);
+    c_done = now + tlm_sample_c(t, p);
+
+    now += state(r, "VY_DECODE_Z", MAX(p->Z_LEN / 8, p->L * BRAM_DEPT));
+
+    // t1 is decoded and absorbed into tr = H(rho || t1) under the NTTs of z
+    tr_done = now + keccak_absorb(t, SEEDBYTES + p->T1_LEN, SHAKE256_RATE);
+    now += state(r, "VY_NTT_Z", MAX(ops(t, p->L, t->ntt), p->T1_LEN / 8));
+
+    // tr goes back in with M for mu
+    mu_done = MAX(now, tr_done + keccak_squeeze(t, SEEDBYTES / 8, SHAKE256_RATE)) +
+              MAX(keccak_absorb(t, SEEDBYTES + mlen, SHAKE256_RATE), (unsigned)(mlen + 7) / 8);
+    now += state(r, "VY_NTT_T1", ops(t, p->K, t->ntt));
+    now += state(r, "VY_NTT_C", MAX(ops(t, 1, t->ntt), until(now, MAX(c_done, r->a_done))));
+
+    now += state(r, "VY_MULT_AZ", ops(t, p->K * p->L, t->mult));
+    now += state(r, "VY_MULT_CT1", ops(t, p->K, t->mult));
+    now += state(r, "VY_SUB_AZ_CT1", ops(t, p->K, t->add));
+    now += state(r, "VY_INTT", ops(t, p->K, t->intt));
+
+    // UseHint and the encoder feed w1 behind mu into H(mu || w1)
+    ch_done = MAX(now, mu_done + keccak_squeeze(t, CRHBYTES / 8, SHAKE256_RATE)) +
+              keccak_absorb(t, CRHBYTES + p->W1_LEN, SHAKE256_RATE);
+    now += state(r, "VY_GENW1", p->K * BRAM_DEPT);
+    now += state(r, "VY_HASH_CH", until(now, ch_done) + keccak_squeeze(t, SEEDBYTES / 8, SHAKE256_RATE));
+    now += state(r, "VY_COMPARE", 2);
+
+    r->total = now;
+    return 0;
+}
+
+/* ===================== sign: FSM0, FSM1, FSM2 ===================== */
+
+// One attempt of FSM1 on operator 0 from `now`, return when it sets cstart_fsm2
+static unsigned fsm1(tlm_result *r, const tlm_timing *t, const hw_level *p, unsigned now, int first)
+{
+    unsigned geny = p->L * tlm_poly_y(t, p);
+
+    // rho' = H(K || mu) before the first y
+    if (first)
+        geny += keccak_absorb(t, SEEDBYTES + CRHBYTES, SHAKE256_RATE) + keccak_squeeze(t, CRHBYTES / 8, SHAKE256_RATE);
+    now += state(r, "FSM1_GENY", geny);
+    now += state(r, "FSM1_WAIT", 1);
+    // A is not complete yet at level 3 and 5 on the first attempt
+    now += state(r, "FSM1_NTT_Y", MAX(ops(t, p->L, t->ntt), first && p->sec_lvl != 2 ? until(now, r->a_done) : 0));
+    now += state(r, "FSM1_MULT_A_Y", ops(t, p->K * p->L, t->mult));
+    now += state(r, "FSM1_NTTI_W", ops(t, p->K, t->intt));
+    return now;
+}
+
+int tlm_sign(tlm_result *r, const tlm_timing *t, int sec_lvl, size_t mlen, unsigned attempts)
+{
+    const hw_level *p = hw_get_level(sec_lvl);
+    unsigned now = 0, now2, fsm1_done;
+
+    if (p == NULL || attempts == 0)
+        return -1;
+    start(r, TLM_SIGN, p, attempts);
+
+    // FSM0: rho, then mu = H(tr || M) on the keccak_top of gen_y
+    now += state(r, "FSM0_LOAD_RHO", SEEDBYTES / 8);
+    r->a_done = now + tlm_gen_a(t, p);
+    now += state(r, "FSM0_LOAD_MU", MAX(keccak_absorb(t, SEEDBYTES + mlen, SHAKE256_RATE),
+                                        (unsigned)(mlen + 2 * SEEDBYTES + 7) / 8));
+    fsm1_done = fsm1(r, t, p, now, 1);
+
+    // Secrets are decoded from AXI and transformed on operator 1
+    now += state(r, "FSM0_DECODE_S1", MAX(p->S1_LEN / 8, p->L * BRAM_DEPT));
+    now += state(r, "FSM0_NTT_S1", MAX(ops(t, p->L, t->ntt), p->S2_LEN / 8));
+    now += state(r, "FSM0_NTT_S2", MAX(ops(t, p->K, t->ntt), p->T0_LEN / 8));
+    now += state(r, "FSM0_NTT_T0", ops(t, p->K, t->ntt));
+
+    // FSM2 on operator 1 once FSM0 has left it, FSM0 stalls until accept
+    now2 = now;
+    for (unsigned a = 1;; a++)
+    {
+        // w of this attempt is in BRAM 2. FSM1 starts the next attempt on done_c
+        now2 += until(now2, fsm1_done);
+        now2 += state(r, "FSM2_DECOMP", p->K * BRAM_DEPT + 6);
+        now2 += state(r, "FSM2_GEN_C", tlm_decomp_c(t, p) - (p->K * BRAM_DEPT + 6));
+        fsm1_done = fsm1(r, t, p, now2, 0);
+
+        now2 += state(r, "FSM2_NTT_C", ops(t, 1, t->ntt));
+        now2 += state(r, "FSM2_MULTACC", ops(t, p->L, t->mult));
+        now2 += state(r, "FSM2_MULT_CS2", ops(t, p->K, t->mult));
+        now2 += state(r, "FSM2_MULT_CT0", ops(t, p->K, t->mult));
+        now2 += state(r, "FSM2_NTTI_Z", ops(t, p->L, t->intt));
+        now2 += state(r, "FSM2_NTTI_CS2", ops(t, p->K, t->intt));
+        now2 += state(r, "FSM2_NTTI_CT0", ops(t, p->K, t->intt));
+        now2 += state(r, "FSM2_SUB_W0_CS2", ops(t, p->K, t->add));
+        // At level 5 the decision also waits for NTTI_W of the next attempt
+        now2 += state(r, "FSM2_MAKEHINT", MAX(ops(t, p->K, t->add),
+                                              p->sec_lvl == 5 ? until(now2, fsm1_done) : 0));
+        if (a == attempts)
+            break;
+    }
+    now += state(r, "FSM0_STALL", now2 - now);
+
+    // z, h and c~ out
+    now += state(r, "FSM0_UNLOAD_Z", p->L * BRAM_DEPT * 2 + 4);
+    now += state(r, "FSM0_UNLOAD_H", p->H_WORDS);
+    now += state(r, "FSM0_UNLOAD_C", SEEDBYTES / 8);
+
+    r->total = now;
+    return 0;
+}
+
+void tlm_print(FILE *f, const tlm_result *r)
+{
+    static const char *const modes[3] = {"keygen", "sign", "verify"};
+
+    fprintf(f, "Level %d %s", r->sec_lvl, modes[r->mode]);
+    if (r->mode == TLM_SIGN)
+        fprintf(f, ", %u attempt%s", r->attempts, r->attempts > 1 ? "s" : "");
+    fprintf(f, ": %llu cycles, done_a at %u\n", r->total, r->a_done);
+    for (unsigned i = 0; i < r->n; i++)
+    {
+        fprintf(f, "  %-16s %3u x %8llu %5.1f%%\n", r->state[i].name, r->state[i].visits,
+                r->state[i].cycles, 100.0 * r->state[i].cycles / r->total);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef COMBINED_TLM_H
+#define COMBINED_TLM_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "hw_levels.h"
+#include "op_timing.h"
+
+/*
+ * Transaction-level latency model of rtl_src/combined_top.v.
+ * Every FSM state is one transaction that lasts until the condition the
+ * RTL waits on holds: done_op of an operation_module, the last word of
+ * a keccak_top, the last word on the 64-bit AXI stream. Work that runs
+ * across states, such as gen_a_ext filling BRAM0, is kept as the cycle
+ * it finishes, the way the FSM waits on done_a.
+ * Sign runs FSM1 (operator 0) one attempt ahead of FSM2 (operator 1):
+ * FSM1 restarts when FSM2 has sampled c, as in FSM2_GEN_C.
+ */
+
+/*
+ * Cycles of the samplers, absorb included: one polynomial of A on one
+ * gen_a_ext sampler, of s1/s2 on gen_s, of y on expandmask_ext, all of
+ * A, and c from c~ on gen_c up to the end of UNLOAD_C. tlm_decomp_c is
+ * FSM2_DECOMP and FSM2_GEN_C together: w1 out of w, H(mu || w1), then c.
+ * A is run on the cycle model of gen_a_model.h; tlm_poly_a and tlm_gen_a
+ * return 0 for more samplers or rounds than it takes.
+ */
+unsigned tlm_poly_a(const tlm_timing *t);
+unsigned tlm_poly_s(const tlm_timing *t, const hw_level *p);
+unsigned tlm_poly_y(const tlm_timing *t, const hw_level *p);
+unsigned tlm_gen_a(const tlm_timing *t, const hw_level *p);
+unsigned tlm_sample_c(const tlm_timing *t, const hw_level *p);
+unsigned tlm_decomp_c(const tlm_timing *t, const hw_level *p);
+
+enum tlm_mode
+{
+    TLM_KEYGEN,
+    TLM_SIGN,
+    TLM_VERIFY
+};
+
+#define TLM_STATES_MAX 32
+
+typedef struct
+{
+    const char *name;       // state of combined_top.v
+    unsigned visits;        // per attempt for FSM1/FSM2, FSM1 once more after the last
+    unsigned long long cycles;
+} tlm_state;
+
+typedef struct
+{
+    enum tlm_mode mode;
+    int sec_lvl;
+    unsigned attempts;
+    unsigned long long total; // start to the last output word
+    unsigned a_done;          // cycle gen_a_ext raises done_a
+    unsigned n;
+    tlm_state state[TLM_STATES_MAX];
+} tlm_result;
+
+/*
+ * Model one operation at sec_lvl 2, 3 or 5 for a mlen-byte message.
+ * Sign takes `attempts` rounds of the rejection loop, the last accepted.
+ * Return 0, -1 for an unknown level.
+ */
+int tlm_keygen(tlm_result *r, const tlm_timing *t, int sec_lvl);
+int tlm_sign(tlm_result *r, const tlm_timing *t, int sec_lvl, size_t mlen, unsigned attempts);
+int tlm_verify(tlm_result *r, const tlm_timing *t, int sec_lvl, size_t mlen);
+
+void tlm_print(FILE *f, const tlm_result *r);
+
+#endif
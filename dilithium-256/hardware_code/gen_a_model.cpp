@@ -0,0 +1,379 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <string.h>
+#include "gen_a_model.h"
+#include "hw_levels.h"
+
+// LOAD_MODE: SHAKE128, 0xF0000 bits of output, 34-byte message
+#define GEN_A_HEADER 0xC00f000000000110ull
+
+/* ============================ rejection_a ============================ */
+
+static int rej_ready(const rejection_a *r)
+{
+    return r->in_len < 9;
+}
+
+static int rej_valid(const rejection_a *r)
+{
+    return r->out_len >= 4;
+}
+
+static uint32_t lane(const rejection_a *r, unsigned i)
+{
+    const uint8_t *p = r->in + 3 * i;
+
+    return (p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16)) & 0x7FFFFF;
+}
+
+/*
+ * One clock of rejection_a: up to three 24-bit candidates of SIPO_IN
+ * checked, a word of keccak_top appended, four samples out.
+ * Lanes are packed as in the casex of the RTL, where lane 2 alone
+ * passes on as lane 0, which is zero by then.
+ */
+static unsigned rej_clock(rejection_a *r, int rst, int valid_i, uint64_t rdi, int ready_o)
+{
+    uint32_t l[3], in[3] = {0, 0, 0};
+    unsigned shift, pos, rejected, num_valid = 0, v = 0;
+    int valid_o = rej_valid(r);
+
+    if (rst)
+    {
+        memset(r, 0, sizeof(*r));
+        return 0;
+    }
+
+    for (unsigned i = 0; i < 3; i++)
+    {
+        l[i] = lane(r, i);
+        if (l[i] < DILITHIUM_Q && r->in_len >= 3 * (i + 1))
+        {
+            v |= 1 << i;
+            num_valid++;
+        }
+        else
+            l[i] = 0;
+    }
+    switch (v)
+    {
+    case 3:
+    case 7:
+        in[0] = l[0], in[1] = l[1], in[2] = l[2];
+        break;
+    case 1:
+    case 5:
+        in[0] = l[0], in[1] = l[2];
+        break;
+    case 2:
+    case 6:
+        in[0] = l[1], in[1] = l[2];
+        break;
+    case 4:
+        in[0] = l[0];
+        break;
+    }
+    shift = r->in_len >= 9 ? 9 : r->in_len >= 6 ? 6 : 0;
+    rejected = shift / 3 - num_valid;
+
+    // SIPO_IN
+    memmove(r->in, r->in + shift, sizeof(r->in) - shift);
+    memset(r->in + sizeof(r->in) - shift, 0, shift);
+    r->in_len -= shift;
+    if (valid_i)
+    {
+        for (unsigned i = 0; i < 8 && r->in_len + i < sizeof(r->in); i++)
+            r->in[r->in_len + i] = (uint8_t)(rdi >> (56 - 8 * i));
+        r->in_len += 8;
+    }
+
+    // SIPO_OUT, shifted when valid_o even if the length stays
+    if (valid_o)
+    {
+        memmove(r->out, r->out + 4, 2 * sizeof(r->out[0]));
+        r->out[2] = r->out[3] = r->out[4] = r->out[5] = 0;
+        if (ready_o)
+            r->out_len -= 4;
+    }
+    pos = r->out_len;
+    for (unsigned i = 0; i < 3 && pos + i < 6; i++)
+        r->out[pos + i] |= in[i];
+    r->out_len += num_valid;
+    return rejected;
+}
+
+/* =========================== sampler_a_ext =========================== */
+
+typedef struct
+{
+    enum sampler_a_state next;
+    int rst_k, rst_a, done, ready_i, valid_o, ready_o_a;
+    keccak_in kin;
+    keccak_out kout;
+} sampler_ctl;
+
+static uint64_t load_be(const uint8_t *p)
+{
+    uint64_t w = 0;
+
+    for (int i = 0; i < 8; i++)
+        w = (w << 8) | p[i];
+    return w;
+}
+
+static void sampler_eval(const sampler_a *s, sampler_ctl *c, int start, int re_sample, int valid_i,
+                         int ready_o, unsigned i, unsigned j)
+{
+    memset(c, 0, sizeof(*c));
+    c->next = s->state;
+
+    switch (s->state)
+    {
+    case SAMPLER_INIT:
+        c->rst_k = c->rst_a = !(start || re_sample);
+        if (start || re_sample)
+            c->next = SAMPLER_LOAD_MODE;
+        break;
+    case SAMPLER_LOAD_MODE:
+        c->kin.din = GEN_A_HEADER;
+        break;
+    case SAMPLER_WAITING_FOR_SEED:
+        c->ready_i = 1;
+        if ((s->sipo_status & 4) && valid_i)
+            c->next = SAMPLER_LOADING_SEED;
+        break;
+    case SAMPLER_LOADING_SEED:
+        c->kin.din = s->seed[0];
+        break;
+    case SAMPLER_LOADING_NONCE:
+        c->kin.din = ((uint64_t)(j & 15) << 56) | ((uint64_t)(i & 15) << 48);
+        break;
+    case SAMPLER_SAMPLING:
+        c->ready_o_a = ready_o;
+        c->valid_o = rej_valid(&s->rej);
+        break;
+    }
+
+    c->kin.src_valid = !s->src_ready;
+    c->kin.dst_ready = rej_ready(&s->rej);
+    keccak_core_eval(&s->keccak, &c->kin, &c->kout);
+
+    if (s->state == SAMPLER_LOAD_MODE && c->kout.src_read)
+        c->next = s->resample_reg ? SAMPLER_LOADING_SEED : SAMPLER_WAITING_FOR_SEED;
+    else if (s->state == SAMPLER_LOADING_SEED && s->sipo_status == 1 && c->kout.src_read)
+        c->next = SAMPLER_LOADING_NONCE;
+    else if (s->state == SAMPLER_LOADING_NONCE && c->kout.src_read)
+        c->next = SAMPLER_SAMPLING;
+    else if (s->state == SAMPLER_SAMPLING && s->sample_ctr == 252 && ready_o && c->valid_o)
+    {
+        c->next = SAMPLER_INIT;
+        c->rst_k = 1;
+        c->done = 1;
+    }
+    c->kin.rst = c->rst_k;
+}
+
+static unsigned sampler_clock(sampler_a *s, const sampler_ctl *c, int re_sample, int valid_i,
+                              uint64_t seed_i)
+{
+    int src_read = c->kout.src_read;
+    uint64_t top;
+    unsigned rejected;
+
+    keccak_core_clock(&s->keccak, &c->kin);
+    rejected = rej_clock(&s->rej, c->rst_a, c->kout.dst_write, c->kout.dout, c->ready_o_a);
+
+    s->src_ready = 1;
+    switch (s->state)
+    {
+    case SAMPLER_INIT:
+        s->sipo_status = 0;
+        s->sample_ctr = 0;
+        s->resample_reg = re_sample;
+        break;
+    case SAMPLER_LOAD_MODE:
+        s->src_ready = 0;
+        if (src_read && s->resample_reg)
+        {
+            s->sipo_status = 15;
+            s->resample_reg = 0;
+        }
+        break;
+    case SAMPLER_WAITING_FOR_SEED:
+        if (valid_i && c->ready_i)
+        {
+            s->sipo_status = ((s->sipo_status << 1) | 1) & 15;
+            memmove(s->seed, s->seed + 1, 3 * sizeof(s->seed[0]));
+            s->seed[3] = seed_i;
+        }
+        break;
+    case SAMPLER_LOADING_SEED:
+        s->src_ready = 0;
+        if (src_read)
+        {
+            s->src_ready = 1;
+            s->sipo_status >>= 1;
+            top = s->seed[0];
+            memmove(s->seed, s->seed + 1, 3 * sizeof(s->seed[0]));
+            s->seed[3] = top;
+        }
+        break;
+    case SAMPLER_LOADING_NONCE:
+        s->src_ready = 0;
+        break;
+    case SAMPLER_SAMPLING:
+        if (c->ready_o_a && c->valid_o)
+            s->sample_ctr += 4;
+        break;
+    }
+    s->state = c->next;
+    return rejected;
+}
+
+/* ============================= gen_a_ext ============================= */
+
+int gen_a_ext_init(gen_a_ext *g, const uint8_t rho[32], int sec_lvl, unsigned samplers, unsigned rounds)
+{
+    const hw_level *p = hw_get_level(sec_lvl);
+
+    if (p == NULL || samplers == 0 || samplers > GEN_A_SAMPLERS_MAX || rounds == 0 ||
+        rounds > KECCAK_CORE_ROUNDS)
+        return -1;
+
+    memset(g, 0, sizeof(*g));
+    g->K = p->K;
+    g->L = p->L;
+    g->samplers = samplers;
+    g->polys = p->K * p->L;
+    g->last = (g->polys + samplers - 1) / samplers * samplers - samplers;
+    g->st.polys = g->polys;
+    memcpy(g->rho, rho, sizeof(g->rho));
+    for (unsigned i = 0; i < samplers; i++)
+    {
+        g->s[i].src_ready = 1;
+        keccak_core_init(&g->s[i].keccak, rounds);
+    }
+    return 0;
+}
+
+void gen_a_ext_eval(const gen_a_ext *g, gen_a_out *out)
+{
+    memset(out, 0, sizeof(*out));
+    for (unsigned i = 0; i < g->samplers; i++)
+    {
+        const sampler_a *s = &g->s[i];
+
+        out->poly[i] = g->sample_state + i;
+        out->coeff[i] = s->sample_ctr;
+        if (s->state == SAMPLER_SAMPLING && rej_valid(&s->rej))
+        {
+            out->valid |= 1 << i;
+            memcpy(out->samples[i], s->rej.out, sizeof(out->samples[i]));
+        }
+    }
+}
+
+void gen_a_ext_clock(gen_a_ext *g, unsigned ready_o)
+{
+    sampler_ctl c[GEN_A_SAMPLERS_MAX];
+    const unsigned all = (1u << g->samplers) - 1;
+    const int valid_seed = g->fed < 4;
+    const uint64_t seed_i = valid_seed ? load_be(g->rho + 8 * g->fed) : 0;
+    int ready_for_seed = 1;
+    unsigned poly;
+
+    if (g->done_sampler)
+        return;
+
+    for (unsigned i = 0; i < g->samplers; i++)
+    {
+        poly = g->sample_state + i;
+        sampler_eval(&g->s[i], &c[i], g->st.cycles == 0, g->re_sample, valid_seed, (ready_o >> i) & 1,
+                     poly / g->L, poly % g->L);
+        ready_for_seed &= c[i].ready_i;
+    }
+    for (unsigned i = 0; i < g->samplers; i++)
+    {
+        g->st.round_wait += (g->done_latch >> i) & 1;
+        g->st.rejected += sampler_clock(&g->s[i], &c[i], g->re_sample, valid_seed, seed_i);
+    }
+    if (valid_seed && ready_for_seed)
+        g->fed++;
+
+    // Lockstep rounds, registered as in the always block of gen_a_ext.v
+    g->re_sample = 0;
+    if (g->done_latch == all)
+    {
+        g->done_latch = 0;
+        g->st.rounds++;
+        if (g->sample_state == g->last)
+            g->done_sampler = 1;
+        else
+        {
+            g->re_sample = 1;
+            g->sample_state += g->samplers;
+        }
+    }
+    else
+    {
+        for (unsigned i = 0; i < g->samplers; i++)
+            g->done_latch |= c[i].done << i;
+    }
+    g->st.cycles++;
+
+    if (g->done_sampler)
+    {
+        for (unsigned i = 0; i < g->samplers; i++)
+        {
+            g->st.permuting += g->s[i].keccak.permuting;
+            g->st.output_wait += g->s[i].keccak.output_wait;
+        }
+    }
+}
+
+int gen_a_model(gen_a_stats *st, int32_t (*a)[DILITHIUM_N], const uint8_t rho[32],
+                int sec_lvl, unsigned samplers, unsigned rounds)
+{
+    static gen_a_ext g;
+    gen_a_out out;
+
+    if (gen_a_ext_init(&g, rho, sec_lvl, samplers, rounds))
+        return -1;
+
+    while (!g.done_sampler)
+    {
+        gen_a_ext_eval(&g, &out);
+        for (unsigned i = 0; i < samplers && a != NULL; i++)
+        {
+            if (((out.valid >> i) & 1) && out.poly[i] < g.polys)
+            {
+                for (unsigned t = 0; t < 4; t++)
+                    a[out.poly[i]][out.coeff[i] + t] = (int32_t)out.samples[i][t];
+            }
+        }
+        gen_a_ext_clock(&g, (1u << samplers) - 1);
+    }
+    *st = g.st;
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef GEN_A_MODEL_H
+#define GEN_A_MODEL_H
+
+#include <stdint.h>
+#include "config.h"
+#include "keccak_core.h"
+
+/*
+ * Cycle-accurate model of rtl_src/gen_a_ext.v: `samplers` sampler_a_ext
+ * units, each with its rejection_a and its own keccak_top, sampling A
+ * from rho in lockstep rounds. A round starts when every sampler of the
+ * previous one is done, sampler g takes polynomial sample_state + g in
+ * row-major order, as the case tables of gen_a_ext.v do for two.
+ * The last round may hold fewer polynomials than samplers; the spare
+ * samplers still run and their output is dropped.
+ * Seed words are given on every cycle gen_a_ext is ready for them;
+ * combined_top takes samples on every cycle (ready_o = 1).
+ */
+
+#define GEN_A_SAMPLERS_MAX 8
+
+// rejection_a.v, SIPO_IN in bytes, SIPO_OUT in coefficients
+typedef struct
+{
+    uint8_t in[10];
+    unsigned in_len;
+    uint32_t out[6];
+    unsigned out_len;
+} rejection_a;
+
+enum sampler_a_state
+{
+    SAMPLER_INIT,
+    SAMPLER_LOAD_MODE,
+    SAMPLER_WAITING_FOR_SEED,
+    SAMPLER_LOADING_SEED,
+    SAMPLER_LOADING_NONCE,
+    SAMPLER_SAMPLING
+};
+
+// sampler_a_ext.v
+typedef struct
+{
+    enum sampler_a_state state;
+    uint64_t seed[4]; // SEED_SIPO, seed[0] = bits 255:192
+    unsigned sipo_status;
+    int resample_reg;
+    unsigned sample_ctr;
+    int src_ready; // registered, 1 = no word for keccak_top
+    rejection_a rej;
+    keccak_core keccak;
+} sampler_a;
+
+typedef struct
+{
+    unsigned long long cycles;      // start to done_sampler
+    unsigned rounds;                // lockstep rounds
+    unsigned polys;                 // K * L
+    unsigned long long permuting;   // keccak_fsm2 busy, summed over the samplers
+    unsigned long long output_wait; // shake_output_wait, rejection_a not draining
+    unsigned long long round_wait;  // done, waiting for the other samplers
+    unsigned long long rejected;    // candidates >= Q
+} gen_a_stats;
+
+// gen_a_ext.v
+typedef struct
+{
+    unsigned K, L, samplers, polys, last;
+    unsigned sample_state, done_latch, fed;
+    int re_sample, done_sampler;
+    uint8_t rho[32];
+    sampler_a s[GEN_A_SAMPLERS_MAX];
+    gen_a_stats st;
+} gen_a_ext;
+
+// Samples on offer this cycle, sampler g has them if bit g of valid is set
+typedef struct
+{
+    unsigned valid;
+    unsigned poly[GEN_A_SAMPLERS_MAX];  // k * L + l, K * L and up for the spare samplers
+    unsigned coeff[GEN_A_SAMPLERS_MAX]; // index of samples[g][0] in the polynomial
+    uint32_t samples[GEN_A_SAMPLERS_MAX][4];
+} gen_a_out;
+
+/*
+ * gen_a_ext with `samplers` units and `rounds` Keccak rounds per cycle
+ * at sec_lvl 2, 3 or 5, started on rho. Return -1 for a level or
+ * sampler count the model does not take.
+ */
+int gen_a_ext_init(gen_a_ext *g, const uint8_t rho[32], int sec_lvl, unsigned samplers, unsigned rounds);
+
+void gen_a_ext_eval(const gen_a_ext *g, gen_a_out *out);
+
+// One clock, sampler g takes its samples if bit g of ready_o is set
+void gen_a_ext_clock(gen_a_ext *g, unsigned ready_o);
+
+/*
+ * All of A for rho, samples taken on every cycle. Polynomial (k, l)
+ * lands in a[k * L + l] unless a is NULL.
+ */
+int gen_a_model(gen_a_stats *st, int32_t (*a)[DILITHIUM_N], const uint8_t rho[32],
+                int sec_lvl, unsigned samplers, unsigned rounds);
+
+#endif
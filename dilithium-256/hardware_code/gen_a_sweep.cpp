@@ -0,0 +1,97 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hw_levels.h"
+#include "op_timing.h"
+#include "gen_a_model.h"
+
+/*
+ * Cycles for gen_a_ext to sample all of A at each level, from the cycle
+ * model of gen_a_model.h, over the number of samplers and the Keccak
+ * rounds per cycle. Next to it is what one operation_module takes to
+ * consume A, one MULT per polynomial (the NTT of the vector A multiplies
+ * runs before); A/MULT above 1 means the operator waits on the samplers.
+ * keccak is how busy the permutation is, out how long it waits on
+ * rejection_a to drain a block, round how long a done sampler waits on
+ * the others. combined_top has 2 samplers and 1 round per cycle.
+ * Usage: gen_a_sweep [--level n] [--max-samplers n]
+ */
+
+int main(int argc, char **argv)
+{
+    const int levels[3] = {2, 3, 5};
+    const unsigned rounds[5] = {1, 2, 3, 4, 6};
+    unsigned max_samplers = 4, consume;
+    int level = 0;
+    uint8_t rho[32];
+    tlm_timing t;
+    gen_a_stats st;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+            level = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-samplers") == 0 && i + 1 < argc)
+            max_samplers = atoi(argv[++i]);
+        else
+            level = -1;
+    }
+    if (max_samplers == 0 || max_samplers > GEN_A_SAMPLERS_MAX || (level && hw_get_level(level) == NULL))
+    {
+        printf("Usage: %s [--level n] [--max-samplers n<=%d]\n", argv[0], GEN_A_SAMPLERS_MAX);
+        return 1;
+    }
+
+    tlm_timing_default(&t);
+    for (unsigned i = 0; i < sizeof(rho); i++)
+        rho[i] = i;
+
+    for (int l = 0; l < 3; l++)
+    {
+        const hw_level *p = hw_get_level(levels[l]);
+
+        if (level && level != levels[l])
+            continue;
+        consume = p->K * p->L * (t.mult + t.op_issue);
+        printf("Level %d: A is %u x %u, MULT %u + %u cycles per polynomial, %u for all of A\n",
+               levels[l], p->K, p->L, t.mult, t.op_issue, consume);
+        printf("  samplers  rounds  cycles  /poly  /round  keccak    out  round  A/MULT\n");
+        for (unsigned n = 1; n <= max_samplers; n++)
+        {
+            for (unsigned r = 0; r < sizeof(rounds) / sizeof(rounds[0]); r++)
+            {
+                gen_a_model(&st, NULL, rho, levels[l], n, rounds[r]);
+                printf("  %8u  %6u  %6llu  %5.0f  %6.0f  %5.1f%%  %4.1f%%  %4.1f%%  %6.2f%s\n", n, rounds[r],
+                       st.cycles, (double)st.cycles / st.polys, (double)st.cycles / st.rounds,
+                       100.0 * st.permuting / (st.cycles * n), 100.0 * st.output_wait / (st.cycles * n),
+                       100.0 * st.round_wait / (st.cycles * n), (double)st.cycles / consume,
+                       n == 2 && rounds[r] == 1 ? "  combined_top" : "");
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../params.h"
+#include "../software_code/fips202.h"
+#include "hw_levels.h"
+#include "gen_a_model.h"
+
+/*
+ * The cycle model of gen_a_ext against SHAKE128 and rejection sampling
+ * in software, for every level, one to three samplers and one to three
+ * Keccak rounds per cycle. Seeds come from a fixed srand so the rare
+ * case rejection_a gets wrong (only the third of three candidates
+ * passes) does not make the test flaky.
+ */
+
+#define TESTS 4
+
+static void ref_poly_uniform(int32_t a[DILITHIUM_N], const uint8_t rho[32], unsigned k, unsigned l)
+{
+    uint8_t in[34], buf[5 * 168];
+    unsigned ctr = 0, pos = 0;
+    uint32_t t;
+
+    memcpy(in, rho, 32);
+    in[32] = l;
+    in[33] = k;
+    shake128(buf, sizeof(buf), in, sizeof(in));
+    while (ctr < DILITHIUM_N && pos + 3 <= sizeof(buf))
+    {
+        t = (buf[pos] | (buf[pos + 1] << 8) | ((uint32_t)buf[pos + 2] << 16)) & 0x7FFFFF;
+        pos += 3;
+        if (t < DILITHIUM_Q)
+            a[ctr++] = t;
+    }
+}
+
+static int check(int sec_lvl, unsigned samplers, unsigned rounds, const uint8_t rho[32])
+{
+    const hw_level *p = hw_get_level(sec_lvl);
+    static int32_t a[8 * 7][DILITHIUM_N], gold[DILITHIUM_N];
+    gen_a_stats st;
+
+    memset(a, 0xFF, sizeof(a));
+    if (gen_a_model(&st, a, rho, sec_lvl, samplers, rounds))
+    {
+        printf("gen_a_model: level %d, %u samplers, %u rounds rejected\n", sec_lvl, samplers, rounds);
+        return 1;
+    }
+    for (unsigned k = 0; k < p->K; k++)
+    {
+        for (unsigned l = 0; l < p->L; l++)
+        {
+            ref_poly_uniform(gold, rho, k, l);
+            if (memcmp(gold, a[k * p->L + l], sizeof(gold)))
+            {
+                printf("gen_a_model: level %d, %u samplers, %u rounds: A[%u][%u] wrong\n",
+                       sec_lvl, samplers, rounds, k, l);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Cycle counts for rho = 0, 1, ..., 31, taken from the model of ff82d4e
+ * before it was split into init/eval/clock steps. The steps are clocked
+ * in the same order, so every count must stay the same.
+ */
+static const struct
+{
+    int sec_lvl;
+    unsigned samplers, rounds;
+    unsigned long long cycles;
+    unsigned rounds_run;
+    unsigned long long permuting, output_wait, round_wait, rejected;
+} golden[] = {
+    {2, 1, 1, 3622, 16, 2258, 768, 16, 1},
+    {2, 1, 2, 3430, 16, 1152, 1682, 16, 1},
+    {2, 1, 3, 3366, 16, 768, 2002, 16, 1},
+    {2, 2, 1, 1814, 8, 2258, 768, 18, 1},
+    {2, 2, 2, 1718, 8, 1152, 1682, 18, 1},
+    {2, 2, 3, 1686, 8, 768, 2002, 18, 1},
+    {2, 3, 1, 1364, 6, 2544, 864, 24, 3},
+    {2, 3, 2, 1292, 6, 1296, 1896, 24, 3},
+    {2, 3, 3, 1268, 6, 864, 2256, 24, 3},
+    {3, 1, 1, 6798, 30, 4244, 1440, 30, 7},
+    {3, 1, 2, 6438, 30, 2160, 3164, 30, 7},
+    {3, 1, 3, 6318, 30, 1440, 3764, 30, 7},
+    {3, 2, 1, 3406, 15, 4244, 1440, 40, 7},
+    {3, 2, 2, 3226, 15, 2160, 3164, 40, 7},
+    {3, 2, 3, 3166, 15, 1440, 3764, 40, 7},
+    {3, 3, 1, 2274, 10, 4244, 1440, 46, 7},
+    {3, 3, 2, 2154, 10, 2160, 3164, 46, 7},
+    {3, 3, 3, 2114, 10, 1440, 3764, 46, 7},
+    {5, 1, 1, 12686, 56, 7922, 2688, 56, 18},
+    {5, 1, 2, 12014, 56, 4032, 5906, 56, 18},
+    {5, 1, 3, 11790, 56, 2688, 7026, 56, 18},
+    {5, 2, 1, 6356, 28, 7922, 2688, 78, 18},
+    {5, 2, 2, 6020, 28, 4032, 5906, 78, 18},
+    {5, 2, 3, 5908, 28, 2688, 7026, 78, 18},
+    {5, 3, 1, 4322, 19, 8063, 2736, 103, 18},
+    {5, 3, 2, 4094, 19, 4104, 6011, 103, 18},
+    {5, 3, 3, 4018, 19, 2736, 7151, 103, 18},
+};
+
+static int check_golden()
+{
+    uint8_t rho[32];
+    gen_a_stats st;
+
+    for (unsigned i = 0; i < sizeof(rho); i++)
+        rho[i] = i;
+    for (unsigned i = 0; i < sizeof(golden) / sizeof(golden[0]); i++)
+    {
+        gen_a_model(&st, NULL, rho, golden[i].sec_lvl, golden[i].samplers, golden[i].rounds);
+        if (st.cycles != golden[i].cycles || st.rounds != golden[i].rounds_run ||
+            st.permuting != golden[i].permuting || st.output_wait != golden[i].output_wait ||
+            st.round_wait != golden[i].round_wait || st.rejected != golden[i].rejected)
+        {
+            printf("gen_a_model: level %d, %u samplers, %u rounds: %llu cycles, expected %llu\n",
+                   golden[i].sec_lvl, golden[i].samplers, golden[i].rounds, st.cycles, golden[i].cycles);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    const int levels[3] = {2, 3, 5};
+    uint8_t rho[32];
+    int ret = 0;
+
+    ret |= check_golden();
+    srand(1);
+    for (int t = 0; t < TESTS; t++)
+    {
+        for (unsigned i = 0; i < sizeof(rho); i++)
+            rho[i] = rand();
+
+        for (int l = 0; l < 3; l++)
+        {
+            for (unsigned samplers = 1; samplers <= 3; samplers++)
+            {
+                for (unsigned rounds = 1; rounds <= 3; rounds++)
+                    ret |= check(levels[l], samplers, rounds, rho);
+            }
+        }
+        if (ret)
+            break;
+    }
+    printf(ret ? "ERROR\n" : "OK\n");
+    return ret;
+}
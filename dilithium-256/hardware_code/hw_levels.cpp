@@ -0,0 +1,41 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stddef.h>
+#include "hw_levels.h"
+
+static const hw_level levels[3] = {
+    {2, 4, 4, 2, 39, 4 * 416, 4 * 320, 4 * 96, 4 * 96, 4 * 576, 4 * 192, 11, 4.25},
+    {3, 6, 5, 4, 49, 6 * 416, 6 * 320, 5 * 128, 6 * 128, 5 * 640, 6 * 128, 8, 5.1},
+    {5, 8, 7, 2, 60, 8 * 416, 8 * 320, 7 * 96, 8 * 96, 7 * 640, 8 * 128, 11, 3.85},
+};
+
+const hw_level *hw_get_level(int sec_lvl)
+{
+    for (unsigned i = 0; i < 3; i++)
+    {
+        if (levels[i].sec_lvl == sec_lvl)
+            return &levels[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,43 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef HW_LEVELS_H
+#define HW_LEVELS_H
+
+/*
+ * Level constants of combined_top.v, lengths in bytes. Shared by the
+ * latency model, the scheduler, gen_a_model and the pipeline.
+ */
+typedef struct
+{
+    int sec_lvl;
+    unsigned K, L, ETA, TAU;
+    unsigned T0_LEN, T1_LEN, S1_LEN, S2_LEN, Z_LEN, W1_LEN;
+    unsigned H_WORDS; // FSM0_UNLOAD_H
+    double attempts;  // expected per signature, round 3 specification
+} hw_level;
+
+// NULL for a level other than 2, 3 or 5
+const hw_level *hw_get_level(int sec_lvl);
+
+#endif
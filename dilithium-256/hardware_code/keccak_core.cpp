@@ -0,0 +1,418 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <string.h>
+#include "keccak_core.h"
+#include "../software_code/fips202.h"
+
+// Rates in bits, keccak_pkg.vhd calls them capacities
+#define SHAKE128_BITS 1344
+#define SHAKE256_BITS 1088
+
+// Combinational signals of one cycle
+typedef struct
+{
+    // keccak_fsm1
+    enum keccak_fsm1_state fsm1;
+    int src_read, ej, lj, zjfin;
+    int block_ready_set, msg_end_set, set_full_block, clr_full_block;
+    int set_start_pad, clr_start_pad, en_len, en_ctr, clr_len, ef, lf;
+    int load_next_block;
+
+    // keccak_fsm2
+    enum keccak_fsm2_state fsm2;
+    uint32_t cnt_output_size;
+    unsigned output_size, mode_r;
+    int hashing_started, zi, li, ei;
+    int block_ready_clr, msg_end_clr, output_data_s, sel_xor_set, sel_xor_clr;
+    int take_block, squeeze; // permute a new block, permute for the next output block
+
+    // sha3_fsm3
+    enum sha3_fsm3_state fsm3;
+    int dst_write, output_write_clr, output_busy_clr, ek, lk;
+} keccak_ctl;
+
+// SR flip-flop of sr_reg.vhd, set wins
+static int sr(int q, int set, int clr)
+{
+    return set || (!clr && q);
+}
+
+static unsigned rate_bits(unsigned mode)
+{
+    return mode == 2 ? SHAKE128_BITS : SHAKE256_BITS;
+}
+
+static void control(const keccak_core *k, const keccak_in *in, keccak_ctl *s)
+{
+    const unsigned mw = rate_bits(k->mode);
+    const unsigned b = k->mode_r == 3 ? SHAKE256_BITS : SHAKE128_BITS;
+    const unsigned hseg = (k->output_size + 63) / 64;
+    const int avail = in->src_valid, zc0 = k->c == 0, zc_more_than_block = k->c >= mw;
+    const int comp_lb_e0 = (k->c & 0x7C0) == 0;
+    const int final_segment = (int)(in->din >> 63);
+    const int lb = k->fsm1 == FSM1_LOAD_BLOCK;
+    const int busy = k->output_busy, br = k->block_ready, me = k->msg_end;
+    int zkfin;
+
+    memset(s, 0, sizeof(*s));
+
+    /* keccak_fsm1 */
+    s->zjfin = k->wc == mw / 64 - 1;
+    s->block_ready_clr = (k->fsm2 == FSM2_PROCESS_BLOCK || k->fsm2 == FSM2_PROCESS_LAST_BLOCK) &&
+                         k->pc == (k->roundnr > 4 ? 4 : k->roundnr - 1);
+    s->load_next_block = !br || s->block_ready_clr;
+
+    s->fsm1 = k->fsm1;
+    switch (k->fsm1)
+    {
+    case FSM1_RESET:
+        s->fsm1 = FSM1_WAIT_FOR_HEADER1;
+        break;
+    case FSM1_WAIT_FOR_HEADER1:
+        if (avail)
+            s->fsm1 = FSM1_WAIT_FOR_LOAD1;
+        break;
+    case FSM1_WAIT_FOR_LOAD1:
+        if (s->load_next_block)
+            s->fsm1 = FSM1_LOAD_BLOCK;
+        break;
+    case FSM1_LOAD_BLOCK:
+        if ((!avail && (!k->f || !zc0 || k->full_block)) || !s->zjfin)
+            s->fsm1 = FSM1_LOAD_BLOCK;
+        else if (!k->full_block && k->f)
+            s->fsm1 = FSM1_WAIT_FOR_LOAD2;
+        else if (avail && !k->f && zc0)
+            s->fsm1 = FSM1_WAIT_FOR_HEADER1;
+        else
+            s->fsm1 = FSM1_WAIT_FOR_LOAD1;
+        break;
+    case FSM1_WAIT_FOR_LOAD2:
+        if (s->load_next_block)
+            s->fsm1 = FSM1_WAIT_FOR_HEADER1;
+        break;
+    }
+
+    s->src_read = (k->fsm1 == FSM1_WAIT_FOR_HEADER1 && avail) || (lb && avail && (!zc0 || k->full_block));
+    s->ej = lb && ((avail && (!zc0 || !k->f || k->full_block)) || (zc0 && k->f && !k->full_block));
+    s->block_ready_set = s->ej && s->zjfin;
+    s->msg_end_set = lb && s->zjfin && !k->full_block && k->f;
+    s->lf = k->fsm1 == FSM1_RESET || (k->fsm1 == FSM1_WAIT_FOR_LOAD2 && s->load_next_block);
+    s->ef = k->fsm1 == FSM1_WAIT_FOR_HEADER1 && final_segment;
+    s->en_len = k->fsm1 == FSM1_WAIT_FOR_HEADER1 && avail;
+    s->en_ctr = (k->fsm1 == FSM1_WAIT_FOR_LOAD1 && s->load_next_block && zc_more_than_block) ||
+                (lb && !k->full_block && avail && !zc0);
+    s->lj = k->fsm1 == FSM1_RESET || k->fsm1 == FSM1_WAIT_FOR_LOAD1 || k->fsm1 == FSM1_WAIT_FOR_LOAD2;
+    s->set_full_block = k->fsm1 == FSM1_WAIT_FOR_LOAD1 && zc_more_than_block;
+    s->clr_full_block = lb && s->zjfin && s->ej;
+    s->set_start_pad = s->ef;
+    s->clr_start_pad = lb && !k->full_block && k->f && comp_lb_e0 && k->start_pad && s->ej;
+    s->clr_len = lb && !k->full_block && k->f && comp_lb_e0 && avail && s->ej;
+
+    /* keccak_fsm2 */
+    s->zi = k->pc == k->roundnr - 1;
+    s->fsm2 = k->fsm2;
+    s->cnt_output_size = k->cnt_output_size;
+    s->output_size = k->output_size;
+    s->mode_r = k->mode_r;
+    s->hashing_started = k->hashing_started;
+
+    switch (k->fsm2)
+    {
+    case FSM2_RESET:
+        s->fsm2 = FSM2_IDLE;
+        break;
+    case FSM2_IDLE:
+        if (br)
+        {
+            s->fsm2 = me ? FSM2_PROCESS_LAST_BLOCK : FSM2_PROCESS_BLOCK;
+            s->take_block = 1;
+            if (!k->hashing_started)
+            {
+                s->cnt_output_size = k->d;
+                s->mode_r = k->mode;
+                s->hashing_started = 1;
+            }
+        }
+        break;
+    case FSM2_PROCESS_BLOCK:
+        if (!s->zi)
+            break;
+        if (!me && br)
+            s->take_block = 1;
+        else if (me)
+        {
+            s->fsm2 = FSM2_PROCESS_LAST_BLOCK;
+            s->take_block = 1;
+        }
+        else
+            s->fsm2 = FSM2_IDLE;
+        break;
+    case FSM2_PROCESS_LAST_BLOCK:
+        if (s->zi)
+            s->fsm2 = FSM2_FINALIZATION_SHAKE;
+        break;
+    case FSM2_FINALIZATION_SHAKE:
+        if (k->cnt_output_size > b)
+        {
+            s->fsm2 = FSM2_SHAKE_PROCESS;
+            s->output_size = b;
+            s->squeeze = 1;
+            break;
+        }
+        s->output_size = k->cnt_output_size & 0x7FF;
+        if (busy)
+        {
+            s->fsm2 = FSM2_OUTPUT_DATA_SHAKE;
+            s->hashing_started = 0;
+        }
+        else if (br)
+        {
+            s->fsm2 = me ? FSM2_PROCESS_LAST_BLOCK : FSM2_PROCESS_BLOCK;
+            s->cnt_output_size = k->d;
+            s->mode_r = k->mode;
+            s->take_block = 1;
+        }
+        else
+        {
+            s->fsm2 = FSM2_IDLE;
+            s->hashing_started = 0;
+        }
+        break;
+    case FSM2_OUTPUT_DATA_SHAKE:
+        if (busy)
+            break;
+        if (br)
+        {
+            s->fsm2 = me ? FSM2_PROCESS_LAST_BLOCK : FSM2_PROCESS_BLOCK;
+            s->cnt_output_size = k->d;
+            s->mode_r = k->mode;
+            s->hashing_started = 1;
+            s->take_block = 1;
+        }
+        else
+            s->fsm2 = FSM2_IDLE;
+        break;
+    case FSM2_SHAKE_PROCESS:
+        if (!s->zi)
+            break;
+        if (busy)
+            s->fsm2 = FSM2_SHAKE_OUTPUT_WAIT;
+        else
+        {
+            s->cnt_output_size = k->cnt_output_size - b;
+            s->fsm2 = FSM2_FINALIZATION_SHAKE;
+        }
+        break;
+    case FSM2_SHAKE_OUTPUT_WAIT:
+        if (!busy)
+        {
+            s->cnt_output_size = k->cnt_output_size - b;
+            s->fsm2 = FSM2_FINALIZATION_SHAKE;
+        }
+        break;
+    }
+
+    s->output_data_s = (k->fsm2 == FSM2_FINALIZATION_SHAKE || k->fsm2 == FSM2_OUTPUT_DATA_SHAKE) && !busy;
+    s->ei = k->fsm2 == FSM2_PROCESS_BLOCK || k->fsm2 == FSM2_PROCESS_LAST_BLOCK || k->fsm2 == FSM2_SHAKE_PROCESS;
+    s->li = k->fsm2 == FSM2_RESET || k->fsm2 == FSM2_IDLE || s->zi;
+    s->sel_xor_set = k->fsm2 == FSM2_RESET || (k->fsm2 == FSM2_PROCESS_LAST_BLOCK && s->zi) ||
+                     (k->fsm2 == FSM2_SHAKE_PROCESS && s->zi);
+    s->sel_xor_clr = k->sel_xor && br &&
+                     (k->fsm2 == FSM2_IDLE ||
+                      ((k->fsm2 == FSM2_FINALIZATION_SHAKE || k->fsm2 == FSM2_OUTPUT_DATA_SHAKE) && !busy));
+    s->msg_end_clr = br && me &&
+                     ((k->fsm2 == FSM2_IDLE) || (k->fsm2 == FSM2_PROCESS_BLOCK && s->zi) ||
+                      (k->fsm2 == FSM2_FINALIZATION_SHAKE && !busy && k->cnt_output_size <= b) ||
+                      (k->fsm2 == FSM2_OUTPUT_DATA_SHAKE && !busy));
+
+    /* sha3_fsm3 */
+    zkfin = k->kc == hseg - 1;
+    s->fsm3 = k->fsm3;
+    if (k->fsm3 == FSM3_IDLE && k->output_write)
+        s->fsm3 = FSM3_WRITE_DATA;
+    else if (k->fsm3 == FSM3_WRITE_DATA && in->dst_ready && zkfin)
+        s->fsm3 = FSM3_IDLE;
+    s->dst_write = k->fsm3 == FSM3_WRITE_DATA && in->dst_ready;
+    s->output_write_clr = k->fsm3 == FSM3_IDLE && k->output_write;
+    s->output_busy_clr = s->dst_write && zkfin;
+    s->ek = s->dst_write && !zkfin;
+    s->lk = s->output_busy_clr || s->output_write_clr;
+}
+
+static uint64_t load_be(const uint8_t *p)
+{
+    uint64_t w = 0;
+
+    for (int i = 0; i < 8; i++)
+        w = (w << 8) | p[i];
+    return w;
+}
+
+static void store_be(uint8_t *p, uint64_t w)
+{
+    for (int i = 7; i >= 0; i--, w >>= 8)
+        p[i] = (uint8_t)w;
+}
+
+/*
+ * Word wc of the SIPO: din, or what keccak_bytepad makes of it in the
+ * last block of the message: the message bytes left in c, the SHAKE
+ * pad byte where they end, and 0x80 on the last byte of the block.
+ */
+static void sipo_word(keccak_core *k, const keccak_in *in, const keccak_ctl *s)
+{
+    uint8_t *w = k->sipo + 8 * k->wc;
+    unsigned n = 8;
+
+    store_be(w, in->din);
+    if (k->full_block || !k->f)
+        return;
+
+    if (!s->src_read)
+        n = 0;
+    else if ((k->c & 0x7C0) == 0)
+        n = (k->c & 63) / 8;
+    memset(w + n, 0, 8 - n);
+    if (n < 8 && k->start_pad)
+        w[n] = 0x1F;
+    if (s->zjfin)
+        w[7] |= 0x80;
+}
+
+static void permute(keccak_core *k)
+{
+    KeccakF1600_StatePermute(k->state);
+}
+
+// Synchronous reset of keccak_top, the counters without one keep their value
+static void reset(keccak_core *k)
+{
+    k->fsm1 = FSM1_RESET;
+    k->d = k->mode = 0;
+    k->f = k->full_block = k->start_pad = 0;
+    k->block_ready = k->msg_end = k->output_write = k->output_busy = 0;
+    k->fsm2 = FSM2_RESET;
+    k->pc = k->cnt_output_size = k->output_size = k->mode_r = 0;
+    k->hashing_started = 0;
+    k->sel_xor = 1;
+    k->fsm3 = FSM3_IDLE;
+}
+
+void keccak_core_init(keccak_core *k, unsigned rounds)
+{
+    memset(k, 0, sizeof(*k));
+    k->roundnr = (KECCAK_CORE_ROUNDS + rounds - 1) / rounds;
+    reset(k);
+}
+
+void keccak_core_eval(const keccak_core *k, const keccak_in *in, keccak_out *out)
+{
+    keccak_ctl s;
+
+    control(k, in, &s);
+    out->src_read = s.src_read;
+    out->dst_write = s.dst_write;
+    out->dout = load_be(k->piso + 8 * k->kc);
+}
+
+void keccak_core_clock(keccak_core *k, const keccak_in *in)
+{
+    keccak_ctl s;
+    unsigned rate;
+
+    if (in->rst)
+    {
+        reset(k);
+        return;
+    }
+    control(k, in, &s);
+
+    k->permuting += s.ei;
+    k->output_wait += k->fsm2 == FSM2_SHAKE_OUTPUT_WAIT;
+
+    // Data: the block is taken and permuted at once, output is only seen after zi
+    if (s.ej)
+        sipo_word(k, in, &s);
+    if (s.output_data_s)
+    {
+        rate = rate_bits(k->mode_r) / 8;
+        for (unsigned i = 0; i < rate; i++)
+            k->piso[i] = (uint8_t)(k->state[i / 8] >> (8 * (i % 8)));
+    }
+    if (s.take_block)
+    {
+        if (k->sel_xor)
+            memset(k->state, 0, sizeof(k->state));
+        rate = rate_bits(k->mode) / 8;
+        for (unsigned i = 0; i < rate; i++)
+            k->state[i / 8] ^= (uint64_t)k->sipo[i] << (8 * (i % 8));
+        permute(k);
+    }
+    if (s.squeeze)
+        permute(k);
+
+    // keccak_datapath counters
+    if (s.clr_len)
+        k->c = 0;
+    else if (s.en_len)
+        k->c = (uint32_t)in->din;
+    else if (s.en_ctr)
+        k->c -= s.set_full_block ? rate_bits(k->mode) : 64;
+    if (s.en_len)
+    {
+        k->d = (uint32_t)(in->din >> 32) & 0x1FFFFFFF;
+        k->mode = (unsigned)(in->din >> 61) & 3;
+    }
+
+    // keccak_fsm1
+    k->fsm1 = s.fsm1;
+    k->wc = s.lj ? 0 : k->wc + s.ej;
+    k->f = sr(k->f, s.ef, s.lf);
+    k->full_block = sr(k->full_block, s.set_full_block, s.clr_full_block);
+    k->start_pad = sr(k->start_pad, s.set_start_pad, s.clr_start_pad);
+
+    // keccak_control
+    k->block_ready = sr(k->block_ready, s.block_ready_set, s.block_ready_clr);
+    k->msg_end = sr(k->msg_end, s.msg_end_set, s.msg_end_clr);
+    k->output_write = sr(k->output_write, s.output_data_s, s.output_write_clr);
+    k->output_busy = sr(k->output_busy, s.output_data_s, s.output_busy_clr);
+
+    // keccak_fsm2
+    k->fsm2 = s.fsm2;
+    k->pc = s.li ? 0 : k->pc + s.ei;
+    k->cnt_output_size = s.cnt_output_size;
+    k->output_size = s.output_size;
+    k->mode_r = s.mode_r;
+    k->hashing_started = s.hashing_started;
+    k->sel_xor = sr(k->sel_xor, s.sel_xor_set, s.sel_xor_clr);
+
+    // sha3_fsm3
+    k->fsm3 = s.fsm3;
+    k->kc = s.lk ? 0 : k->kc + s.ek;
+}
+
+uint64_t keccak_core_header(int shake256, uint32_t out_bits, uint32_t msg_bits)
+{
+    return (1ull << 63) | ((shake256 ? 3ull : 2ull) << 61) | ((uint64_t)(out_bits & 0x1FFFFFFF) << 32) | msg_bits;
+}
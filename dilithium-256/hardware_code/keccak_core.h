@@ -0,0 +1,140 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef KECCAK_CORE_H
+#define KECCAK_CORE_H
+
+#include <stdint.h>
+
+/*
+ * Cycle-accurate model of rtl_src/keccak_top.vhd in SHAKE mode: the
+ * input FSM keccak_fsm1, the permutation FSM keccak_fsm2, the output
+ * FSM sha3_fsm3 and the set/reset flags of keccak_control between them.
+ * Control follows the VHDL cycle by cycle; the state is kept as lanes
+ * and permuted with KeccakF1600_StatePermute when a block is taken, so
+ * the words on dout are the ones the RTL would write.
+ * keccak_round does `rounds` rounds per cycle (1 in the RTL), so one
+ * permutation takes roundnr = ceil(24 / rounds) cycles.
+ */
+
+#define KECCAK_CORE_ROUNDS 24
+#define KECCAK_CORE_LANES 25
+
+enum keccak_fsm1_state
+{
+    FSM1_RESET,
+    FSM1_WAIT_FOR_HEADER1,
+    FSM1_WAIT_FOR_LOAD1,
+    FSM1_LOAD_BLOCK,
+    FSM1_WAIT_FOR_LOAD2
+};
+
+enum keccak_fsm2_state
+{
+    FSM2_RESET,
+    FSM2_IDLE,
+    FSM2_PROCESS_BLOCK,
+    FSM2_PROCESS_LAST_BLOCK,
+    FSM2_FINALIZATION_SHAKE,
+    FSM2_OUTPUT_DATA_SHAKE,
+    FSM2_SHAKE_PROCESS,
+    FSM2_SHAKE_OUTPUT_WAIT
+};
+
+enum sha3_fsm3_state
+{
+    FSM3_IDLE,
+    FSM3_WRITE_DATA
+};
+
+/*
+ * Ports of keccak_top with the polarity turned around: src_valid is
+ * src_ready = '0' in the RTL, dst_ready is dst_ready = '0'.
+ * Words are big endian, the first byte of the stream in bits 63:56.
+ */
+typedef struct
+{
+    int rst;
+    int src_valid;
+    uint64_t din;
+    int dst_ready;
+} keccak_in;
+
+typedef struct
+{
+    int src_read;
+    int dst_write;
+    uint64_t dout;
+} keccak_out;
+
+typedef struct
+{
+    unsigned roundnr;
+
+    // keccak_fsm1 and the counters of keccak_datapath
+    enum keccak_fsm1_state fsm1;
+    unsigned wc;            // words of the block in the SIPO
+    uint32_t c;             // message bits left, from the header
+    uint32_t d;             // output bits, from the header
+    unsigned mode;          // 2: SHAKE128, 3: SHAKE256
+    int f, full_block, start_pad;
+
+    // keccak_control
+    int block_ready, msg_end, output_write, output_busy;
+
+    // keccak_fsm2
+    enum keccak_fsm2_state fsm2;
+    unsigned pc;
+    uint32_t cnt_output_size;
+    unsigned output_size, mode_r;
+    int hashing_started, sel_xor;
+
+    // sha3_fsm3
+    enum sha3_fsm3_state fsm3;
+    unsigned kc;
+
+    // Data
+    uint64_t state[KECCAK_CORE_LANES];
+    uint8_t sipo[200];
+    uint8_t piso[200];
+
+    // Activity, for the reports
+    unsigned long long permuting, output_wait;
+} keccak_core;
+
+// rounds: rounds of Keccak-f per cycle, from 1 to 24
+void keccak_core_init(keccak_core *k, unsigned rounds);
+
+// Outputs for this cycle, from the registers and the inputs
+void keccak_core_eval(const keccak_core *k, const keccak_in *in, keccak_out *out);
+
+// Rising edge of clk
+void keccak_core_clock(keccak_core *k, const keccak_in *in);
+
+/*
+ * Header word for keccak_top: last segment, SHAKE128 or SHAKE256,
+ * out_bits of output for a msg_bits message.
+ */
+uint64_t keccak_core_header(int shake256, uint32_t out_bits, uint32_t msg_bits);
+
+#endif
@@ -0,0 +1,381 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <algorithm>
+#include "op_sched.h"
+
+// BRAM ports held while running: NTT/INTT read and write one bank, MULT reads a, b, acc and writes, ADD reads two and writes
+static const unsigned ports_of[SCHED_KINDS] = {2, 2, SCHED_PORTS_MIN, 3, 0, 0, 0};
+
+static const char *const unit_names[SCHED_KINDS] = {"op", "op", "op", "op", "gen_a", "keccak", "axi"};
+
+static unsigned add(sched_graph *g, const char *name, unsigned poly, unsigned attempt,
+                    enum sched_kind kind, unsigned duration, const std::vector<unsigned> &deps)
+{
+    sched_task t;
+
+    t.name = name;
+    t.poly = poly;
+    t.attempt = attempt;
+    t.kind = kind;
+    t.duration = duration;
+    t.deps = deps;
+    t.rank = t.start = t.end = t.where = 0;
+    g->task.push_back(t);
+    return g->task.size() - 1;
+}
+
+// {task} when `cond`, no dependency otherwise
+static std::vector<unsigned> after(bool cond, unsigned task)
+{
+    return cond ? std::vector<unsigned>{task} : std::vector<unsigned>{};
+}
+
+// One of `polys` polynomials in from AXI: a word in and 4 coefficients out per cycle
+static unsigned decode(unsigned bytes, unsigned polys)
+{
+    return std::max(bytes / 8 / polys, (unsigned)BRAM_DEPT);
+}
+
+static unsigned op_cycles(const tlm_timing *t, enum sched_kind kind)
+{
+    switch (kind)
+    {
+    case SCHED_NTT:
+        return t->ntt + t->op_issue;
+    case SCHED_INTT:
+        return t->intt + t->op_issue;
+    case SCHED_MULT:
+        return t->mult + t->op_issue;
+    default:
+        return t->add + t->op_issue;
+    }
+}
+
+static unsigned op(sched_graph *g, const tlm_timing *t, const char *name, unsigned poly, unsigned attempt,
+                   enum sched_kind kind, const std::vector<unsigned> &deps)
+{
+    return add(g, name, poly, attempt, kind, op_cycles(t, kind), deps);
+}
+
+/*
+ * Row i of A times a vector in the NTT domain, accumulated in place the
+ * way MULT mode does: each product waits for the one before it.
+ */
+static unsigned mult_row(sched_graph *g, const tlm_timing *t, const char *name, unsigned i, unsigned attempt,
+                         const std::vector<unsigned> &a, const std::vector<unsigned> &x)
+{
+    unsigned last = 0;
+
+    for (unsigned j = 0; j < x.size(); j++)
+    {
+        std::vector<unsigned> deps = {a[i * x.size() + j], x[j]};
+
+        if (j)
+            deps.push_back(last);
+        last = op(g, t, name, i, attempt, SCHED_MULT, deps);
+    }
+    return last;
+}
+
+static std::vector<unsigned> gen_a(sched_graph *g, const tlm_timing *t, const hw_level *p)
+{
+    std::vector<unsigned> a;
+    unsigned cycles = tlm_poly_a(t);
+
+    for (unsigned i = 0; i < p->K * p->L; i++)
+        a.push_back(add(g, "GEN_A", i, 0, SCHED_GEN_A, cycles, {}));
+    return a;
+}
+
+static void keygen(sched_graph *g, const tlm_timing *t, const hw_level *p)
+{
+    std::vector<unsigned> a = gen_a(g, t, p), s1, s1_hat, s2;
+
+    for (unsigned j = 0; j < p->L; j++)
+    {
+        s1.push_back(add(g, "KG_SAMPLE_S1", j, 0, SCHED_KECCAK, tlm_poly_s(t, p), after(j, j ? s1[j - 1] : 0)));
+        s1_hat.push_back(op(g, t, "KG_NTT_S1", j, 0, SCHED_NTT, {s1[j]}));
+    }
+    for (unsigned i = 0; i < p->K; i++)
+        s2.push_back(add(g, "KG_SAMPLE_S2", i, 0, SCHED_KECCAK, tlm_poly_s(t, p), {i ? s2[i - 1] : s1[p->L - 1]}));
+    for (unsigned i = 0; i < p->K; i++)
+    {
+        unsigned ti = mult_row(g, t, "KG_MULT_AS1", i, 0, a, s1_hat);
+
+        ti = op(g, t, "KG_NTTI_T", i, 0, SCHED_INTT, {ti});
+        op(g, t, "KG_ADD_T_S2", i, 0, SCHED_ADD, {ti, s2[i]});
+    }
+}
+
+static void verify(sched_graph *g, const tlm_timing *t, const hw_level *p)
+{
+    std::vector<unsigned> a = gen_a(g, t, p), z_hat, t1_hat;
+    unsigned c, c_hat, axi = 0;
+
+    c = add(g, "VY_LOAD_C", 0, 0, SCHED_KECCAK, tlm_sample_c(t, p), {});
+    for (unsigned j = 0; j < p->L; j++)
+    {
+        axi = add(g, "VY_DECODE_Z", j, 0, SCHED_AXI, decode(p->Z_LEN, p->L), after(j, axi));
+        z_hat.push_back(op(g, t, "VY_NTT_Z", j, 0, SCHED_NTT, {axi}));
+    }
+    for (unsigned i = 0; i < p->K; i++)
+    {
+        axi = add(g, "VY_DECODE_T1", i, 0, SCHED_AXI, decode(p->T1_LEN, p->K), {axi});
+        t1_hat.push_back(op(g, t, "VY_NTT_T1", i, 0, SCHED_NTT, {axi}));
+    }
+    c_hat = op(g, t, "VY_NTT_C", 0, 0, SCHED_NTT, {c});
+    for (unsigned i = 0; i < p->K; i++)
+    {
+        unsigned az = mult_row(g, t, "VY_MULT_AZ", i, 0, a, z_hat);
+        unsigned ct1 = op(g, t, "VY_MULT_CT1", i, 0, SCHED_MULT, {c_hat, t1_hat[i]});
+
+        op(g, t, "VY_INTT", i, 0, SCHED_INTT, {op(g, t, "VY_SUB_AZ_CT1", i, 0, SCHED_ADD, {az, ct1})});
+    }
+}
+
+/*
+ * Attempts run back to back as in the RTL: y of the next attempt is
+ * sampled once gen_c is done with the keccak_top, and every attempt
+ * goes through MAKEHINT before the decision.
+ */
+static void sign(sched_graph *g, const tlm_timing *t, const hw_level *p, unsigned attempts)
+{
+    std::vector<unsigned> a = gen_a(g, t, p), s1, s2, t0;
+    // Tasks of earlier attempts the next ones wait for
+    std::vector<unsigned> hint, z[2];
+    unsigned axi = 0, keccak = 0;
+
+    for (unsigned j = 0; j < p->L; j++)
+    {
+        axi = add(g, "FSM0_DECODE_S1", j, 0, SCHED_AXI, decode(p->S1_LEN, p->L), after(j, axi));
+        s1.push_back(op(g, t, "FSM0_NTT_S1", j, 0, SCHED_NTT, {axi}));
+    }
+    for (unsigned i = 0; i < p->K; i++)
+    {
+        axi = add(g, "FSM0_DECODE_S2", i, 0, SCHED_AXI, decode(p->S2_LEN, p->K), {axi});
+        s2.push_back(op(g, t, "FSM0_NTT_S2", i, 0, SCHED_NTT, {axi}));
+    }
+    for (unsigned i = 0; i < p->K; i++)
+    {
+        axi = add(g, "FSM0_DECODE_T0", i, 0, SCHED_AXI, decode(p->T0_LEN, p->K), {axi});
+        t0.push_back(op(g, t, "FSM0_NTT_T0", i, 0, SCHED_NTT, {axi}));
+    }
+
+    for (unsigned n = 1; n <= attempts; n++)
+    {
+        std::vector<unsigned> y_hat, w;
+        unsigned c, c_hat;
+
+        // y_hat is double buffered in BRAM 1 under z of the attempt before last
+        for (unsigned j = 0; j < p->L; j++)
+        {
+            std::vector<unsigned> deps = after(n > 1 || j, keccak);
+
+            keccak = add(g, "FSM1_GENY", j, n, SCHED_KECCAK, tlm_poly_y(t, p), deps);
+            deps = {keccak};
+            if (n > 2)
+                deps.push_back(z[n % 2][j]);
+            y_hat.push_back(op(g, t, "FSM1_NTT_Y", j, n, SCHED_NTT, deps));
+        }
+        for (unsigned i = 0; i < p->K; i++)
+            w.push_back(op(g, t, "FSM1_NTTI_W", i, n, SCHED_INTT, {mult_row(g, t, "FSM1_MULT_A_Y", i, n, a, y_hat)}));
+
+        // DECOMP and GEN_C hold the keccak_top. FSM2 keeps one attempt in BRAM 4 to 6
+        keccak = c = add(g, "FSM2_GEN_C", 0, n, SCHED_KECCAK, tlm_decomp_c(t, p), w);
+        hint.push_back(c);
+        c_hat = op(g, t, "FSM2_NTT_C", 0, n, SCHED_NTT, hint);
+        hint.clear();
+
+        // z accumulates onto y_hat, cs2 and ct0 go through the INTT
+        z[n % 2].clear();
+        for (unsigned j = 0; j < p->L; j++)
+            z[n % 2].push_back(op(g, t, "FSM2_NTTI_Z", j, n, SCHED_INTT, {op(g, t, "FSM2_MULTACC", j, n, SCHED_MULT, {c_hat, s1[j], y_hat[j]})}));
+        for (unsigned i = 0; i < p->K; i++)
+        {
+            unsigned cs2 = op(g, t, "FSM2_NTTI_CS2", i, n, SCHED_INTT, {op(g, t, "FSM2_MULT_CS2", i, n, SCHED_MULT, {c_hat, s2[i]})});
+            unsigned ct0 = op(g, t, "FSM2_NTTI_CT0", i, n, SCHED_INTT, {op(g, t, "FSM2_MULT_CT0", i, n, SCHED_MULT, {c_hat, t0[i]})});
+
+            hint.push_back(op(g, t, "FSM2_MAKEHINT", i, n, SCHED_ADD, {op(g, t, "FSM2_SUB_W0_CS2", i, n, SCHED_ADD, {cs2, c}), ct0}));
+        }
+    }
+}
+
+int sched_build(sched_graph *g, const tlm_timing *t, enum tlm_mode mode, int sec_lvl, unsigned attempts)
+{
+    const hw_level *p = hw_get_level(sec_lvl);
+
+    if (p == NULL || (mode == TLM_SIGN && attempts == 0))
+        return -1;
+    g->task.clear();
+    g->sampler_a = t->sampler_a;
+    if (mode == TLM_KEYGEN)
+        keygen(g, t, p);
+    else if (mode == TLM_VERIFY)
+        verify(g, t, p);
+    else
+        sign(g, t, p, attempts);
+    return 0;
+}
+
+// Longest path from the start of each task to the end. Tasks only depend on earlier ones
+static void rank(sched_graph *g)
+{
+    for (unsigned i = g->task.size(); i-- > 0;)
+    {
+        sched_task *s = &g->task[i];
+
+        s->rank += s->duration;
+        for (unsigned d : s->deps)
+            g->task[d].rank = std::max(g->task[d].rank, s->rank);
+    }
+}
+
+// First free instance of a unit, -1 when all are busy
+static int take(std::vector<char> &busy)
+{
+    for (unsigned i = 0; i < busy.size(); i++)
+    {
+        if (!busy[i])
+        {
+            busy[i] = 1;
+            return i;
+        }
+    }
+    return -1;
+}
+
+int sched_run(sched_graph *g, const sched_config *c, unsigned *makespan)
+{
+    const unsigned n = g->task.size();
+    // Operators are shared by the four operations, the other units run one kind each
+    std::vector<char> operators(c->operators), units[SCHED_KINDS] = {{}, {}, {}, {}, std::vector<char>(g->sampler_a), {0}, {0}};
+    std::vector<std::vector<unsigned>> next_of(n);
+    std::vector<unsigned> ready, running, left(n);
+    unsigned now = 0, ports = c->ports;
+
+    // A MULT needs an operator and SCHED_PORTS_MIN ports, GEN_A a sampler
+    if (c->operators == 0 || c->ports < SCHED_PORTS_MIN || g->sampler_a == 0)
+        return -1;
+    for (unsigned i = 0; i < n; i++)
+    {
+        g->task[i].rank = 0;
+        left[i] = g->task[i].deps.size();
+        if (left[i] == 0)
+            ready.push_back(i);
+        for (unsigned d : g->task[i].deps)
+            next_of[d].push_back(i);
+    }
+    rank(g);
+
+    while (!ready.empty() || !running.empty())
+    {
+        // Longest path first, then program order
+        std::sort(ready.begin(), ready.end(), [g](unsigned x, unsigned y)
+                  { return g->task[x].rank != g->task[y].rank ? g->task[x].rank > g->task[y].rank : x < y; });
+        for (unsigned k = 0; k < ready.size();)
+        {
+            sched_task *s = &g->task[ready[k]];
+            int slot = -1;
+
+            if (s->kind >= SCHED_GEN_A)
+                slot = take(units[s->kind]);
+            else if (ports >= ports_of[s->kind] && (slot = take(operators)) >= 0)
+                ports -= ports_of[s->kind];
+            if (slot < 0)
+            {
+                k++;
+                continue;
+            }
+            s->start = now;
+            s->end = now + s->duration;
+            s->where = slot;
+            running.push_back(ready[k]);
+            ready.erase(ready.begin() + k);
+        }
+        // Nothing running will free what the ready tasks wait for
+        if (running.empty())
+            return -1;
+
+        // Advance to the next end and release what those tasks held
+        now = ~0u;
+        for (unsigned r : running)
+            now = std::min(now, g->task[r].end);
+        for (unsigned k = 0; k < running.size();)
+        {
+            sched_task *s = &g->task[running[k]];
+
+            if (s->end != now)
+            {
+                k++;
+                continue;
+            }
+            if (s->kind >= SCHED_GEN_A)
+                units[s->kind][s->where] = 0;
+            else
+            {
+                operators[s->where] = 0;
+                ports += ports_of[s->kind];
+            }
+            for (unsigned i : next_of[running[k]])
+            {
+                if (--left[i] == 0)
+                    ready.push_back(i);
+            }
+            running.erase(running.begin() + k);
+        }
+    }
+    *makespan = now;
+    return 0;
+}
+
+unsigned long long sched_operator_cycles(const sched_graph *g)
+{
+    unsigned long long busy = 0;
+
+    for (const sched_task &s : g->task)
+    {
+        if (s.kind < SCHED_GEN_A)
+            busy += s.duration;
+    }
+    return busy;
+}
+
+void sched_print(FILE *f, const sched_graph *g)
+{
+    std::vector<unsigned> order(g->task.size());
+
+    for (unsigned i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [g](unsigned x, unsigned y)
+                     { return g->task[x].start < g->task[y].start; });
+    for (unsigned i : order)
+    {
+        const sched_task *s = &g->task[i];
+
+        fprintf(f, "  %7u %7u  %-7s%u  %-16s %2u", s->start, s->end, unit_names[s->kind], s->where, s->name, s->poly);
+        if (s->attempt)
+            fprintf(f, "  attempt %u", s->attempt);
+        fprintf(f, "\n");
+    }
+}
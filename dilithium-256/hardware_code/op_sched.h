@@ -0,0 +1,101 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef OP_SCHED_H
+#define OP_SCHED_H
+
+#include <stdio.h>
+#include <vector>
+#include "combined_tlm.h"
+#include "hw_levels.h"
+
+/*
+ * List scheduling of the polynomial operations of keygen, sign and
+ * verify on any number of operation_module instances.
+ * One task is one polynomial through one operator (NTT, INTT, MULT,
+ * ADD/SUB) or through one of the units that feed them: the gen_a_ext
+ * samplers, the keccak_top shared by gen_s, gen_y and gen_c, and the
+ * AXI decoder. Operators also hold BRAM ports while they run.
+ * Whenever an operator or unit is free, the ready task with the longest
+ * path to the end goes first.
+ */
+
+enum sched_kind
+{
+    SCHED_NTT,
+    SCHED_INTT,
+    SCHED_MULT,
+    SCHED_ADD,
+    SCHED_GEN_A,  // one polynomial of A, on one of sampler_a units
+    SCHED_KECCAK, // gen_s, gen_y, and DECOMP with gen_c
+    SCHED_AXI,    // one polynomial in from the decoder
+    SCHED_KINDS
+};
+
+typedef struct
+{
+    const char *name; // combined_top state the task belongs to
+    unsigned poly;    // polynomial index
+    unsigned attempt; // sign attempt, from 1
+    enum sched_kind kind;
+    unsigned duration;
+    std::vector<unsigned> deps;
+    // Set by sched_run
+    unsigned rank, start, end, where;
+} sched_task;
+
+typedef struct
+{
+    std::vector<sched_task> task;
+    unsigned sampler_a;
+} sched_graph;
+
+// BRAM ports of one MULT, the most any operation holds
+#define SCHED_PORTS_MIN 4
+
+typedef struct
+{
+    unsigned operators; // NUM_OPERATORS
+    unsigned ports;     // BRAM ports the operators share
+} sched_config;
+
+/*
+ * Tasks of one keygen, verify, or sign over `attempts` attempts at
+ * sec_lvl. Return -1 for an unknown level.
+ */
+int sched_build(sched_graph *g, const tlm_timing *t, enum tlm_mode mode, int sec_lvl, unsigned attempts);
+
+/*
+ * Schedule every task and set *makespan. Return 0, -1 when a task can
+ * never be placed: no operator, fewer than SCHED_PORTS_MIN ports, or no
+ * gen_a_ext sampler.
+ */
+int sched_run(sched_graph *g, const sched_config *c, unsigned *makespan);
+
+// Busy cycles of the operators, summed
+unsigned long long sched_operator_cycles(const sched_graph *g);
+
+// Tasks by start cycle, after sched_run
+void sched_print(FILE *f, const sched_graph *g);
+
+#endif
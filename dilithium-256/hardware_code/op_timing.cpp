@@ -0,0 +1,40 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include "op_timing.h"
+
+void tlm_timing_default(tlm_timing *t)
+{
+    /*
+     * operation_module.v: the forward NTT pauses 1 + 7 cycles after each
+     * pass and writes back 22 cycles after the read, the inverse 1 + 5
+     * and 23. MULT and ADD/SUB write back after 9 and 5 cycles.
+     */
+    t->ntt = NTT2X2_STEPS - DEPT_W + (DILITHIUM_LOGN / 2) * 8 + 22;
+    t->intt = INTT2X2_STEPS - DEPT_I + (DILITHIUM_LOGN / 2) * 6 + 23;
+    t->mult = MUL2X2_STEPS + 9;
+    t->add = MUL2X2_STEPS + 5;
+    t->op_issue = 2;
+    t->keccak_rounds = 1;
+    t->sampler_a = 2;
+}
@@ -0,0 +1,53 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef OP_TIMING_H
+#define OP_TIMING_H
+
+#include "config.h"
+#include "fifo.h"
+
+// One clock of ntt2x2_fwdntt / ntt2x2_invntt per BRAM line and pass, then the FIFO drain
+#define NTT2X2_STEPS ((DILITHIUM_LOGN / 2) * BRAM_DEPT + DEPT_W)
+#define INTT2X2_STEPS ((DILITHIUM_LOGN / 2) * BRAM_DEPT + DEPT_I)
+#define MUL2X2_STEPS BRAM_DEPT
+
+/*
+ * Cycles per polynomial operation and per Keccak permutation.
+ * tlm_timing_default starts from the step counts of the C++ NTT model
+ * and adds what operation_module.v has on top of them: the pause
+ * between NTT passes and the deeper butterfly pipeline. Those extra
+ * cycles and op_issue are read off the RTL source, not measured in
+ * simulation.
+ */
+typedef struct
+{
+    unsigned ntt, intt, mult, add; // start_op to done_op of one polynomial
+    unsigned op_issue;             // done_op to the next start_op
+    unsigned keccak_rounds;        // rounds per cycle of keccak_round
+    unsigned sampler_a;            // SAMPLER_NUM of gen_a_ext, one keccak_top each, up to GEN_A_SAMPLERS_MAX
+} tlm_timing;
+
+void tlm_timing_default(tlm_timing *t);
+
+#endif
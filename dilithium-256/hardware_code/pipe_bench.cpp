@@ -0,0 +1,101 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipeline.h"
+
+/*
+ * Throughput and stalls of the keygen t1 pipeline of pipeline.h at each
+ * level, over the lines each A channel holds (16, a polynomial, four,
+ * all of A as the BRAMs of combined_top) and how often the AXI sink is
+ * ready.
+ * op is how the operator spends its cycles: busy, starved of A, blocked
+ * by Power2Round; A full is cycles a sampler held samples back, AXI
+ * full cycles the encoder held a word. overflow counts the lines the
+ * encoder PISO had no room for, data whether the words came out right.
+ * Usage: pipe_bench [--level n] [--samplers n] [--rounds n] [--paced]
+ */
+
+int main(int argc, char **argv)
+{
+    const int levels[3] = {2, 3, 5};
+    const unsigned depths[4] = {16, 64, 256, 4096}, duty[3] = {100, 50, 25};
+    int level = 0;
+    pipe_config c;
+    pipe_result r;
+
+    c.samplers = 2;
+    c.rounds = 1;
+    c.paced = 0;
+    tlm_timing_default(&c.t);
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+            level = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--samplers") == 0 && i + 1 < argc)
+            c.samplers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            c.rounds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--paced") == 0)
+            c.paced = 1;
+        else
+            level = -1;
+    }
+    c.sec_lvl = level ? level : 2;
+    c.depth = 16;
+    c.axi_ready = 100;
+    if (level < 0 || pipe_run(&r, &c))
+    {
+        printf("Usage: %s [--level n] [--samplers n] [--rounds n] [--paced]\n", argv[0]);
+        return 1;
+    }
+
+    printf("gen_a_ext -> operation_module -> Power2Round -> encoder -> AXI, %u samplers, "
+           "%u Keccak rounds per cycle, encoder %s\n",
+           c.samplers, c.rounds, c.paced ? "paced" : "as encoder.v");
+    printf("Level  depth  AXI  cycles  words/cycle  op busy starved blocked   A full   AXI full  overflow  data\n");
+    for (int l = 0; l < 3; l++)
+    {
+        if (level && level != levels[l])
+            continue;
+        c.sec_lvl = levels[l];
+        for (unsigned d = 0; d < 4; d++)
+        {
+            for (unsigned a = 0; a < 3; a++)
+            {
+                c.depth = depths[d];
+                c.axi_ready = duty[a];
+                pipe_run(&r, &c);
+                printf("%5d  %5u %3u%%  %6llu  %11.3f  %6.1f%% %6.1f%% %6.1f%%  %7llu  %9llu  %8llu  %s\n",
+                       levels[l], c.depth, c.axi_ready, r.cycles, (double)r.words / r.cycles,
+                       100.0 * r.op_busy / r.cycles, 100.0 * r.op_starved / r.cycles,
+                       100.0 * r.op_blocked / r.cycles, r.sampler_blocked, r.ch[PIPE_AXI].full,
+                       r.enc_overflow, r.ok ? "ok" : "WRONG");
+            }
+        }
+    }
+    return 0;
+}
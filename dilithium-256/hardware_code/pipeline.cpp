@@ -0,0 +1,363 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <string.h>
+#include "channel.h"
+#include "gen_a_model.h"
+#include "ntt2x2.h"
+#include "pipeline.h"
+
+#define T1_BITS 10
+#define PISO_BITS 256
+#define LINE_BITS (4 * T1_BITS)
+#define STALL_LIMIT 100000 // cycles without a word out before giving up
+
+typedef struct
+{
+    bram s1[8];
+    uint8_t rho[32];
+} pipe_inputs;
+
+static void inputs(pipe_inputs *in)
+{
+    for (unsigned i = 0; i < sizeof(in->rho); i++)
+        in->rho[i] = i;
+    for (unsigned l = 0; l < 8; l++)
+    {
+        for (unsigned i = 0; i < DILITHIUM_N; i++)
+            in->s1[l].coeffs[i / 4][i % 4] = (i * 2654435761u + l * 40503u) % DILITHIUM_Q;
+    }
+}
+
+static data_t mac(data_t acc, data_t a, data_t s)
+{
+    return (data_t)((acc + (int64_t)a * s) % DILITHIUM_Q);
+}
+
+static void power2round(pipe_line *l)
+{
+    for (unsigned j = 0; j < 4; j++)
+    {
+        data_t t = ((l->c[j] % DILITHIUM_Q) + DILITHIUM_Q) % DILITHIUM_Q;
+
+        l->c[j] = (t + (1 << 12) - 1) >> 13;
+    }
+}
+
+static uint64_t strip(const data_t c[4])
+{
+    uint64_t v = 0;
+
+    for (unsigned j = 0; j < 4; j++)
+        v |= (uint64_t)(c[j] & ((1 << T1_BITS) - 1)) << (T1_BITS * j);
+    return v;
+}
+
+// OR nbits of v at bit pos of a little-endian buffer of `words` words, the rest is lost
+static void put_bits(uint64_t *buf, unsigned words, unsigned pos, uint64_t v, unsigned nbits)
+{
+    unsigned w = pos / 64, off = pos % 64;
+
+    if (w < words)
+        buf[w] |= v << off;
+    if (off + nbits > 64 && w + 1 < words)
+        buf[w + 1] |= v >> (64 - off);
+}
+
+/*
+ * The words the sink should get: A from gen_a_model, then A * s1, the
+ * INTT, Power2Round and T1 packing one after the other.
+ */
+static void expected(uint64_t *words, const pipe_inputs *in, const pipe_config *c, const hw_level *p)
+{
+    static int32_t a[8 * 7][DILITHIUM_N];
+    gen_a_stats st;
+    bram acc;
+    pipe_line line;
+
+    gen_a_model(&st, a, in->rho, c->sec_lvl, c->samplers, c->rounds);
+    memset(words, 0, p->T1_LEN);
+    for (unsigned k = 0; k < p->K; k++)
+    {
+        memset(&acc, 0, sizeof(acc));
+        for (unsigned l = 0; l < p->L; l++)
+        {
+            for (unsigned i = 0; i < DILITHIUM_N; i++)
+                acc.coeffs[i / 4][i % 4] = mac(acc.coeffs[i / 4][i % 4], a[k * p->L + l][i],
+                                               in->s1[l].coeffs[i / 4][i % 4]);
+        }
+        ntt2x2_invntt(&acc, INVERSE_NTT_MODE, NATURAL);
+        for (unsigned i = 0; i < BRAM_DEPT; i++)
+        {
+            memcpy(line.c, acc.coeffs[i], sizeof(line.c));
+            power2round(&line);
+            put_bits(words, p->T1_LEN / 8, (k * BRAM_DEPT + i) * LINE_BITS, strip(line.c), LINE_BITS);
+        }
+    }
+}
+
+/* ========================== operation_module ========================== */
+
+enum op_state
+{
+    OP_MULT,
+    OP_MULT_TAIL,
+    OP_INTT,
+    OP_UNLOAD,
+    OP_DONE
+};
+
+typedef struct
+{
+    enum op_state state;
+    unsigned k, l, line, wait;
+    bram acc;
+} op_stage;
+
+template <unsigned DEPTH>
+static void op_step(op_stage *op, channel<pipe_line, DEPTH> *a, channel<pipe_line, 1> *out,
+                    const pipe_config *c, const hw_level *p, const pipe_inputs *in, pipe_result *r)
+{
+    pipe_line line;
+
+    switch (op->state)
+    {
+    case OP_MULT:
+        if (!ch_pop(&a[(op->k * p->L + op->l) % c->samplers], &line))
+        {
+            r->op_starved++;
+            return;
+        }
+        for (unsigned j = 0; j < 4; j++)
+            op->acc.coeffs[line.addr][j] = mac(op->acc.coeffs[line.addr][j], line.c[j], in->s1[op->l].coeffs[line.addr][j]);
+        if (++op->line == BRAM_DEPT)
+        {
+            op->state = OP_MULT_TAIL;
+            op->wait = c->t.mult + c->t.op_issue > BRAM_DEPT ? c->t.mult + c->t.op_issue - BRAM_DEPT : 1;
+        }
+        break;
+    case OP_MULT_TAIL:
+        if (--op->wait)
+            break;
+        op->line = 0;
+        if (++op->l < p->L)
+        {
+            op->state = OP_MULT;
+            break;
+        }
+        ntt2x2_invntt(&op->acc, INVERSE_NTT_MODE, NATURAL);
+        op->state = OP_INTT;
+        op->wait = c->t.intt + c->t.op_issue;
+        break;
+    case OP_INTT:
+        if (--op->wait == 0)
+            op->state = OP_UNLOAD;
+        break;
+    case OP_UNLOAD:
+        line.poly = op->k;
+        line.addr = op->line;
+        memcpy(line.c, op->acc.coeffs[op->line], sizeof(line.c));
+        if (!ch_push(out, line))
+        {
+            r->op_blocked++;
+            return;
+        }
+        if (++op->line < BRAM_DEPT)
+            break;
+        memset(&op->acc, 0, sizeof(op->acc));
+        op->line = op->l = 0;
+        op->state = ++op->k == p->K ? OP_DONE : OP_MULT;
+        break;
+    case OP_DONE:
+        return;
+    }
+    r->op_busy++;
+}
+
+/* ============================== encoder ============================== */
+
+typedef struct
+{
+    uint64_t piso[PISO_BITS / 64];
+    unsigned piso_len;
+    bool valid_buffer[2];
+    data_t buffer[2][4]; // di_buffer, di_uncentered_buffer
+} enc_stage;
+
+static void enc_step(enc_stage *e, channel<pipe_line, 1> *in, channel<uint64_t, 1> *out, int paced,
+                     pipe_result *r)
+{
+    const unsigned words = PISO_BITS / 64;
+    unsigned piso_len_next = e->piso_len, in_flight = e->valid_buffer[0] + e->valid_buffer[1];
+    bool ready_i = !paced || e->piso_len + (in_flight + 1) * LINE_BITS <= PISO_BITS;
+    pipe_line line;
+    bool take;
+
+    if (e->piso_len >= 64 && ch_push(out, e->piso[0]))
+    {
+        piso_len_next -= 64;
+        memmove(e->piso, e->piso + 1, (words - 1) * sizeof(e->piso[0]));
+        e->piso[words - 1] = 0;
+    }
+    take = ready_i && ch_pop(in, &line);
+
+    if (e->valid_buffer[1])
+    {
+        r->enc_overflow += piso_len_next + LINE_BITS > PISO_BITS;
+        if (piso_len_next < PISO_BITS)
+            put_bits(e->piso, words, piso_len_next, strip(e->buffer[1]), LINE_BITS);
+        piso_len_next += LINE_BITS;
+    }
+    e->piso_len = piso_len_next;
+    e->valid_buffer[1] = e->valid_buffer[0];
+    memcpy(e->buffer[1], e->buffer[0], sizeof(e->buffer[0]));
+    e->valid_buffer[0] = take;
+    if (take)
+        memcpy(e->buffer[0], line.c, sizeof(line.c));
+}
+
+/* ============================== pipeline ============================== */
+
+template <typename T, unsigned DEPTH>
+static void stats(pipe_channel_stats *s, const channel<T, DEPTH> *c)
+{
+    s->transfers += c->transfers;
+    s->full += c->full;
+    s->empty += c->empty;
+    s->occupancy += c->cycles ? (double)c->occupancy / c->cycles : 0;
+}
+
+template <unsigned DEPTH>
+static void run(pipe_result *r, const pipe_config *c, const hw_level *p, const pipe_inputs *in,
+                const uint64_t *expect)
+{
+    static gen_a_ext g;
+    static channel<pipe_line, DEPTH> a[GEN_A_SAMPLERS_MAX];
+    static op_stage op;
+    channel<pipe_line, 1> t, t1;
+    channel<uint64_t, 1> axi;
+    delay_stage<pipe_line, 2> p2r;
+    enc_stage enc;
+    gen_a_out out;
+    unsigned ready_o, duty = 0, idle = 0;
+    const unsigned total = p->T1_LEN / 8;
+    uint64_t w;
+
+    gen_a_ext_init(&g, in->rho, c->sec_lvl, c->samplers, c->rounds);
+    for (unsigned i = 0; i < c->samplers; i++)
+        ch_init(&a[i]);
+    ch_init(&t);
+    ch_init(&t1);
+    ch_init(&axi);
+    ds_init(&p2r, power2round);
+    memset(&op, 0, sizeof(op));
+    memset(&enc, 0, sizeof(enc));
+    r->ok = 1;
+
+    // Stages from the sink back to the source, then the clock edge
+    while (r->words < total && idle < STALL_LIMIT)
+    {
+        idle++;
+        duty += c->axi_ready;
+        if (duty >= 100)
+        {
+            duty -= 100;
+            if (ch_pop(&axi, &w))
+            {
+                r->ok &= w == expect[r->words];
+                r->words++;
+                idle = 0;
+            }
+        }
+        enc_step(&enc, &t1, &axi, c->paced, r);
+        ds_step(&p2r, &t, &t1);
+        op_step(&op, a, &t, c, p, in, r);
+
+        gen_a_ext_eval(&g, &out);
+        ready_o = 0;
+        for (unsigned i = 0; i < c->samplers; i++)
+        {
+            pipe_line line = {out.poly[i], out.coeff[i] / 4, {0, 0, 0, 0}};
+
+            if (!((out.valid >> i) & 1) || out.poly[i] >= g.polys)
+            {
+                ready_o |= 1 << i;
+                continue;
+            }
+            for (unsigned j = 0; j < 4; j++)
+                line.c[j] = (data_t)out.samples[i][j];
+            if (ch_push(&a[i], line))
+                ready_o |= 1 << i;
+            else
+                r->sampler_blocked++;
+        }
+        gen_a_ext_clock(&g, ready_o);
+
+        for (unsigned i = 0; i < c->samplers; i++)
+            ch_clock(&a[i]);
+        ch_clock(&t);
+        ch_clock(&t1);
+        ch_clock(&axi);
+        r->cycles++;
+    }
+    r->ok &= r->words == total;
+
+    for (unsigned i = 0; i < c->samplers; i++)
+        stats(&r->ch[PIPE_A], &a[i]);
+    stats(&r->ch[PIPE_T], &t);
+    stats(&r->ch[PIPE_T1], &t1);
+    stats(&r->ch[PIPE_AXI], &axi);
+}
+
+int pipe_run(pipe_result *r, const pipe_config *c)
+{
+    const hw_level *p = hw_get_level(c->sec_lvl);
+    static pipe_inputs in;
+    static uint64_t expect[8 * 320 / 8];
+
+    if (p == NULL || c->samplers == 0 || c->samplers > GEN_A_SAMPLERS_MAX || c->rounds == 0 ||
+        c->rounds > KECCAK_CORE_ROUNDS || c->axi_ready == 0 || c->axi_ready > 100)
+        return -1;
+
+    memset(r, 0, sizeof(*r));
+    inputs(&in);
+    expected(expect, &in, c, p);
+    switch (c->depth)
+    {
+    case 16:
+        run<16>(r, c, p, &in, expect);
+        break;
+    case 64:
+        run<64>(r, c, p, &in, expect);
+        break;
+    case 256:
+        run<256>(r, c, p, &in, expect);
+        break;
+    case 4096:
+        run<4096>(r, c, p, &in, expect);
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "hw_levels.h"
+#include "op_timing.h"
+
+/*
+ * The t1 path of keygen as stage models joined by the channels of
+ * channel.h:
+ *   gen_a_ext -> operation_module -> Power2Round -> encoder -> AXI
+ * gen_a_ext is the cycle model of gen_a_model.h, one channel per
+ * sampler. The operator takes a line of A per cycle into A * s1 row by
+ * row, multiply-accumulate over L at the MULT rate of tlm_timing, then
+ * the INTT with ntt2x2_invntt, then unloads a line per cycle.
+ * Power2Round is a delay_stage and the encoder follows encoder.v in
+ * ENCODE_T1 mode: two input registers and the 256-bit PISO. The AXI
+ * sink takes a word on `axi_ready` cycles out of 100.
+ * Neither rejection_a nor the encoder were built for backpressure:
+ * rejection_a drops samples when ready_o is low and the encoder has
+ * ready_i = 1, so its PISO overflows. The model keeps both and checks
+ * the words that come out against the same models run one after the
+ * other. `paced` gives the encoder a ready_i that holds when the PISO
+ * could overflow.
+ */
+
+typedef struct
+{
+    unsigned poly, addr; // A: k * L + l, t: k; BRAM line
+    data_t c[4];
+} pipe_line;
+
+typedef struct
+{
+    int sec_lvl;
+    unsigned samplers, rounds; // of gen_a_ext
+    unsigned depth;            // lines of each A channel: 16, 64, 256 or 4096 (all of A)
+    unsigned axi_ready;        // percent of cycles the AXI sink is ready
+    int paced;
+    tlm_timing t;
+} pipe_config;
+
+// Cycles a channel moved data, was full for its producer, empty for its consumer
+typedef struct
+{
+    unsigned long long transfers, full, empty;
+    double occupancy; // mean entries
+} pipe_channel_stats;
+
+enum
+{
+    PIPE_A,   // summed over the samplers
+    PIPE_T,   // operator to Power2Round
+    PIPE_T1,  // Power2Round to the encoder
+    PIPE_AXI, // encoder to the sink
+    PIPE_CHANNELS
+};
+
+typedef struct
+{
+    unsigned long long cycles, words;
+    unsigned long long op_busy, op_starved, op_blocked; // operation_module
+    unsigned long long sampler_blocked;                 // cycles a sampler held samples
+    unsigned long long enc_overflow;                    // lines the PISO had no room for
+    pipe_channel_stats ch[PIPE_CHANNELS];
+    int ok; // every word as expected
+} pipe_result;
+
+/*
+ * Run the pipeline on a fixed rho and s1 until the AXI sink has all
+ * K * T1 words, or stops getting any. Return -1 for a bad config.
+ */
+int pipe_run(pipe_result *r, const pipe_config *c);
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "combined_tlm.h"
+#include "op_sched.h"
+
+/*
+ * Makespan of keygen, verify and sign at each level when the polynomial
+ * operations are list scheduled on 1 to max-ops operators, next to the
+ * combined_top FSMs with their two operators as modeled by
+ * combined_tlm.h. Schedules run from the first sample to the last
+ * polynomial operation; the FSM column also has hashing and unloading.
+ * Sign is over `attempts` attempts, /attempt is what one more costs.
+ * -v prints every schedule.
+ * Usage: sched_explore [-v] [--level n] [--ports n] [--attempts n] [--max-ops n]
+ */
+
+#define MAX_OPS 16
+
+static const char *const mode_names[3] = {"keygen", "sign", "verify"};
+
+// Set *makespan, return -1 when the tasks cannot be scheduled
+static int schedule(sched_graph *g, const tlm_timing *t, const sched_config *c, enum tlm_mode mode,
+                    int sec_lvl, unsigned attempts, int verbose, unsigned *makespan)
+{
+    if (sched_build(g, t, mode, sec_lvl, attempts) || sched_run(g, c, makespan))
+    {
+        printf("Level %d %s, %u operators, %u ports: cannot be scheduled\n", sec_lvl, mode_names[mode],
+               c->operators, c->ports);
+        return -1;
+    }
+    if (verbose)
+    {
+        printf("Level %d %s, %u operators, %u ports: %u cycles\n", sec_lvl, mode_names[mode],
+               c->operators, c->ports, *makespan);
+        sched_print(stdout, g);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const int levels[3] = {2, 3, 5};
+    const enum tlm_mode modes[3] = {TLM_KEYGEN, TLM_VERIFY, TLM_SIGN};
+    unsigned attempts = 4, max_ops = 4, ports = 14; // combined_top has 7 dual-port BRAMs
+    int level = 0, verbose = 0;
+    tlm_timing t;
+    tlm_result r[2];
+    sched_graph g;
+    sched_config c;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+            verbose = 1;
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc)
+            level = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ports") == 0 && i + 1 < argc)
+            ports = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--attempts") == 0 && i + 1 < argc)
+            attempts = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-ops") == 0 && i + 1 < argc)
+            max_ops = atoi(argv[++i]);
+        else
+            level = -1;
+    }
+    // Every operation must fit in the ports at once, MULT holds the most
+    if (attempts < 2 || max_ops == 0 || max_ops > MAX_OPS || ports < SCHED_PORTS_MIN ||
+        (level && hw_get_level(level) == NULL))
+    {
+        printf("Usage: %s [-v] [--level n] [--ports n>=%d] [--attempts n>1] [--max-ops n]\n", argv[0],
+               SCHED_PORTS_MIN);
+        return 1;
+    }
+
+    tlm_timing_default(&t);
+    c.ports = ports;
+    printf("List schedules, %u BRAM ports, sign over %u attempts\n", ports, attempts);
+    printf("Level  mode         FSMs 2 ops");
+    for (unsigned o = 1; o <= max_ops; o++)
+        printf("  %5u op%s", o, o > 1 ? "s" : " ");
+    printf("\n");
+
+    for (int l = 0; l < 3; l++)
+    {
+        if (level && level != levels[l])
+            continue;
+        for (int m = 0; m < 3; m++)
+        {
+            unsigned tlm, makespan[MAX_OPS + 1], fewer;
+
+            if (modes[m] == TLM_KEYGEN)
+                tlm_keygen(&r[0], &t, levels[l]);
+            else if (modes[m] == TLM_VERIFY)
+                tlm_verify(&r[0], &t, levels[l], 33);
+            else
+                tlm_sign(&r[0], &t, levels[l], 33, attempts);
+            tlm = r[0].total;
+            for (c.operators = 1; c.operators <= max_ops; c.operators++)
+            {
+                if (schedule(&g, &t, &c, modes[m], levels[l], attempts, verbose, &makespan[c.operators]))
+                    return 1;
+            }
+            printf("%5d  %-10s %12u", levels[l], mode_names[modes[m]], tlm);
+            for (unsigned o = 1; o <= max_ops; o++)
+                printf("  %8u", makespan[o]);
+            printf("\n");
+            if (modes[m] != TLM_SIGN)
+                continue;
+
+            // One more attempt, and how busy the operators are
+            tlm_sign(&r[1], &t, levels[l], 33, attempts - 1);
+            printf("%5d  %-10s %12llu", levels[l], "/attempt", r[0].total - r[1].total);
+            for (c.operators = 1; c.operators <= max_ops; c.operators++)
+            {
+                if (schedule(&g, &t, &c, TLM_SIGN, levels[l], attempts - 1, 0, &fewer))
+                    return 1;
+                printf("  %8u", makespan[c.operators] - fewer);
+            }
+            sched_build(&g, &t, TLM_SIGN, levels[l], attempts);
+            printf("\n%5d  %-10s %12s", levels[l], "busy", "");
+            for (unsigned o = 1; o <= max_ops; o++)
+                printf("  %7.1f%%", 100.0 * sched_operator_cycles(&g) / ((double)makespan[o] * o));
+            printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "combined_tlm.h"
+#include "gen_a_model.h"
+
+/*
+ * Cycles of combined_top for keygen, sign and verify at each level, from
+ * the transaction-level model of combined_tlm.h. Sign is reported for
+ * one attempt, per extra attempt, and at the expected attempts of the
+ * level; -v adds the cycles spent in every FSM state.
+ * --tb prints the model for the KAT vectors of rtl_tb the way the
+ * testbenches print their runs, "KG2[0] completed in 4842 clock cycles".
+ * --check reads such lines from a file and fails when the model is off
+ * by more than TLM_TOLERANCE on one of them or when an operation and
+ * level has none. tlm_snapshot.txt is the model's own --tb output, a
+ * regression snapshot; only a simulation log checks it against the RTL.
+ * Usage: tlm_latency [-v] [--sampler-a n] [--rounds n] [--tb | --check file] [mlen]
+ */
+
+#define TLM_KAT_VECTORS 5  // NUM_TV of the testbenches
+#define TLM_TOLERANCE 0.05 // |model - file| / file
+
+static const int levels[3] = {2, 3, 5};
+static const char *const tags[3] = {"KG", "SG", "VY"}; // by enum tlm_mode
+
+// Sign attempts of the first KAT/ vectors, counted by sign_stats of software_code
+static const unsigned kat_attempts[3][TLM_KAT_VECTORS] = {
+    {1, 3, 3, 2, 3},
+    {2, 1, 3, 13, 4},
+    {23, 1, 1, 11, 3},
+};
+
+// KAT/mlen_*.txt
+static size_t kat_mlen(unsigned v)
+{
+    return 33 * (v + 1);
+}
+
+static double now_ms()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e3 + t.tv_nsec / 1e6;
+}
+
+// Model of the testbench run of KAT vector v at levels[l]
+static unsigned long long tb_cycles(const tlm_timing *t, enum tlm_mode mode, int l, unsigned v)
+{
+    tlm_result r;
+
+    if (mode == TLM_KEYGEN)
+        tlm_keygen(&r, t, levels[l]);
+    else if (mode == TLM_SIGN)
+        tlm_sign(&r, t, levels[l], kat_mlen(v), kat_attempts[l][v]);
+    else
+        tlm_verify(&r, t, levels[l], kat_mlen(v));
+    return r.total;
+}
+
+static void print_tb(const tlm_timing *t)
+{
+    for (int m = 0; m < 3; m++)
+    {
+        for (int l = 0; l < 3; l++)
+        {
+            for (unsigned v = 0; v < TLM_KAT_VECTORS; v++)
+                printf("%s%d[%u] completed in %llu clock cycles\n", tags[m], levels[l], v,
+                       tb_cycles(t, (enum tlm_mode)m, l, v));
+        }
+    }
+}
+
+// Return 0 when every line of `file` is within TLM_TOLERANCE and every operation and level has one
+static int check(const tlm_timing *t, const char *file)
+{
+    FILE *f = fopen(file, "r");
+    char line[256], tag[3];
+    int level, l, m, fails = 0;
+    unsigned v, seen[3] = {0, 0, 0};
+    unsigned long long ref, model;
+    double e;
+
+    if (f == NULL)
+    {
+        printf("%s: cannot open\n", file);
+        return 1;
+    }
+    printf("Model against %s, tolerance %.0f%%\n", file, 100 * TLM_TOLERANCE);
+    while (fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, " %2[A-Z]%d[%u] completed in %llu clock cycles", tag, &level, &v, &ref) != 4)
+            continue;
+        for (m = 0; m < 3 && strcmp(tag, tags[m]); m++)
+            ;
+        for (l = 0; l < 3 && level != levels[l]; l++)
+            ;
+        if (m == 3 || l == 3 || v >= TLM_KAT_VECTORS || ref == 0)
+        {
+            printf("  unknown run: %s", line);
+            fails++;
+            continue;
+        }
+        model = tb_cycles(t, (enum tlm_mode)m, l, v);
+        e = ((double)model - ref) / ref;
+        seen[m] |= 1 << l;
+        printf("  %s%d[%u] %8llu  model %8llu  %+6.1f%%%s\n", tags[m], levels[l], v, ref, model, 100 * e,
+               e > TLM_TOLERANCE || e < -TLM_TOLERANCE ? "  FAIL" : "");
+        fails += e > TLM_TOLERANCE || e < -TLM_TOLERANCE;
+    }
+    fclose(f);
+
+    for (m = 0; m < 3; m++)
+    {
+        for (l = 0; l < 3; l++)
+        {
+            if (!((seen[m] >> l) & 1))
+            {
+                printf("  %s%d: no run\n", tags[m], levels[l]);
+                fails++;
+            }
+        }
+    }
+    printf("%s\n", fails ? "FAIL" : "OK");
+    return fails != 0;
+}
+
+int main(int argc, char **argv)
+{
+    tlm_timing t;
+    tlm_result kg, sg[2], vy;
+    size_t mlen = 33;
+    int verbose = 0, tb = 0;
+    const char *reference = NULL;
+    double start, e;
+
+    tlm_timing_default(&t);
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0)
+            verbose = 1;
+        else if (strcmp(argv[i], "--tb") == 0)
+            tb = 1;
+        else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+            reference = argv[++i];
+        else if (strcmp(argv[i], "--sampler-a") == 0 && i + 1 < argc)
+            t.sampler_a = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+            t.keccak_rounds = atoi(argv[++i]);
+        else
+            mlen = atoi(argv[i]);
+    }
+    if (t.sampler_a == 0 || t.sampler_a > GEN_A_SAMPLERS_MAX || t.keccak_rounds == 0 ||
+        t.keccak_rounds > KECCAK_CORE_ROUNDS || (tb && reference))
+    {
+        printf("Usage: %s [-v] [--sampler-a n<=%d] [--rounds n<=%d] [--tb | --check file] [mlen]\n", argv[0],
+               GEN_A_SAMPLERS_MAX, KECCAK_CORE_ROUNDS);
+        return 1;
+    }
+    if (tb)
+    {
+        print_tb(&t);
+        return 0;
+    }
+    if (reference)
+        return check(&t, reference);
+
+    printf("combined_top model, mlen %zu, NTT %u, INTT %u, MULT %u, ADD %u cycles, "
+           "%u gen_a samplers, %u Keccak rounds per cycle\n",
+           mlen, t.ntt, t.intt, t.mult, t.add, t.sampler_a, t.keccak_rounds);
+    printf("Level   keygen    verify  sign x1  +attempt  attempts  expected\n");
+
+    start = now_ms();
+    for (int l = 0; l < 3; l++)
+    {
+        tlm_keygen(&kg, &t, levels[l]);
+        tlm_verify(&vy, &t, levels[l], mlen);
+        tlm_sign(&sg[0], &t, levels[l], mlen, 1);
+        tlm_sign(&sg[1], &t, levels[l], mlen, 2);
+        e = hw_get_level(levels[l])->attempts;
+
+        // Attempts after the first cost the same, FSM1 runs one ahead of FSM2
+        printf("%5d %8llu  %8llu %8llu  %8llu  %8.2f  %8.0f\n", levels[l], kg.total, vy.total,
+               sg[0].total, sg[1].total - sg[0].total, e,
+               sg[0].total + (e - 1) * (sg[1].total - sg[0].total));
+        if (verbose)
+        {
+            tlm_print(stdout, &kg);
+            tlm_print(stdout, &sg[0]);
+            tlm_print(stdout, &vy);
+        }
+    }
+    printf("Model time %.3f ms\n", now_ms() - start);
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "context.h"
+#include "parallel.h"
+#include "level.h"
+
+/*
+ * Per-thread scratch of keygen, sign and verify.
+ * Every polynomial temporary of crypto_sign_keypair_seed,
+ * crypto_sign_signature, crypto_sign_verify and of the context steps of
+ * context.h (_ctx, _mu, commit, respond) lives here instead of in their
+ * stack frames, and nothing is taken from the heap, so those flows do
+ * zero dynamic allocations.
+ *
+ * Sized at compile time: the one-shot flows share one region holding the
+ * level_scratch of the largest level, the context steps use regions sized
+ * by K_MAX x L_MAX. Each region starts on an ARENA_ALIGN boundary.
+ *
+ * Regions are owned by the routine named next to them; a routine never
+ * calls another one that owns the same region.
+ */
+#define ARENA_ALIGN 64
+
+typedef struct
+{
+    // crypto_sign_keypair_seed, crypto_sign_signature, crypto_sign_verify
+    alignas(ARENA_ALIGN) union
+    {
+        level_scratch<2> l2;
+        level_scratch<3> l3;
+        level_scratch<5> l5;
+    } level;
+    alignas(ARENA_ALIGN) commitment cm; // crypto_sign_signature_mu
+    alignas(ARENA_ALIGN) poly yhat[L_MAX]; // sign_commit
+    // sign_respond: z, r0, h. crypto_sign_verify_mu: z, w1, h
+    alignas(ARENA_ALIGN) poly z[L_MAX];
+    alignas(ARENA_ALIGN) poly w[K_MAX];
+    alignas(ARENA_ALIGN) poly h[K_MAX];
+} scratch_arena;
+
+// The arena of the calling thread
+scratch_arena *scratch_arena_get(void);
+
+/*
+ * Scratch of the batch routines, outside scratch_arena so that threads
+ * that never batch do not carry it. A thread allocates it on its first
+ * batch and frees it when it exits.
+ */
+typedef union alignas(ARENA_ALIGN)
+{
+    sign_batch_scratch sign;     // sign_batch
+    verify_batch_scratch verify; // verify_batch, per block
+} batch_arena;
+
+// The batch arena of the calling thread, NULL if it cannot be allocated
+batch_arena *batch_arena_get(void);
+
+// Its one-shot region, viewed for level LVL
+template <int LVL>
+level_scratch<LVL> *scratch_level_get(void)
+{
+    scratch_arena *a = scratch_arena_get();
+
+    if constexpr (LVL == 2)
+        return &a->level.l2;
+    else if constexpr (LVL == 3)
+        return &a->level.l3;
+    else
+        return &a->level.l5;
+}
+
+#endif
@@ -0,0 +1,231 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+#include "config.h"
+#include "sign.h"
+#include "context.h"
+#include "arena.h"
+
+#define TESTS 20
+
+/*
+ * Counting allocator: every heap entry point of the binary goes through
+ * here and is counted while `counting` is set.
+ */
+extern "C" void *__libc_malloc(size_t n);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t n);
+extern "C" void *__libc_memalign(size_t align, size_t n);
+
+static std::atomic<bool> counting(false);
+static std::atomic<size_t> allocs(0);
+
+static inline void count_alloc()
+{
+    if (counting.load(std::memory_order_relaxed))
+        allocs.fetch_add(1, std::memory_order_relaxed);
+}
+
+extern "C" void *malloc(size_t n)
+{
+    count_alloc();
+    return __libc_malloc(n);
+}
+
+extern "C" void *calloc(size_t n, size_t size)
+{
+    count_alloc();
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t n)
+{
+    count_alloc();
+    return __libc_realloc(ptr, n);
+}
+
+extern "C" void *aligned_alloc(size_t align, size_t n)
+{
+    count_alloc();
+    return __libc_memalign(align, n);
+}
+
+extern "C" int posix_memalign(void **ptr, size_t align, size_t n)
+{
+    count_alloc();
+    *ptr = __libc_memalign(align, n);
+    return *ptr ? 0 : 12; // ENOMEM
+}
+
+/*
+ * KG, sign and VY on every level, one-shot and with contexts,
+ * return the number of heap allocations they made
+ */
+static size_t count_flows(unsigned tests)
+{
+    const int levels[3] = {2, 3, 5};
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[BYTES_MAX];
+    uint8_t seed[SEEDBYTES], m[64];
+    static thread_local sign_ctx sctx;
+    static thread_local verify_ctx vctx;
+    size_t siglen;
+    int ret = 0;
+
+    allocs = 0;
+    counting = true;
+    for (unsigned t = 0; t < tests; t++)
+    {
+        for (int l = 0; l < 3; l++)
+        {
+            memset(seed, t, SEEDBYTES);
+            memset(m, t + l, sizeof(m));
+
+            ret |= crypto_sign_keypair_seed(pk, sk, seed, levels[l]);
+            ret |= crypto_sign_signature(sig, &siglen, m, sizeof(m), sk, levels[l]);
+            ret |= crypto_sign_verify(sig, siglen, m, sizeof(m), pk, levels[l]);
+
+            ret |= sign_ctx_init(&sctx, sk, levels[l]);
+            ret |= verify_ctx_init(&vctx, pk, levels[l]);
+            ret |= crypto_sign_signature_ctx(sig, &siglen, m, sizeof(m), &sctx);
+            ret |= crypto_sign_verify_ctx(sig, siglen, m, sizeof(m), &vctx);
+
+            sig[0] ^= 1;
+            ret |= crypto_sign_verify(sig, siglen, m, sizeof(m), pk, levels[l]) == 0;
+        }
+    }
+    counting = false;
+
+    // A failed flow must not pass as zero allocations
+    return ret ? (size_t)-1 : allocs.load();
+}
+
+static int test_counter()
+{
+    void *(*volatile alloc)(size_t) = malloc;
+    void *q;
+
+    allocs = 0;
+    counting = true;
+    q = alloc(16);
+    counting = false;
+    free(q);
+
+    return allocs != 1;
+}
+
+static int test_zero_heap()
+{
+    // Warm up: first touch of the arena and of anything lazy in libc
+    count_flows(1);
+    return count_flows(TESTS) != 0;
+}
+
+static int test_per_thread()
+{
+    scratch_arena *main_arena = scratch_arena_get(), *thread_arena = NULL;
+    size_t n = 0;
+
+    // Thread creation allocates, only the flows inside it are counted
+    std::thread worker([&]()
+                       {
+                           thread_arena = scratch_arena_get();
+                           n = count_flows(2);
+                       });
+    worker.join();
+
+    return n != 0 || thread_arena == main_arena ||
+           ((uintptr_t)main_arena | (uintptr_t)thread_arena) % ARENA_ALIGN != 0;
+}
+
+// One batch on a fresh context, return the heap allocations it made
+static size_t count_batch()
+{
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[2 * BYTES_MAX];
+    uint8_t seed[SEEDBYTES], m[2][64];
+    const uint8_t *msgs[2] = {m[0], m[1]};
+    const size_t mlen[2] = {sizeof(m[0]), sizeof(m[1])};
+    static thread_local sign_ctx ctx;
+    size_t siglen[2];
+    int ret = 0;
+
+    memset(seed, 1, SEEDBYTES);
+    memset(m, 2, sizeof(m));
+    ret |= crypto_sign_keypair_seed(pk, sk, seed, 2);
+    ret |= sign_ctx_init(&ctx, sk, 2);
+
+    allocs = 0;
+    counting = true;
+    ret |= sign_batch(sig, siglen, msgs, mlen, 2, &ctx);
+    counting = false;
+    return ret ? (size_t)-1 : allocs.load();
+}
+
+/*
+ * A thread takes the batch arena on its first batch and keeps it; the
+ * flows of count_flows never take it.
+ */
+static int test_batch_lazy()
+{
+    size_t flows = 0, first = 0, second = 0;
+
+    std::thread worker([&]()
+                       {
+                           flows = count_flows(1);
+                           first = count_batch();
+                           second = count_batch();
+                       });
+    worker.join();
+
+    return flows != 0 || first == 0 || first == (size_t)-1 || second != 0;
+}
+
+int main()
+{
+    int ret = 0;
+
+    printf("Test counting allocator :");
+    ret |= test_counter();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test KG/sign/VY zero heap allocations = %u :", TESTS);
+    ret |= test_zero_heap();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test one aligned arena per thread :");
+    ret |= test_per_thread();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test batch arena taken on the first batch only :");
+    ret |= test_batch_lazy();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Arena bytes per thread: %zu, batch arena %zu\n", sizeof(scratch_arena), sizeof(batch_arena));
+    return ret;
+}
@@ -0,0 +1,310 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+/*
+ * End-to-end keygen, sign and verify over the KAT/ vectors, per level.
+ * Every output is first checked against the KAT files, then each
+ * operation is replayed over all vectors: latency percentiles from the
+ * harness of ../bench.h, ops/s from wall clock over `rounds` passes, and
+ * the rejection-loop attempts per signature and rejects by reason, as
+ * counted by sign_stats.h.
+ * Usage: ./bench_kat [rounds] [out.json]
+ * Built as bench_kat_profile (make profile) it also dumps the per-phase
+ * histograms of profile.h over the whole run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "config.h"
+#include "sign.h"
+#include "context.h"
+#include "sign_stats.h"
+#include "kat.h"
+#include "profile.h"
+#include "../bench.h"
+
+#define MLEN_MAX 3300
+
+typedef struct
+{
+    uint8_t seed[SEEDBYTES];
+    uint8_t m[MLEN_MAX];
+    size_t mlen;
+    uint8_t pk[PUBLICKEYBYTES_MAX];
+    uint8_t sig[BYTES_MAX]; // c || zs || h from the KAT files
+} kat_entry;
+
+typedef struct
+{
+    int sec_lvl;
+    unsigned failures;
+    bench_result r[3];
+    double ops[3];
+    sign_stats stats; // of the checked signatures, one per vector
+} level_report;
+
+enum
+{
+    KEYGEN,
+    SIGN,
+    VERIFY
+};
+
+static const char *const op_names[3] = {"keygen", "sign", "verify"};
+
+static kat_entry kat[KAT_NUM];
+static uint8_t sks[KAT_NUM][SECRETKEYBYTES_MAX], sigs[KAT_NUM][BYTES_MAX];
+
+typedef struct
+{
+    int sec_lvl;
+    unsigned i;
+} replay;
+
+static int load_level(int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    uint8_t mlen[2];
+    uint8_t *s;
+    int ret = 0;
+
+    for (unsigned t = 0; t < KAT_NUM; t++)
+    {
+        s = kat[t].sig;
+        ret |= read_kat(kat[t].seed, SEEDBYTES, "z", sec_lvl, t) != SEEDBYTES;
+        ret |= read_kat(kat[t].m, MLEN_MAX, "m", sec_lvl, t) < 0;
+        ret |= read_kat(mlen, sizeof(mlen), "mlen", sec_lvl, t) != 2;
+        ret |= read_kat(kat[t].pk, SEEDBYTES, "rho", sec_lvl, t) != SEEDBYTES;
+        ret |= read_kat(kat[t].pk + SEEDBYTES, p->K * POLYT1_PACKEDBYTES, "t1", sec_lvl, t) < 0;
+        ret |= read_kat(s, SEEDBYTES, "c", sec_lvl, t) != SEEDBYTES;
+        s += SEEDBYTES;
+        ret |= read_kat(s, p->L * p->POLYZ_PACKEDBYTES, "zs", sec_lvl, t) < 0;
+        s += p->L * p->POLYZ_PACKEDBYTES;
+        ret |= read_kat(s, p->OMEGA + p->K, "h", sec_lvl, t) < 0;
+        kat[t].mlen = (mlen[0] << 8) | mlen[1];
+    }
+    return ret;
+}
+
+static void check_level(level_report *rep)
+{
+    const dilithium_params *p = get_params(rep->sec_lvl);
+    static sign_ctx ctx;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sig[BYTES_MAX];
+    size_t siglen;
+
+    sign_stats_reset();
+    for (unsigned t = 0; t < KAT_NUM; t++)
+    {
+        crypto_sign_keypair_seed(pk, sks[t], kat[t].seed, rep->sec_lvl);
+        crypto_sign_signature(sigs[t], &siglen, kat[t].m, kat[t].mlen, sks[t], rep->sec_lvl);
+
+        if (memcmp(pk, kat[t].pk, p->PUBLICKEYBYTES) ||
+            memcmp(sigs[t], kat[t].sig, p->BYTES) ||
+            crypto_sign_verify(sigs[t], siglen, kat[t].m, kat[t].mlen, pk, rep->sec_lvl))
+        {
+            rep->failures++;
+        }
+    }
+    sign_stats_get(rep->sec_lvl, &rep->stats);
+
+    // The context signer must give the same bytes, and times the FSM0_NTT_* and
+    // FSM2_NTT_C/FSM2_NTTI_* phases of a profiled build
+    for (unsigned t = 0; t < KAT_NUM; t++)
+    {
+        if (sign_ctx_init(&ctx, sks[t], rep->sec_lvl) ||
+            crypto_sign_signature_ctx(sig, &siglen, kat[t].m, kat[t].mlen, &ctx) ||
+            memcmp(sig, kat[t].sig, p->BYTES))
+        {
+            rep->failures++;
+        }
+    }
+}
+
+// One operation on vector i, then move to the next one
+static void run_keygen(void *arg)
+{
+    replay *r = (replay *)arg;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX];
+
+    crypto_sign_keypair_seed(pk, sk, kat[r->i].seed, r->sec_lvl);
+    r->i = (r->i + 1) % KAT_NUM;
+}
+
+static void run_sign(void *arg)
+{
+    replay *r = (replay *)arg;
+    uint8_t sig[BYTES_MAX];
+    size_t siglen;
+
+    crypto_sign_signature(sig, &siglen, kat[r->i].m, kat[r->i].mlen, sks[r->i], r->sec_lvl);
+    r->i = (r->i + 1) % KAT_NUM;
+}
+
+static void run_verify(void *arg)
+{
+    replay *r = (replay *)arg;
+
+    crypto_sign_verify(sigs[r->i], get_params(r->sec_lvl)->BYTES, kat[r->i].m, kat[r->i].mlen,
+                       kat[r->i].pk, r->sec_lvl);
+    r->i = (r->i + 1) % KAT_NUM;
+}
+
+static double now_s()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void time_level(level_report *rep, unsigned rounds)
+{
+    void (*const fn[3])(void *) = {run_keygen, run_sign, run_verify};
+    replay r = {rep->sec_lvl, 0};
+    double t;
+
+    for (unsigned op = 0; op < 3; op++)
+    {
+        // Latency, one warmup pass over the vectors
+        bench_run(&rep->r[op], op_names[op], fn[op], NULL, &r, KAT_NUM, rounds * KAT_NUM);
+
+        // Throughput
+        t = now_s();
+        for (unsigned i = 0; i < rounds * KAT_NUM; i++)
+        {
+            fn[op](&r);
+        }
+        rep->ops[op] = rounds * KAT_NUM / (now_s() - t);
+    }
+}
+
+static void print_level(const level_report *rep)
+{
+    printf("Level %d: %u KAT, %u failures\n", rep->sec_lvl, KAT_NUM, rep->failures);
+    for (unsigned op = 0; op < 3; op++)
+    {
+        printf("  %8.1f ops/s  ", rep->ops[op]);
+        bench_print(stdout, &rep->r[op]);
+    }
+    const sign_stats *s = &rep->stats;
+
+    printf("  sign attempts: mean %.2f, max %llu, histogram",
+           (double)s->attempts / s->signatures, (unsigned long long)s->attempts_max);
+    for (unsigned a = 1; a <= SIGN_STATS_ATTEMPTS_MAX; a++)
+    {
+        if (s->histogram[a - 1])
+            printf(" %u%s:%llu", a, a == SIGN_STATS_ATTEMPTS_MAX ? "+" : "",
+                   (unsigned long long)s->histogram[a - 1]);
+    }
+    printf("\n  rejected attempts: z %llu, r0 %llu, ct0 %llu, hint %llu\n",
+           (unsigned long long)s->rejects[SIGN_REJECT_Z], (unsigned long long)s->rejects[SIGN_REJECT_R0],
+           (unsigned long long)s->rejects[SIGN_REJECT_CT0], (unsigned long long)s->rejects[SIGN_REJECT_HINT]);
+}
+
+static void json_level(FILE *f, const level_report *rep, int last)
+{
+    const sign_stats *s = &rep->stats;
+
+    fprintf(f, "    {\"level\": %d, \"kat\": %u, \"failures\": %u,\n", rep->sec_lvl, KAT_NUM,
+            rep->failures);
+    for (unsigned op = 0; op < 3; op++)
+    {
+        fprintf(f, "     \"%s\": {\"ops_per_s\": %.1f, \"runs\": %u, \"min\": %llu, \"median\": %llu, \"p99\": %llu},\n",
+                op_names[op], rep->ops[op], rep->r[op].runs,
+                (unsigned long long)rep->r[op].min, (unsigned long long)rep->r[op].median,
+                (unsigned long long)rep->r[op].p99);
+    }
+    // histogram[a - 1] = signatures that took a attempts, the last entry a or more
+    fprintf(f, "     \"attempts\": {\"mean\": %.3f, \"max\": %llu, \"histogram\": [",
+            (double)s->attempts / s->signatures, (unsigned long long)s->attempts_max);
+    for (unsigned a = 1; a <= SIGN_STATS_ATTEMPTS_MAX; a++)
+    {
+        fprintf(f, "%llu%s", (unsigned long long)s->histogram[a - 1],
+                a < SIGN_STATS_ATTEMPTS_MAX ? ", " : "");
+    }
+    fprintf(f, "]},\n     \"rejects\": {\"z\": %llu, \"r0\": %llu, \"ct0\": %llu, \"hint\": %llu}}%s\n",
+            (unsigned long long)s->rejects[SIGN_REJECT_Z], (unsigned long long)s->rejects[SIGN_REJECT_R0],
+            (unsigned long long)s->rejects[SIGN_REJECT_CT0], (unsigned long long)s->rejects[SIGN_REJECT_HINT],
+            last ? "" : ",");
+}
+
+int main(int argc, char **argv)
+{
+    const int levels[3] = {2, 3, 5};
+    static level_report rep[3];
+    unsigned rounds = 5;
+    const char *json = NULL;
+    FILE *f;
+    int cpu, ret = 0;
+
+    if (argc > 1)
+        rounds = atoi(argv[1]);
+    if (argc > 2)
+        json = argv[2];
+    if (rounds == 0)
+        rounds = 1;
+
+    cpu = bench_pin(-1);
+    printf("KAT replay, %u rounds, pinned to CPU %d, latency in %s\n", rounds, cpu, bench_unit());
+
+    for (int l = 0; l < 3; l++)
+    {
+        rep[l].sec_lvl = levels[l];
+        if (load_level(levels[l]))
+        {
+            printf("Cannot read KAT level %d from %s\n", levels[l], KAT_DIR);
+            return 1;
+        }
+        check_level(&rep[l]);
+        time_level(&rep[l], rounds);
+        print_level(&rep[l]);
+        ret |= rep[l].failures != 0;
+    }
+
+    if (json)
+    {
+        f = fopen(json, "w");
+        if (f == NULL)
+        {
+            printf("Cannot write %s\n", json);
+            return 1;
+        }
+        fprintf(f, "{\n  \"suite\": \"kat\",\n  \"unit\": \"%s\",\n  \"cpu\": %d,\n  \"rounds\": %u,\n  \"levels\": [\n",
+                bench_unit(), cpu, rounds);
+        for (int l = 0; l < 3; l++)
+        {
+            json_level(f, &rep[l], l == 2);
+        }
+        fprintf(f, "  ]\n}\n");
+        fclose(f);
+    }
+#ifdef DILITHIUM_PROFILE
+    profile_dump(stdout);
+#endif
+    return ret;
+}
@@ -0,0 +1,140 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+/*
+ * Single-operation latency against thread count, row-parallel sign and
+ * verify at levels 2, 3 and 5, and verify_batch throughput over BATCH
+ * signatures under BATCH_KEYS keys.
+ * Usage: ./bench_threads [max_threads] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "sign.h"
+#include "context.h"
+#include "thread_pool.h"
+#include "parallel.h"
+
+#define BATCH 256
+#define BATCH_KEYS 4
+
+static sign_ctx sctx, bctx[BATCH_KEYS];
+static uint8_t bpk[BATCH_KEYS][PUBLICKEYBYTES_MAX], bsig[BATCH][BYTES_MAX], bmsg[BATCH][32];
+static verify_item items[BATCH];
+static int results[BATCH];
+static verify_ctx vctx;
+
+static double now_us()
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static double median(std::vector<double> &v)
+{
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+int main(int argc, char **argv)
+{
+    const int levels[3] = {2, 3, 5};
+    unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    unsigned iterations = 200;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[BYTES_MAX], m[32] = {0};
+    size_t siglen;
+    double t;
+    thread_pool *pool;
+
+    if (argc > 1)
+        max_threads = atoi(argv[1]);
+    if (argc > 2)
+        iterations = atoi(argv[2]);
+
+    printf("%5s %7s %12s %12s %14s\n", "level", "threads", "sign_us", "verify_us", "batch_vy/s");
+    for (int l = 0; l < 3; l++)
+    {
+        crypto_sign_keypair(pk, sk, levels[l]);
+        sign_ctx_init(&sctx, sk, levels[l]);
+        verify_ctx_init(&vctx, pk, levels[l]);
+
+        for (unsigned k = 0; k < BATCH_KEYS; k++)
+        {
+            crypto_sign_keypair(bpk[k], sk, levels[l]);
+            sign_ctx_init(&bctx[k], sk, levels[l]);
+        }
+        for (unsigned i = 0; i < BATCH; i++)
+        {
+            bmsg[i][0] = (uint8_t)i;
+            crypto_sign_signature_ctx(bsig[i], &siglen, bmsg[i], sizeof(bmsg[i]),
+                                      &bctx[i % BATCH_KEYS]);
+            items[i] = {bsig[i], siglen, bmsg[i], sizeof(bmsg[i]), bpk[i % BATCH_KEYS]};
+        }
+
+        for (unsigned n = 1; n <= max_threads; n *= 2)
+        {
+            std::vector<double> ts, tv;
+
+            pool = thread_pool_new(n - 1);
+            for (unsigned i = 0; i < iterations; i++)
+            {
+                m[0] = (uint8_t)i;
+                m[1] = (uint8_t)(i >> 8);
+
+                t = now_us();
+                crypto_sign_signature_par(sig, &siglen, m, sizeof(m), &sctx, pool);
+                ts.push_back(now_us() - t);
+
+                t = now_us();
+                if (crypto_sign_verify_par(sig, siglen, m, sizeof(m), &vctx, pool))
+                {
+                    printf("verify failed\n");
+                    return 1;
+                }
+                tv.push_back(now_us() - t);
+            }
+
+            t = now_us();
+            if (verify_batch(results, items, BATCH, levels[l], pool))
+            {
+                printf("verify_batch failed\n");
+                return 1;
+            }
+            t = now_us() - t;
+            thread_pool_free(pool);
+
+            printf("%5d %7u %12.1f %12.1f %14.0f\n", levels[l], n, median(ts), median(tv),
+                   BATCH / t * 1e6);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include "config.h"
+#include "fips202.h"
+#include "challenge.h"
+
+// 0xFFFFFFFF if a == b, 0 otherwise, for a, b < 2^31
+static inline data_t ct_mask_eq(uint32_t a, uint32_t b)
+{
+    return -(data_t)(((a ^ b) - 1) >> 31);
+}
+
+void sample_in_ball(poly *c, sparse_poly *sc, const uint8_t seed[SEEDBYTES],
+                    const dilithium_params *p)
+{
+    keccak_state state;
+    poly ctmp;
+    uint64_t signs;
+    unsigned pos, b, k;
+    data_t s, t, m;
+
+    if (c == NULL)
+    {
+        c = &ctmp;
+    }
+
+    shake256_init(&state);
+    shake256_absorb(&state, seed, SEEDBYTES);
+    shake256_finalize(&state);
+
+    // First 8 squeezed bytes are the sign bits, read from lane 0 directly
+    KeccakF1600_StatePermute(state.s);
+    signs = state.s[0];
+    pos = 8;
+
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        c->coeffs[i] = 0;
+    }
+
+    for (unsigned i = DILITHIUM_N - p->TAU; i < DILITHIUM_N; ++i)
+    {
+        // Rejection on b depends on the public hash only
+        do
+        {
+            if (pos >= SHAKE256_RATE)
+            {
+                KeccakF1600_StatePermute(state.s);
+                pos = 0;
+            }
+            b = keccak_byte(&state, pos++);
+        } while (b > i);
+
+        s = 1 - 2 * (data_t)(signs & 1);
+        signs >>= 1;
+
+        /*
+         * c[i] = c[b]; c[b] = s;
+         * Both accesses touch every coefficient up to i, so the memory
+         * trace does not depend on b.
+         */
+        t = 0;
+        for (unsigned j = 0; j < i; ++j)
+        {
+            m = ct_mask_eq(j, b);
+            t |= c->coeffs[j] & m;
+            c->coeffs[j] ^= (c->coeffs[j] ^ s) & m;
+        }
+        m = ct_mask_eq(i, b);
+        c->coeffs[i] = (t & ~m) | (s & m);
+    }
+
+    if (sc == NULL)
+    {
+        return;
+    }
+
+    // c is public from here on
+    sc->tau = p->TAU;
+    sc->signs = 0;
+    k = 0;
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        if (c->coeffs[i])
+        {
+            sc->pos[k] = (uint8_t)i;
+            sc->signs |= (uint64_t)(c->coeffs[i] < 0) << k;
+            ++k;
+        }
+    }
+}
+
+void poly_sparse_mul(poly *r, const sparse_poly *c, const poly *s)
+{
+    unsigned p;
+    data_t sgn;
+
+    for (unsigned j = 0; j < DILITHIUM_N; ++j)
+    {
+        r->coeffs[j] = 0;
+    }
+
+    for (unsigned k = 0; k < c->tau; ++k)
+    {
+        p = c->pos[k];
+        sgn = 1 - 2 * (data_t)((c->signs >> k) & 1);
+
+        // X^p * s, wrapping around with X^N = -1
+        for (unsigned j = p; j < DILITHIUM_N; ++j)
+        {
+            r->coeffs[j] += sgn * s->coeffs[j - p];
+        }
+        for (unsigned j = 0; j < p; ++j)
+        {
+            r->coeffs[j] -= sgn * s->coeffs[j + DILITHIUM_N - p];
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef CHALLENGE_H
+#define CHALLENGE_H
+
+#include <stdint.h>
+#include "config.h"
+
+/*
+ * Compact form of the challenge c: TAU coefficients are +-1, the rest 0.
+ * pos[k] is the position of the k-th nonzero coefficient, in ascending order,
+ * bit k of signs is set when that coefficient is -1.
+ */
+typedef struct
+{
+    uint8_t pos[TAU_MAX];
+    uint64_t signs;
+    unsigned tau;
+} sparse_poly;
+
+/*
+ * SampleInBall, same Fisher-Yates walk as gen_c.v (S_SAMPLEC).
+ * Input: seed (c tilde), p
+ * Output: c (dense, may be NULL), sc (sparse, may be NULL)
+ */
+void sample_in_ball(poly *c, sparse_poly *sc, const uint8_t seed[SEEDBYTES],
+                    const dilithium_params *p);
+
+/*
+ * r = c * s in Z[X]/(X^N + 1), without reduction mod q.
+ * |r| <= TAU * max|s|, which fits data_t for s1, s2, t0 and t1 * 2^D.
+ */
+void poly_sparse_mul(poly *r, const sparse_poly *c, const poly *s);
+
+#endif
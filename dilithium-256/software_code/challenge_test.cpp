@@ -0,0 +1,219 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "fips202.h"
+#include "sampler.h"
+#include "challenge.h"
+#include "kat.h"
+#include "../reference_code/ref_ntt.h"
+
+#define TESTS 10000
+
+/*
+ * SampleInBall from the specification, buffered and with direct swaps
+ */
+static void sample_in_ball_gold(poly *c, const uint8_t seed[SEEDBYTES], unsigned tau)
+{
+    keccak_state state;
+    uint8_t buf[SHAKE256_RATE];
+    uint64_t signs = 0;
+    unsigned pos, b;
+
+    shake256_init(&state);
+    shake256_absorb(&state, seed, SEEDBYTES);
+    shake256_finalize(&state);
+    shake256_squeezeblocks(buf, 1, &state);
+
+    for (unsigned i = 0; i < 8; ++i)
+        signs |= (uint64_t)buf[i] << 8 * i;
+    pos = 8;
+
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+        c->coeffs[i] = 0;
+
+    for (unsigned i = DILITHIUM_N - tau; i < DILITHIUM_N; ++i)
+    {
+        do
+        {
+            if (pos >= SHAKE256_RATE)
+            {
+                shake256_squeezeblocks(buf, 1, &state);
+                pos = 0;
+            }
+            b = buf[pos++];
+        } while (b > i);
+
+        c->coeffs[i] = c->coeffs[b];
+        c->coeffs[b] = 1 - 2 * (signs & 1);
+        signs >>= 1;
+    }
+}
+
+// c * s through the NTT of reference_code
+static void polymul_ntt(poly *r, const poly *c, const poly *s)
+{
+    data_t a[DILITHIUM_N], b[DILITHIUM_N];
+
+    for (int i = 0; i < DILITHIUM_N; i++)
+    {
+        a[i] = c->coeffs[i];
+        b[i] = s->coeffs[i];
+    }
+    ntt(a);
+    ntt(b);
+    pointwise_barrett(r->coeffs, a, b);
+    invntt(r->coeffs);
+}
+
+static int compare_poly_modq(const poly *a, const poly *b, const char *string)
+{
+    for (int i = 0; i < DILITHIUM_N; i++)
+    {
+        if ((a->coeffs[i] - b->coeffs[i]) % DILITHIUM_Q != 0)
+        {
+            printf("%s: [%d] %d != %d\n", string, i, a->coeffs[i], b->coeffs[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_challenge(const poly *c, const poly *c_gold, const sparse_poly *sc,
+                           unsigned tau)
+{
+    poly c_sparse = {{0}};
+
+    if (sc->tau != tau)
+        return 1;
+    for (unsigned k = 0; k < tau; k++)
+    {
+        if (k > 0 && sc->pos[k] <= sc->pos[k - 1])
+            return 1;
+        c_sparse.coeffs[sc->pos[k]] = 1 - 2 * (data_t)((sc->signs >> k) & 1);
+    }
+    for (int i = 0; i < DILITHIUM_N; i++)
+    {
+        if (c->coeffs[i] != c_gold->coeffs[i] || c->coeffs[i] != c_sparse.coeffs[i])
+        {
+            printf("[%d] %d, %d, %d\n", i, c_gold->coeffs[i], c->coeffs[i],
+                   c_sparse.coeffs[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Every c tilde in c_*.txt, with c * s1 for the matching key
+ */
+static int test_kat()
+{
+    const int levels[3] = {2, 3, 5};
+    uint8_t ctilde[SEEDBYTES], zeta[SEEDBYTES], seedbuf[2 * SEEDBYTES + CRHBYTES];
+    poly c, c_gold, s1[L_MAX], s2[K_MAX], r, r_gold;
+    sparse_poly sc;
+    const dilithium_params *p;
+
+    for (int l = 0; l < 3; l++)
+    {
+        p = get_params(levels[l]);
+        for (unsigned t = 0; t < KAT_NUM; t++)
+        {
+            if (read_kat(ctilde, SEEDBYTES, "c", p->sec_lvl, t) != SEEDBYTES ||
+                read_kat(zeta, SEEDBYTES, "z", p->sec_lvl, t) != SEEDBYTES)
+                return 1;
+
+            sample_in_ball(&c, &sc, ctilde, p);
+            sample_in_ball_gold(&c_gold, ctilde, p->TAU);
+            if (check_challenge(&c, &c_gold, &sc, p->TAU))
+            {
+                printf("SampleInBall level %d, KAT %u\n", p->sec_lvl, t);
+                return 1;
+            }
+
+            shake256(seedbuf, sizeof(seedbuf), zeta, SEEDBYTES);
+            expand_s(s1, s2, seedbuf + SEEDBYTES, p);
+            for (unsigned i = 0; i < p->L; i++)
+            {
+                poly_sparse_mul(&r, &sc, &s1[i]);
+                polymul_ntt(&r_gold, &c, &s1[i]);
+                if (compare_poly_modq(&r_gold, &r, "c * s1"))
+                    return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Random challenges against operands in the range of t0 and t1 * 2^D
+ */
+static int test_sparse_mul()
+{
+    const dilithium_params *p = get_params(5);
+    uint8_t seed[SEEDBYTES];
+    poly c, s, r, r_gold;
+    sparse_poly sc;
+
+    for (int j = 0; j < TESTS; j++)
+    {
+        for (int i = 0; i < SEEDBYTES; i++)
+            seed[i] = rand() & 0xFF;
+        sample_in_ball(&c, &sc, seed, p);
+
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            if (j & 1)
+                s.coeffs[i] = (rand() % (1 << 10)) << DILITHIUM_D;
+            else
+                s.coeffs[i] = (rand() % (1 << DILITHIUM_D)) - (1 << (DILITHIUM_D - 1));
+        }
+
+        poly_sparse_mul(&r, &sc, &s);
+        polymul_ntt(&r_gold, &c, &s);
+        if (compare_poly_modq(&r_gold, &r, "c * s"))
+            return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    int ret = 0;
+    srand(0);
+
+    printf("Test SampleInBall KAT :");
+    ret |= test_kat();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test sparse multiplication = %u :", TESTS);
+    ret |= test_sparse_mul();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    return ret;
+}
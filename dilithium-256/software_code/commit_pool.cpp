@@ -0,0 +1,232 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "randombytes.h"
+#include "context.h"
+#include "sign_stats.h"
+#include "commit_pool.h"
+
+/*
+ * `slots` holds capacity commitments allocated once. Indices move between
+ * `empty` and `ready`; a slot being computed or answered is in neither,
+ * so it is owned by exactly one thread and computed outside the lock.
+ */
+struct commit_pool
+{
+    const sign_ctx *ctx;
+    std::vector<commitment> slots;
+    std::vector<size_t> empty, ready;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::thread refill;
+    bool stop;
+    commit_pool_stats stats;
+};
+
+// Fresh randomness for every commitment, so y never repeats
+static void commit_random(commitment *cm, const sign_ctx *ctx)
+{
+    uint8_t rhoprime[CRHBYTES];
+
+    randombytes(rhoprime, CRHBYTES);
+    sign_commit(cm, rhoprime, 0, ctx);
+}
+
+commit_pool *commit_pool_new(const sign_ctx *ctx, size_t capacity)
+{
+    commit_pool *pool = new (std::nothrow) commit_pool;
+
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    try
+    {
+        pool->slots.resize(capacity);
+        pool->empty.reserve(capacity);
+        pool->ready.reserve(capacity);
+    }
+    catch (const std::bad_alloc &)
+    {
+        delete pool;
+        return NULL;
+    }
+    for (size_t i = capacity; i > 0; --i)
+    {
+        pool->empty.push_back(i - 1);
+    }
+    pool->ctx = ctx;
+    pool->stop = false;
+    pool->stats = commit_pool_stats();
+    return pool;
+}
+
+void commit_pool_free(commit_pool *pool)
+{
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->stop = true;
+    }
+    pool->wake.notify_all();
+    if (pool->refill.joinable())
+    {
+        pool->refill.join();
+    }
+    for (commitment &cm : pool->slots)
+    {
+        commitment_wipe(&cm);
+    }
+    delete pool;
+}
+
+size_t commit_pool_fill(commit_pool *pool, size_t n)
+{
+    size_t added = 0, slot;
+
+    while (added < n)
+    {
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            if (pool->empty.empty() || pool->stop)
+            {
+                break;
+            }
+            slot = pool->empty.back();
+            pool->empty.pop_back();
+        }
+
+        commit_random(&pool->slots[slot], pool->ctx);
+
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->ready.push_back(slot);
+        ++pool->stats.produced;
+        ++added;
+    }
+    return added;
+}
+
+static void refill_loop(commit_pool *pool)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(pool->lock);
+            pool->wake.wait(guard, [pool] { return pool->stop || !pool->empty.empty(); });
+            if (pool->stop)
+            {
+                return;
+            }
+        }
+        commit_pool_fill(pool, 1);
+    }
+}
+
+int commit_pool_start_refill(commit_pool *pool)
+{
+    std::lock_guard<std::mutex> guard(pool->lock);
+
+    if (pool->refill.joinable())
+    {
+        return -1;
+    }
+    pool->refill = std::thread(refill_loop, pool);
+    return 0;
+}
+
+size_t commit_pool_size(commit_pool *pool)
+{
+    std::lock_guard<std::mutex> guard(pool->lock);
+
+    return pool->ready.size();
+}
+
+void commit_pool_get_stats(commit_pool *pool, commit_pool_stats *stats)
+{
+    std::lock_guard<std::mutex> guard(pool->lock);
+
+    *stats = pool->stats;
+}
+
+int crypto_sign_signature_online(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen,
+                                 commit_pool *pool)
+{
+    const sign_ctx *ctx = pool->ctx;
+    uint8_t mu[CRHBYTES];
+    commitment local;
+    size_t slot;
+    bool pooled;
+    unsigned attempts = 0;
+    int rejected;
+
+    sign_mu(mu, m, mlen, ctx);
+
+    do
+    {
+        {
+            std::lock_guard<std::mutex> guard(pool->lock);
+            pooled = !pool->ready.empty();
+            if (pooled)
+            {
+                slot = pool->ready.back();
+                pool->ready.pop_back();
+                ++pool->stats.taken;
+            }
+            else
+            {
+                ++pool->stats.fallbacks;
+            }
+        }
+
+        if (pooled)
+        {
+            rejected = sign_respond(sig, &pool->slots[slot], mu, ctx);
+            commitment_wipe(&pool->slots[slot]);
+
+            {
+                std::lock_guard<std::mutex> guard(pool->lock);
+                pool->empty.push_back(slot);
+            }
+            pool->wake.notify_one();
+        }
+        else
+        {
+            commit_random(&local, ctx);
+            rejected = sign_respond(sig, &local, mu, ctx);
+            commitment_wipe(&local);
+        }
+        sign_stats_attempt(ctx->p->sec_lvl, (enum sign_reject)rejected);
+        attempts++;
+    } while (rejected);
+    sign_stats_signature(ctx->p->sec_lvl, attempts);
+
+    *siglen = ctx->p->BYTES;
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef COMMIT_POOL_H
+#define COMMIT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "context.h"
+
+/*
+ * Offline/online randomized signing.
+ * y, w = A * y, w1 and w0 do not depend on the message, so with a random
+ * rhoprime they can be computed ahead of time. The pool keeps at most
+ * `capacity` such commitments for one sign_ctx; the online signer only
+ * hashes mu || w1 and computes z, r0 and the hints.
+ * Every commitment is removed from the pool before use and never reused,
+ * rejected or not, and its slot is wiped before it goes back to the free
+ * list. When the pool is empty the online signer computes commitments
+ * itself.
+ * All functions may be called from any thread.
+ */
+
+typedef struct commit_pool commit_pool;
+
+typedef struct
+{
+    size_t produced;  // commitments computed offline
+    size_t taken;     // commitments consumed from the pool
+    size_t fallbacks; // commitments computed online, pool empty
+} commit_pool_stats;
+
+// ctx must outlive the pool, return NULL on allocation failure
+commit_pool *commit_pool_new(const sign_ctx *ctx, size_t capacity);
+
+// Stop the refill thread if any, then wipe and release every commitment
+void commit_pool_free(commit_pool *pool);
+
+// Offline phase: add up to n commitments, return how many were added
+size_t commit_pool_fill(commit_pool *pool, size_t n);
+
+/*
+ * Keep the pool topped up from a background thread, woken up each time
+ * a commitment is taken. Return 0 on success, -1 if already started.
+ */
+int commit_pool_start_refill(commit_pool *pool);
+
+size_t commit_pool_size(commit_pool *pool);
+
+void commit_pool_get_stats(commit_pool *pool, commit_pool_stats *stats);
+
+// Randomized signature of m with the key of the pool
+int crypto_sign_signature_online(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen,
+                                 commit_pool *pool);
+
+#endif
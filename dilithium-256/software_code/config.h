@@ -0,0 +1,107 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef SW_CONFIG_H
+#define SW_CONFIG_H
+
+#include <stddef.h>
+#include "../params.h"
+
+#define SEEDBYTES 32
+#define CRHBYTES 64
+#define DILITHIUM_D 13
+
+// Largest (K, L) over all security levels, used to size arrays
+#define K_MAX 8
+#define L_MAX 7
+#define TAU_MAX 60
+
+typedef struct
+{
+    data_t coeffs[DILITHIUM_N];
+} poly;
+
+/*
+ * Parameter set of one security level.
+ * Same selection as `sec_lvl` in combined_top.v
+ */
+struct dilithium_params
+{
+    int sec_lvl;
+    unsigned K;
+    unsigned L;
+    data_t ETA;
+    unsigned TAU;
+    data_t BETA;
+    data_t GAMMA1;
+    data_t GAMMA2;
+    unsigned OMEGA;
+
+    // Packed sizes in bytes
+    unsigned POLYETA_PACKEDBYTES;
+    unsigned POLYZ_PACKEDBYTES;
+    unsigned POLYW1_PACKEDBYTES;
+    unsigned PUBLICKEYBYTES;
+    unsigned SECRETKEYBYTES;
+    unsigned BYTES;
+};
+
+#define POLYT1_PACKEDBYTES 320
+#define POLYT0_PACKEDBYTES 416
+#define POLYW1_PACKEDBYTES_MAX 192 // w1 of level 2, 6 bits
+
+#define PUBLICKEYBYTES_MAX (SEEDBYTES + K_MAX * POLYT1_PACKEDBYTES)
+#define SECRETKEYBYTES_MAX 4864
+#define BYTES_MAX 4595
+
+static constexpr dilithium_params dilithium_params_2 = {
+    2, 4, 4, 2, 39, 78, (1 << 17), (DILITHIUM_Q - 1) / 88, 80,
+    96, 576, 192, 1312, 2528, 2420};
+
+static constexpr dilithium_params dilithium_params_3 = {
+    3, 6, 5, 4, 49, 196, (1 << 19), (DILITHIUM_Q - 1) / 32, 55,
+    128, 640, 128, 1952, 4000, 3293};
+
+static constexpr dilithium_params dilithium_params_5 = {
+    5, 8, 7, 2, 60, 120, (1 << 19), (DILITHIUM_Q - 1) / 32, 75,
+    96, 640, 128, 2592, 4864, 4595};
+
+/*
+ * Return the parameter set of sec_lvl, NULL if sec_lvl is not 2, 3 or 5
+ */
+static inline const dilithium_params *get_params(int sec_lvl)
+{
+    switch (sec_lvl)
+    {
+    case 2:
+        return &dilithium_params_2;
+    case 3:
+        return &dilithium_params_3;
+    case 5:
+        return &dilithium_params_5;
+    default:
+        return NULL;
+    }
+}
+
+#endif
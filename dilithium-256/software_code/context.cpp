@@ -0,0 +1,550 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "fips202.h"
+#include "sampler.h"
+#include "challenge.h"
+#include "rounding.h"
+#include "packing.h"
+#include "poly.h"
+#include "context.h"
+#include "arena.h"
+#include "profile.h"
+#include "sign_stats.h"
+
+void tr_state_init(keccak_state *state, const uint8_t tr[SEEDBYTES])
+{
+    shake256_init(state);
+    shake256_absorb(state, tr, SEEDBYTES);
+}
+
+// ================ VERIFY ========================
+
+int verify_ctx_init(verify_ctx *ctx, const uint8_t *pk, int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    uint8_t rho[SEEDBYTES];
+
+    if (p == NULL || pk == NULL)
+    {
+        return -1;
+    }
+
+    ctx->p = p;
+    shake256(ctx->tr, SEEDBYTES, pk, p->PUBLICKEYBYTES);
+    tr_state_init(&ctx->tr_state, ctx->tr);
+    unpack_pk(rho, ctx->t1hat, pk, p);
+    expand_a(ctx->mat, rho, p);
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        poly_shiftl(&ctx->t1hat[i]);
+    }
+    polyvec_ntt(ctx->t1hat, p->K);
+
+    return 0;
+}
+
+void verify_mu(uint8_t mu[CRHBYTES], const uint8_t *m, size_t mlen, const verify_ctx *ctx)
+{
+    keccak_state state = ctx->tr_state;
+
+    shake256_absorb(&state, m, mlen);
+    shake256_finalize(&state);
+    shake256_squeeze(mu, CRHBYTES, &state);
+}
+
+int crypto_sign_verify_ctx(const uint8_t *sig, size_t siglen,
+                           const uint8_t *m, size_t mlen,
+                           const verify_ctx *ctx)
+{
+    uint8_t mu[CRHBYTES];
+
+    verify_mu(mu, m, mlen, ctx);
+    return crypto_sign_verify_mu(sig, siglen, mu, ctx);
+}
+
+int crypto_sign_verify_mu(const uint8_t *sig, size_t siglen,
+                          const uint8_t mu[CRHBYTES], const verify_ctx *ctx)
+{
+    const dilithium_params *p = ctx->p;
+    uint8_t ctilde[SEEDBYTES], ctilde2[SEEDBYTES];
+    uint8_t w1_packed[K_MAX * POLYW1_PACKEDBYTES_MAX];
+    keccak_state state;
+    scratch_arena *ws = scratch_arena_get();
+    poly *z = ws->z, *h = ws->h, *w1 = ws->w;
+    poly c, cp;
+
+    if (siglen != p->BYTES)
+    {
+        return -1;
+    }
+
+    if (unpack_sig(ctilde, z, h, sig, p))
+    {
+        return -1;
+    }
+    if (polyvec_chknorm(z, p->L, p->GAMMA1 - p->BETA))
+    {
+        return -1;
+    }
+
+    sample_in_ball(&c, NULL, ctilde, p);
+    poly_ntt(&c);
+
+    // w' = invNTT(A * NTT(z) - NTT(c) * NTT(t1 * 2^D))
+    polyvec_ntt(z, p->L);
+    polyvec_matrix_mul(w1, ctx->mat, z, p);
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        poly_pointwise(&cp, &c, &ctx->t1hat[i]);
+        // Difference in (-2Q, 2Q), the first invNTT layer reduces it
+        poly_sub(&w1[i], &w1[i], &cp);
+        poly_invntt(&w1[i]);
+        poly_caddq(&w1[i]);
+
+        poly_use_hint(&w1[i], &w1[i], &h[i], p->GAMMA2);
+        polyw1_pack(w1_packed + i * p->POLYW1_PACKEDBYTES, &w1[i], p->GAMMA2);
+    }
+
+    shake256_init(&state);
+    shake256_absorb(&state, mu, CRHBYTES);
+    shake256_absorb(&state, w1_packed, p->K * p->POLYW1_PACKEDBYTES);
+    shake256_finalize(&state);
+    shake256_squeeze(ctilde2, SEEDBYTES, &state);
+
+    if (memcmp(ctilde, ctilde2, SEEDBYTES) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// ================ SIGN ========================
+
+int sign_ctx_init(sign_ctx *ctx, const uint8_t *sk, int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    uint8_t rho[SEEDBYTES];
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    ctx->p = p;
+    unpack_sk(rho, ctx->tr, ctx->key, ctx->t0hat, ctx->s1hat, ctx->s2hat, sk, p);
+    {
+        PROFILE_SCOPE(FSM0_NTT_S1);
+        polyvec_ntt(ctx->s1hat, p->L);
+    }
+    {
+        PROFILE_SCOPE(FSM0_NTT_S2);
+        polyvec_ntt(ctx->s2hat, p->K);
+    }
+    {
+        PROFILE_SCOPE(FSM0_NTT_T0);
+        polyvec_ntt(ctx->t0hat, p->K);
+    }
+    tr_state_init(&ctx->tr_state, ctx->tr);
+    expand_a(ctx->mat, rho, p);
+
+    return 0;
+}
+
+void sign_mu(uint8_t mu[CRHBYTES], const uint8_t *m, size_t mlen, const sign_ctx *ctx)
+{
+    keccak_state state = ctx->tr_state;
+
+    shake256_absorb(&state, m, mlen);
+    shake256_finalize(&state);
+    shake256_squeeze(mu, CRHBYTES, &state);
+}
+
+// w1 holds A * NTT(y) in NTT domain, split w into w1, w0 and pack w1
+static void commit_decompose(commitment *cm, const dilithium_params *p)
+{
+    polyvec_invntt(cm->w1, p->K);
+    polyvec_caddq(cm->w1, p->K);
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        poly_decompose(&cm->w1[i], &cm->w0[i], &cm->w1[i], p->GAMMA2);
+        polyw1_pack(cm->w1_packed + i * p->POLYW1_PACKEDBYTES, &cm->w1[i], p->GAMMA2);
+    }
+}
+
+void sign_commit(commitment *cm, const uint8_t rhoprime[CRHBYTES], uint16_t nonce,
+                 const sign_ctx *ctx)
+{
+    const dilithium_params *p = ctx->p;
+    poly *yhat = scratch_arena_get()->yhat;
+
+    // w = A * y
+    expand_mask(cm->y, rhoprime, nonce, p);
+
+    memcpy(yhat, cm->y, p->L * sizeof(poly));
+    polyvec_ntt(yhat, p->L);
+    polyvec_matrix_mul(cm->w1, ctx->mat, yhat, p);
+    commit_decompose(cm, p);
+}
+
+// r = c * s from the pointwise product of NTT(c) and NTT(s), exact since |c * s| < Q / 2
+static void poly_challenge_invntt(poly *r)
+{
+    poly_invntt(r);
+    poly_center(r);
+}
+
+int sign_respond(uint8_t *sig, const commitment *cm, const uint8_t mu[CRHBYTES],
+                 const sign_ctx *ctx)
+{
+    const dilithium_params *p = ctx->p;
+    uint8_t ctilde[SEEDBYTES];
+    unsigned n;
+    keccak_state state;
+    scratch_arena *ws = scratch_arena_get();
+    poly *z = ws->z, *r0 = ws->w, *h = ws->h;
+    poly c, cp;
+
+    // ctilde = H(mu || w1)
+    shake256_init(&state);
+    shake256_absorb(&state, mu, CRHBYTES);
+    shake256_absorb(&state, cm->w1_packed, p->K * p->POLYW1_PACKEDBYTES);
+    shake256_finalize(&state);
+    shake256_squeeze(ctilde, SEEDBYTES, &state);
+    sample_in_ball(&c, NULL, ctilde, p);
+    {
+        PROFILE_SCOPE(FSM2_NTT_C);
+        poly_ntt(&c);
+    }
+
+    // r0 = LowBits(w - c * s2), checked before z as in crypto_sign_signature_lvl
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        {
+            PROFILE_SCOPE(FSM2_MULT_CS2);
+            poly_pointwise(&cp, &c, &ctx->s2hat[i]);
+        }
+        {
+            PROFILE_SCOPE(FSM2_NTTI_CS2);
+            poly_challenge_invntt(&cp);
+        }
+        poly_sub(&r0[i], &cm->w0[i], &cp);
+        if (poly_chknorm(&r0[i], p->GAMMA2 - p->BETA))
+        {
+            return SIGN_REJECT_R0;
+        }
+    }
+
+    // z = y + c * s1
+    for (unsigned i = 0; i < p->L; ++i)
+    {
+        {
+            PROFILE_SCOPE(FSM2_MULTACC);
+            poly_pointwise(&cp, &c, &ctx->s1hat[i]);
+        }
+        {
+            PROFILE_SCOPE(FSM2_NTTI_Z);
+            poly_challenge_invntt(&cp);
+        }
+        poly_add(&z[i], &cm->y[i], &cp);
+        if (poly_chknorm(&z[i], p->GAMMA1 - p->BETA))
+        {
+            return SIGN_REJECT_Z;
+        }
+    }
+
+    // Hints for w - c * s2 + c * t0
+    n = 0;
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        {
+            PROFILE_SCOPE(FSM2_MULT_CT0);
+            poly_pointwise(&cp, &c, &ctx->t0hat[i]);
+        }
+        {
+            PROFILE_SCOPE(FSM2_NTTI_CT0);
+            poly_challenge_invntt(&cp);
+        }
+        if (poly_chknorm(&cp, p->GAMMA2))
+        {
+            return SIGN_REJECT_CT0;
+        }
+        poly_add(&r0[i], &r0[i], &cp);
+        n += poly_make_hint(&h[i], &r0[i], &cm->w1[i], p->GAMMA2);
+        if (n > p->OMEGA)
+        {
+            return SIGN_REJECT_HINT;
+        }
+    }
+
+    pack_sig(sig, ctilde, z, h, p);
+    return SIGN_ACCEPT;
+}
+
+void commitment_wipe(commitment *cm)
+{
+    memset(cm, 0, sizeof(*cm));
+    // The memset must happen even if cm is never read again
+    __asm__ __volatile__("" : : "r"(cm) : "memory");
+}
+
+void sign_rhoprime(uint8_t rhoprime[CRHBYTES], const uint8_t key[SEEDBYTES],
+                   const uint8_t mu[CRHBYTES])
+{
+    keccak_state state;
+
+    shake256_init(&state);
+    shake256_absorb(&state, key, SEEDBYTES);
+    shake256_absorb(&state, mu, CRHBYTES);
+    shake256_finalize(&state);
+    shake256_squeeze(rhoprime, CRHBYTES, &state);
+}
+
+int crypto_sign_signature_ctx(uint8_t *sig, size_t *siglen,
+                              const uint8_t *m, size_t mlen,
+                              const sign_ctx *ctx)
+{
+    uint8_t mu[CRHBYTES];
+
+    sign_mu(mu, m, mlen, ctx);
+    return crypto_sign_signature_mu(sig, siglen, mu, ctx);
+}
+
+int crypto_sign_signature_mu(uint8_t *sig, size_t *siglen,
+                             const uint8_t mu[CRHBYTES], const sign_ctx *ctx)
+{
+    const dilithium_params *p = ctx->p;
+    uint8_t rhoprime[CRHBYTES];
+    uint16_t nonce = 0;
+    unsigned attempts = 0;
+    int reason;
+    commitment *cm = &scratch_arena_get()->cm;
+
+    sign_rhoprime(rhoprime, ctx->key, mu);
+
+    do
+    {
+        sign_commit(cm, rhoprime, nonce, ctx);
+        nonce += p->L;
+        reason = sign_respond(sig, cm, mu, ctx);
+        sign_stats_attempt(p->sec_lvl, (enum sign_reject)reason);
+        attempts++;
+    } while (reason != SIGN_ACCEPT);
+    sign_stats_signature(p->sec_lvl, attempts);
+
+    *siglen = p->BYTES;
+    return 0;
+}
+
+// One message of sign_batch in flight
+typedef struct
+{
+    size_t msg;
+    uint16_t nonce;
+    unsigned attempts;
+    uint8_t mu[CRHBYTES];
+    uint8_t rhoprime[CRHBYTES];
+} batch_slot;
+
+static void batch_slot_start(batch_slot *slot, size_t msg, const uint8_t *m, size_t mlen,
+                             const sign_ctx *ctx)
+{
+    slot->msg = msg;
+    slot->nonce = 0;
+    slot->attempts = 0;
+    sign_mu(slot->mu, m, mlen, ctx);
+    sign_rhoprime(slot->rhoprime, ctx->key, slot->mu);
+}
+
+/*
+ * y of every slot, the (slot, column) pairs taken four at a time so the
+ * four-way Keccak stays full across messages
+ */
+static void batch_expand_mask(sign_batch_scratch *ws, const batch_slot *slot, unsigned live,
+                              const dilithium_params *p)
+{
+    poly spare;
+    poly *a[4];
+    const uint8_t *seed[4];
+    uint16_t nonce[4];
+    unsigned k = 0, b, j;
+
+    for (unsigned n = 0; n < ((live * p->L + 3) & ~3u); n++)
+    {
+        b = n / p->L;
+        j = n % p->L;
+        a[k] = (b < live) ? &ws->cm[b].y[j] : &spare;
+        seed[k] = slot[(b < live) ? b : 0].rhoprime;
+        nonce[k] = (uint16_t)(slot[(b < live) ? b : 0].nonce + j);
+        if (++k == 4)
+        {
+            poly_uniform_gamma1_4x(a, seed, nonce, p->GAMMA1);
+            k = 0;
+        }
+    }
+}
+
+// w[b] = A * NTT(y[b]), A[i][j] is read once per round
+static void batch_matrix_mul(sign_batch_scratch *ws, unsigned live, const sign_ctx *ctx)
+{
+    const dilithium_params *p = ctx->p;
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        memset(ws->acc, 0, sizeof(ws->acc));
+        for (unsigned j = 0; j < p->L; ++j)
+        {
+            const data_t *a = ctx->mat[i][j].coeffs;
+            for (unsigned b = 0; b < live; ++b)
+            {
+                for (unsigned x = 0; x < DILITHIUM_N; ++x)
+                {
+                    ws->acc[b][x] += (data2_t)a[x] * ws->yhat[b][j].coeffs[x];
+                }
+            }
+        }
+        for (unsigned b = 0; b < live; ++b)
+        {
+            for (unsigned x = 0; x < DILITHIUM_N; ++x)
+            {
+                ws->cm[b].w1[i].coeffs[x] = ws->acc[b][x] % DILITHIUM_Q;
+            }
+        }
+    }
+}
+
+int sign_batch(uint8_t *sig, size_t *siglen,
+               const uint8_t *const *m, const size_t *mlen, size_t n,
+               const sign_ctx *ctx)
+{
+    const dilithium_params *p = ctx->p;
+    batch_arena *arena = batch_arena_get();
+    sign_batch_scratch *ws;
+    batch_slot slot[SIGN_BLOCK];
+    unsigned live = 0;
+    size_t next = 0;
+    int reason;
+
+    if (arena == NULL)
+    {
+        return -1;
+    }
+    ws = &arena->sign;
+
+    while (live < SIGN_BLOCK && next < n)
+    {
+        batch_slot_start(&slot[live], next, m[next], mlen[next], ctx);
+        live++;
+        next++;
+    }
+
+    while (live > 0)
+    {
+        batch_expand_mask(ws, slot, live, p);
+        for (unsigned b = 0; b < live; ++b)
+        {
+            memcpy(ws->yhat[b], ws->cm[b].y, p->L * sizeof(poly));
+            polyvec_ntt(ws->yhat[b], p->L);
+        }
+        batch_matrix_mul(ws, live, ctx);
+
+        for (unsigned b = 0; b < live;)
+        {
+            commit_decompose(&ws->cm[b], p);
+            slot[b].nonce += p->L;
+            slot[b].attempts++;
+            reason = sign_respond(sig + slot[b].msg * p->BYTES, &ws->cm[b], slot[b].mu, ctx);
+            sign_stats_attempt(p->sec_lvl, (enum sign_reject)reason);
+            if (reason != SIGN_ACCEPT)
+            {
+                ++b;
+                continue;
+            }
+            sign_stats_signature(p->sec_lvl, slot[b].attempts);
+            siglen[slot[b].msg] = p->BYTES;
+
+            // Next message in this slot, or move the last live one here
+            if (next < n)
+            {
+                batch_slot_start(&slot[b], next, m[next], mlen[next], ctx);
+                next++;
+                ++b;
+            }
+            else
+            {
+                live--;
+                slot[b] = slot[live];
+                ws->cm[b] = ws->cm[live];
+            }
+        }
+    }
+    return 0;
+}
+
+// ================ STREAM ========================
+
+void sign_stream_init(sign_stream *s, const sign_ctx *ctx)
+{
+    s->state = ctx->tr_state;
+    s->ctx = ctx;
+}
+
+void sign_stream_update(sign_stream *s, const uint8_t *m, size_t mlen)
+{
+    shake256_absorb(&s->state, m, mlen);
+}
+
+int sign_stream_final(uint8_t *sig, size_t *siglen, sign_stream *s)
+{
+    uint8_t mu[CRHBYTES];
+
+    shake256_finalize(&s->state);
+    shake256_squeeze(mu, CRHBYTES, &s->state);
+    return crypto_sign_signature_mu(sig, siglen, mu, s->ctx);
+}
+
+void verify_stream_init(verify_stream *s, const verify_ctx *ctx)
+{
+    s->state = ctx->tr_state;
+    s->ctx = ctx;
+}
+
+void verify_stream_update(verify_stream *s, const uint8_t *m, size_t mlen)
+{
+    shake256_absorb(&s->state, m, mlen);
+}
+
+int verify_stream_final(const uint8_t *sig, size_t siglen, verify_stream *s)
+{
+    uint8_t mu[CRHBYTES];
+
+    shake256_finalize(&s->state);
+    shake256_squeeze(mu, CRHBYTES, &s->state);
+    return crypto_sign_verify_mu(sig, siglen, mu, s->ctx);
+}
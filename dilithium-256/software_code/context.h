@@ -0,0 +1,184 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "fips202.h"
+#include "sign_stats.h"
+
+/*
+ * Per-key precomputation.
+ * The VY flow of combined_top.v regenerates A from rho (VY_LOAD_RHO) and
+ * transforms t1 (VY_NTT_T1) on every signature, the sign flow decodes
+ * and transforms s1, s2, t0 (FSM0_DECODE_S1, FSM0_NTT_*). A context does
+ * that once per key.
+ */
+typedef struct
+{
+    const dilithium_params *p;
+    uint8_t tr[SEEDBYTES];
+    keccak_state tr_state;  // SHAKE256 with tr absorbed
+    poly mat[K_MAX][L_MAX]; // A, NTT domain
+    poly t1hat[K_MAX];      // NTT(t1 * 2^D)
+} verify_ctx;
+
+/*
+ * mu = CRH(tr || M) continues from a copy of tr_state, so tr is absorbed
+ * once per key
+ */
+void tr_state_init(keccak_state *state, const uint8_t tr[SEEDBYTES]);
+
+// Return 0 on success, -1 on unsupported sec_lvl or NULL pk
+int verify_ctx_init(verify_ctx *ctx, const uint8_t *pk, int sec_lvl);
+
+// Same result as crypto_sign_verify with the public key of ctx
+int crypto_sign_verify_ctx(const uint8_t *sig, size_t siglen,
+                           const uint8_t *m, size_t mlen,
+                           const verify_ctx *ctx);
+
+// mu = CRH(tr || M)
+void verify_mu(uint8_t mu[CRHBYTES], const uint8_t *m, size_t mlen, const verify_ctx *ctx);
+
+// Verify against mu instead of the message
+int crypto_sign_verify_mu(const uint8_t *sig, size_t siglen,
+                          const uint8_t mu[CRHBYTES], const verify_ctx *ctx);
+
+/*
+ * A, s1, s2 and t0 in NTT domain, decoded and transformed once.
+ * Each attempt then takes one NTT(c), and c * s is a point-wise product
+ * and an invNTT per polynomial.
+ */
+typedef struct
+{
+    const dilithium_params *p;
+    uint8_t key[SEEDBYTES];
+    uint8_t tr[SEEDBYTES];
+    keccak_state tr_state; // SHAKE256 with tr absorbed
+    poly mat[K_MAX][L_MAX];
+    poly s1hat[L_MAX];
+    poly s2hat[K_MAX];
+    poly t0hat[K_MAX];
+} sign_ctx;
+
+// Return 0 on success, -1 on unsupported sec_lvl
+int sign_ctx_init(sign_ctx *ctx, const uint8_t *sk, int sec_lvl);
+
+// Same signature as crypto_sign_signature with the secret key of ctx
+int crypto_sign_signature_ctx(uint8_t *sig, size_t *siglen,
+                              const uint8_t *m, size_t mlen,
+                              const sign_ctx *ctx);
+
+// Deterministic signature of mu instead of the message
+int crypto_sign_signature_mu(uint8_t *sig, size_t *siglen,
+                             const uint8_t mu[CRHBYTES], const sign_ctx *ctx);
+
+/*
+ * One attempt of the rejection loop, split at the message:
+ * sign_commit samples y with `nonce` from rhoprime and computes w = A * y,
+ * sign_respond hashes mu || w1 and returns SIGN_ACCEPT (0) if (z, h) passed
+ * every check and sig was written, else the sign_reject of the failed check.
+ * It does not update sign_stats, the loop around it does.
+ * A commitment must never be answered twice.
+ */
+typedef struct
+{
+    poly y[L_MAX];
+    poly w0[K_MAX];
+    poly w1[K_MAX];
+    uint8_t w1_packed[K_MAX * POLYW1_PACKEDBYTES_MAX];
+} commitment;
+
+void sign_commit(commitment *cm, const uint8_t rhoprime[CRHBYTES], uint16_t nonce,
+                 const sign_ctx *ctx);
+
+/*
+ * Zero y, w0 and w1 once a commitment is answered or dropped: y with the
+ * signature it produced gives away s1. The compiler may not elide it.
+ */
+void commitment_wipe(commitment *cm);
+
+int sign_respond(uint8_t *sig, const commitment *cm, const uint8_t mu[CRHBYTES],
+                 const sign_ctx *ctx);
+
+// mu = CRH(tr || M)
+void sign_mu(uint8_t mu[CRHBYTES], const uint8_t *m, size_t mlen, const sign_ctx *ctx);
+
+// Deterministic rhoprime = CRH(key || mu), key as in sk
+void sign_rhoprime(uint8_t rhoprime[CRHBYTES], const uint8_t key[SEEDBYTES],
+                   const uint8_t mu[CRHBYTES]);
+
+/*
+ * Sign n messages m[i] of mlen[i] bytes with one context.
+ * Signature i is written at sig + i * p->BYTES, its length to siglen[i],
+ * the same bytes as crypto_sign_signature_ctx.
+ * SIGN_BLOCK messages are in flight at once: each round samples the y of
+ * all of them on the four-way Keccak and streams A once against all their
+ * NTT(y), then answers each commitment. A message that is accepted hands
+ * its slot to the next one.
+ * Return 0, -1 if the batch arena of arena.h cannot be allocated.
+ */
+#define SIGN_BLOCK 4
+
+typedef struct
+{
+    commitment cm[SIGN_BLOCK];
+    poly yhat[SIGN_BLOCK][L_MAX];
+    data2_t acc[SIGN_BLOCK][DILITHIUM_N];
+} sign_batch_scratch;
+
+int sign_batch(uint8_t *sig, size_t *siglen,
+               const uint8_t *const *m, const size_t *mlen, size_t n,
+               const sign_ctx *ctx);
+
+/*
+ * Streaming sign and verify.
+ * The message is absorbed piece by piece into CRH(tr || M), starting
+ * from tr_state of the context, so memory does not depend on its length.
+ * init, any number of update, then one final; final gives the same result
+ * as the one-shot call on the concatenated pieces.
+ */
+typedef struct
+{
+    keccak_state state;
+    const sign_ctx *ctx;
+} sign_stream;
+
+void sign_stream_init(sign_stream *s, const sign_ctx *ctx);
+void sign_stream_update(sign_stream *s, const uint8_t *m, size_t mlen);
+int sign_stream_final(uint8_t *sig, size_t *siglen, sign_stream *s);
+
+typedef struct
+{
+    keccak_state state;
+    const verify_ctx *ctx;
+} verify_stream;
+
+void verify_stream_init(verify_stream *s, const verify_ctx *ctx);
+void verify_stream_update(verify_stream *s, const uint8_t *m, size_t mlen);
+int verify_stream_final(const uint8_t *sig, size_t siglen, verify_stream *s);
+
+#endif
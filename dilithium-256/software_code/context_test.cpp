@@ -0,0 +1,312 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "sign.h"
+#include "context.h"
+#include "verify_cache.h"
+#include "commit_pool.h"
+#include "kat.h"
+
+#define KEYS 4
+#define MLEN 64
+#define BATCH 32
+#define POOL 4
+
+typedef struct
+{
+    uint8_t pk[PUBLICKEYBYTES_MAX];
+    uint8_t sk[SECRETKEYBYTES_MAX];
+    uint8_t m[MLEN];
+    uint8_t sig[BYTES_MAX];
+    size_t siglen;
+} signer;
+
+static int make_signers(signer *s, int sec_lvl)
+{
+    uint8_t zeta[SEEDBYTES];
+
+    for (unsigned i = 0; i < KEYS; i++)
+    {
+        if (read_kat(zeta, SEEDBYTES, "z", sec_lvl, i) != SEEDBYTES)
+            return 1;
+        crypto_sign_keypair_seed(s[i].pk, s[i].sk, zeta, sec_lvl);
+        for (unsigned j = 0; j < MLEN; j++)
+            s[i].m[j] = rand() & 0xFF;
+        crypto_sign_signature(s[i].sig, &s[i].siglen, s[i].m, MLEN, s[i].sk, sec_lvl);
+    }
+    return 0;
+}
+
+/*
+ * Cached verify of a good then a bad signature, round robin over KEYS signers.
+ * With room for KEYS - 1 contexts round robin misses every first call,
+ * with room for KEYS only the first round misses.
+ */
+static int test_verify_cache(int sec_lvl)
+{
+    static signer s[KEYS];
+    const dilithium_params *p = get_params(sec_lvl);
+    verify_cache *cache;
+    verify_cache_stats st;
+    verify_ctx ctx;
+    const unsigned rounds = 5;
+    int ret = 0;
+
+    if (make_signers(s, sec_lvl))
+        return 1;
+
+    for (unsigned room = KEYS - 1; room <= KEYS; room++)
+    {
+        cache = verify_cache_new(room * VERIFY_CACHE_ENTRY_BYTES);
+        for (unsigned r = 0; r < rounds; r++)
+        {
+            for (unsigned i = 0; i < KEYS; i++)
+            {
+                ret |= crypto_sign_verify_cached(cache, s[i].sig, s[i].siglen, s[i].m, MLEN,
+                                                 s[i].pk, sec_lvl) != 0;
+                // Signature of another key
+                ret |= crypto_sign_verify_cached(cache, s[(i + 1) % KEYS].sig, s[i].siglen,
+                                                 s[i].m, MLEN, s[i].pk, sec_lvl) == 0;
+            }
+        }
+        verify_cache_get_stats(cache, &st);
+        verify_cache_free(cache);
+
+        if (room < KEYS)
+            ret |= st.misses != rounds * KEYS || st.hits != rounds * KEYS || st.entries != room;
+        else
+            ret |= st.misses != KEYS || st.hits != (2 * rounds - 1) * KEYS || st.evictions != 0;
+        if (ret)
+        {
+            printf("room %u: hits %zu, misses %zu, evictions %zu, entries %zu\n",
+                   room, st.hits, st.misses, st.evictions, st.entries);
+            return 1;
+        }
+    }
+
+    // No budget, and the bare context
+    cache = verify_cache_new(0);
+    for (unsigned i = 0; i < KEYS; i++)
+    {
+        ret |= crypto_sign_verify_cached(cache, s[i].sig, s[i].siglen, s[i].m, MLEN,
+                                         s[i].pk, sec_lvl) != 0;
+        verify_ctx_init(&ctx, s[i].pk, sec_lvl);
+        ret |= crypto_sign_verify_ctx(s[i].sig, s[i].siglen, s[i].m, MLEN, &ctx) != 0;
+        s[i].m[0] ^= 1;
+        ret |= crypto_sign_verify_ctx(s[i].sig, s[i].siglen, s[i].m, MLEN, &ctx) == 0;
+        s[i].m[0] ^= 1;
+        ret |= crypto_sign_verify_ctx(s[i].sig, p->BYTES - 1, s[i].m, MLEN, &ctx) == 0;
+    }
+    verify_cache_get_stats(cache, &st);
+    verify_cache_free(cache);
+    ret |= st.entries != 0;
+
+    // Nothing is cached for an unsupported level or a missing key
+    cache = verify_cache_new(KEYS * VERIFY_CACHE_ENTRY_BYTES);
+    ret |= crypto_sign_verify_cached(cache, s[0].sig, s[0].siglen, s[0].m, MLEN, s[0].pk, 4) != -1;
+    ret |= crypto_sign_verify_cached(cache, s[0].sig, s[0].siglen, s[0].m, MLEN, NULL, sec_lvl) != -1;
+    verify_cache_get_stats(cache, &st);
+    verify_cache_free(cache);
+    ret |= st.entries != 0 || verify_ctx_init(&ctx, s[0].pk, 4) != -1;
+
+    return ret;
+}
+
+/*
+ * sign_batch with one context against one crypto_sign_signature per message
+ */
+static int test_sign_batch(int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    static uint8_t msg[BATCH][MLEN], sigs[BATCH * BYTES_MAX];
+    static sign_ctx ctx;
+    const uint8_t *m[BATCH];
+    size_t mlen[BATCH], siglen[BATCH], len;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[BYTES_MAX];
+    uint8_t zeta[SEEDBYTES];
+    int ret = 0;
+
+    if (read_kat(zeta, SEEDBYTES, "z", sec_lvl, 0) != SEEDBYTES)
+        return 1;
+    crypto_sign_keypair_seed(pk, sk, zeta, sec_lvl);
+
+    for (unsigned i = 0; i < BATCH; i++)
+    {
+        mlen[i] = rand() % (MLEN + 1);
+        for (unsigned j = 0; j < mlen[i]; j++)
+            msg[i][j] = rand() & 0xFF;
+        m[i] = msg[i];
+    }
+
+    ret |= sign_ctx_init(&ctx, sk, sec_lvl);
+    ret |= sign_batch(sigs, siglen, m, mlen, BATCH, &ctx);
+
+    for (unsigned i = 0; i < BATCH && !ret; i++)
+    {
+        crypto_sign_signature(sig, &len, m[i], mlen[i], sk, sec_lvl);
+        ret |= siglen[i] != len || memcmp(sig, sigs + i * p->BYTES, len);
+        ret |= crypto_sign_verify(sigs + i * p->BYTES, siglen[i], m[i], mlen[i], pk, sec_lvl);
+    }
+    return ret;
+}
+
+/*
+ * Online signing from a pool of POOL commitments: the first POOL attempts
+ * come from the pool, the rest fall back to online commitments, then the
+ * refill thread tops the pool up again.
+ */
+static int test_online(int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    static sign_ctx ctx;
+    commit_pool *pool;
+    commit_pool_stats st;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[BYTES_MAX], sig2[BYTES_MAX];
+    uint8_t zeta[SEEDBYTES], m[MLEN];
+    size_t siglen;
+    int ret = 0;
+
+    if (read_kat(zeta, SEEDBYTES, "z", sec_lvl, 1) != SEEDBYTES)
+        return 1;
+    crypto_sign_keypair_seed(pk, sk, zeta, sec_lvl);
+    sign_ctx_init(&ctx, sk, sec_lvl);
+
+    pool = commit_pool_new(&ctx, POOL);
+    ret |= commit_pool_fill(pool, 2 * POOL) != POOL;
+    ret |= commit_pool_size(pool) != POOL;
+
+    for (unsigned i = 0; i < 4 * POOL; i++)
+    {
+        for (unsigned j = 0; j < MLEN; j++)
+            m[j] = rand() & 0xFF;
+        ret |= crypto_sign_signature_online(sig, &siglen, m, MLEN, pool);
+        ret |= siglen != p->BYTES;
+        ret |= crypto_sign_verify(sig, siglen, m, MLEN, pk, sec_lvl) != 0;
+
+        // Randomized: signing again gives another valid signature
+        ret |= crypto_sign_signature_online(sig2, &siglen, m, MLEN, pool);
+        ret |= memcmp(sig, sig2, SEEDBYTES) == 0;
+        ret |= crypto_sign_verify(sig2, siglen, m, MLEN, pk, sec_lvl) != 0;
+    }
+    commit_pool_get_stats(pool, &st);
+    ret |= st.produced != POOL || st.taken != POOL || st.fallbacks < 8 * POOL - POOL;
+
+    ret |= commit_pool_start_refill(pool);
+    ret |= commit_pool_start_refill(pool) != -1;
+    for (unsigned t = 0; t < 10000 && commit_pool_size(pool) < POOL; t++)
+        usleep(1000);
+    ret |= commit_pool_size(pool) != POOL;
+
+    ret |= crypto_sign_signature_online(sig, &siglen, m, MLEN, pool);
+    ret |= crypto_sign_verify(sig, siglen, m, MLEN, pk, sec_lvl) != 0;
+    commit_pool_free(pool);
+
+    return ret;
+}
+
+/*
+ * Streaming sign/verify of the KAT messages cut into random pieces,
+ * against the one-shot calls and the KAT c
+ */
+static int test_stream(int sec_lvl)
+{
+    static uint8_t m[3300];
+    static sign_ctx ctx;
+    static verify_ctx vctx;
+    sign_stream ss;
+    verify_stream vs;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], zeta[SEEDBYTES], c[SEEDBYTES];
+    uint8_t sig[BYTES_MAX], gold[BYTES_MAX], len[2];
+    size_t mlen, siglen, goldlen, off, piece;
+    int ret = 0;
+
+    for (unsigned t = 0; t < 10 && !ret; t++)
+    {
+        if (read_kat(zeta, SEEDBYTES, "z", sec_lvl, t) != SEEDBYTES ||
+            read_kat(m, sizeof(m), "m", sec_lvl, t) < 0 ||
+            read_kat(len, 2, "mlen", sec_lvl, t) != 2 ||
+            read_kat(c, SEEDBYTES, "c", sec_lvl, t) != SEEDBYTES)
+            return 1;
+        mlen = (len[0] << 8) | len[1];
+
+        crypto_sign_keypair_seed(pk, sk, zeta, sec_lvl);
+        sign_ctx_init(&ctx, sk, sec_lvl);
+        verify_ctx_init(&vctx, pk, sec_lvl);
+        crypto_sign_signature_ctx(gold, &goldlen, m, mlen, &ctx);
+
+        // Pieces of 0 to 300 bytes, crossing the SHAKE256 rate at random
+        sign_stream_init(&ss, &ctx);
+        verify_stream_init(&vs, &vctx);
+        for (off = 0; off < mlen; off += piece)
+        {
+            piece = rand() % 301;
+            if (piece > mlen - off)
+                piece = mlen - off;
+            sign_stream_update(&ss, m + off, piece);
+            verify_stream_update(&vs, m + off, piece);
+        }
+        ret |= sign_stream_final(sig, &siglen, &ss);
+        ret |= siglen != goldlen || memcmp(sig, gold, goldlen) || memcmp(sig, c, SEEDBYTES);
+        ret |= verify_stream_final(sig, siglen, &vs) != 0;
+
+        // Missing last byte
+        verify_stream_init(&vs, &vctx);
+        verify_stream_update(&vs, m, mlen - 1);
+        ret |= verify_stream_final(sig, siglen, &vs) == 0;
+    }
+    return ret;
+}
+
+int main()
+{
+    const int levels[3] = {2, 3, 5};
+    int ret = 0;
+    srand(0);
+
+    for (int l = 0; l < 3; l++)
+    {
+        printf("Test verify context/cache level %d :", levels[l]);
+        ret |= test_verify_cache(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+
+        printf("Test sign_batch level %d = %u :", levels[l], BATCH);
+        ret |= test_sign_batch(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+
+        printf("Test offline/online sign level %d :", levels[l]);
+        ret |= test_online(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+
+        printf("Test streaming sign/verify level %d :", levels[l]);
+        ret |= test_stream(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+    }
+    return ret;
+}
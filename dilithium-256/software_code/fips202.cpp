@@ -0,0 +1,336 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include "fips202.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define ROL(a, offset) (((a) << (offset)) ^ ((a) >> (64 - (offset))))
+
+static const uint64_t KeccakF_RoundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+// Rho offsets and Pi destination lanes, walking the lanes from (1, 0)
+static const unsigned KeccakF_RhoOffsets[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+    27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+
+static const unsigned KeccakF_PiLane[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+    15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+void KeccakF1600_StatePermute(uint64_t state[KECCAK_LANES])
+{
+    uint64_t C[5], D, t, u;
+
+    for (unsigned round = 0; round < 24; round++)
+    {
+        // Theta
+        for (unsigned x = 0; x < 5; x++)
+        {
+            C[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
+        }
+        for (unsigned x = 0; x < 5; x++)
+        {
+            D = C[(x + 4) % 5] ^ ROL(C[(x + 1) % 5], 1);
+            for (unsigned y = 0; y < 25; y += 5)
+            {
+                state[y + x] ^= D;
+            }
+        }
+
+        // Rho and Pi
+        t = state[1];
+        for (unsigned i = 0; i < 24; i++)
+        {
+            u = state[KeccakF_PiLane[i]];
+            state[KeccakF_PiLane[i]] = ROL(t, KeccakF_RhoOffsets[i]);
+            t = u;
+        }
+
+        // Chi
+        for (unsigned y = 0; y < 25; y += 5)
+        {
+            for (unsigned x = 0; x < 5; x++)
+            {
+                C[x] = state[y + x];
+            }
+            for (unsigned x = 0; x < 5; x++)
+            {
+                state[y + x] = C[x] ^ ((~C[(x + 1) % 5]) & C[(x + 2) % 5]);
+            }
+        }
+
+        // Iota
+        state[0] ^= KeccakF_RoundConstants[round];
+    }
+}
+
+#ifdef __AVX2__
+
+static inline __m256i rol4x(__m256i a, unsigned offset)
+{
+    return _mm256_xor_si256(_mm256_sll_epi64(a, _mm_cvtsi32_si128(offset)),
+                            _mm256_srl_epi64(a, _mm_cvtsi32_si128(64 - offset)));
+}
+
+// Same steps as KeccakF1600_StatePermute, one 64-bit slot per state
+void KeccakF1600_StatePermute4x(keccak_state4x *state)
+{
+    __m256i A[KECCAK_LANES], C[5], D, t, u;
+
+    for (unsigned i = 0; i < KECCAK_LANES; i++)
+    {
+        A[i] = _mm256_load_si256((const __m256i *)state->s[i]);
+    }
+
+    for (unsigned round = 0; round < 24; round++)
+    {
+        // Theta
+        for (unsigned x = 0; x < 5; x++)
+        {
+            C[x] = _mm256_xor_si256(_mm256_xor_si256(A[x], A[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(A[x + 10], A[x + 15]), A[x + 20]));
+        }
+        for (unsigned x = 0; x < 5; x++)
+        {
+            D = _mm256_xor_si256(C[(x + 4) % 5], rol4x(C[(x + 1) % 5], 1));
+            for (unsigned y = 0; y < 25; y += 5)
+            {
+                A[y + x] = _mm256_xor_si256(A[y + x], D);
+            }
+        }
+
+        // Rho and Pi
+        t = A[1];
+        for (unsigned i = 0; i < 24; i++)
+        {
+            u = A[KeccakF_PiLane[i]];
+            A[KeccakF_PiLane[i]] = rol4x(t, KeccakF_RhoOffsets[i]);
+            t = u;
+        }
+
+        // Chi
+        for (unsigned y = 0; y < 25; y += 5)
+        {
+            for (unsigned x = 0; x < 5; x++)
+            {
+                C[x] = A[y + x];
+            }
+            for (unsigned x = 0; x < 5; x++)
+            {
+                A[y + x] = _mm256_xor_si256(C[x], _mm256_andnot_si256(C[(x + 1) % 5], C[(x + 2) % 5]));
+            }
+        }
+
+        // Iota
+        A[0] = _mm256_xor_si256(A[0], _mm256_set1_epi64x((long long)KeccakF_RoundConstants[round]));
+    }
+
+    for (unsigned i = 0; i < KECCAK_LANES; i++)
+    {
+        _mm256_store_si256((__m256i *)state->s[i], A[i]);
+    }
+}
+
+#else
+
+void KeccakF1600_StatePermute4x(keccak_state4x *state)
+{
+    uint64_t one[KECCAK_LANES];
+
+    for (unsigned k = 0; k < 4; k++)
+    {
+        for (unsigned i = 0; i < KECCAK_LANES; i++)
+        {
+            one[i] = state->s[i][k];
+        }
+        KeccakF1600_StatePermute(one);
+        for (unsigned i = 0; i < KECCAK_LANES; i++)
+        {
+            state->s[i][k] = one[i];
+        }
+    }
+}
+
+#endif
+
+static void keccak_init(keccak_state *state)
+{
+    for (unsigned i = 0; i < KECCAK_LANES; i++)
+    {
+        state->s[i] = 0;
+    }
+    state->pos = 0;
+}
+
+static void keccak_absorb(keccak_state *state, unsigned rate,
+                          const uint8_t *in, size_t inlen)
+{
+    unsigned pos = state->pos;
+
+    while (pos + inlen >= rate)
+    {
+        for (unsigned i = pos; i < rate; i++)
+        {
+            state->s[i / 8] ^= (uint64_t)*in++ << 8 * (i % 8);
+        }
+        inlen -= rate - pos;
+        KeccakF1600_StatePermute(state->s);
+        pos = 0;
+    }
+
+    for (unsigned i = pos; i < pos + inlen; i++)
+    {
+        state->s[i / 8] ^= (uint64_t)*in++ << 8 * (i % 8);
+    }
+    state->pos = pos + inlen;
+}
+
+static void keccak_finalize(keccak_state *state, unsigned rate, uint8_t p)
+{
+    state->s[state->pos / 8] ^= (uint64_t)p << 8 * (state->pos % 8);
+    state->s[rate / 8 - 1] ^= 1ULL << 63;
+    // Nothing left in the current block, the next squeeze permutes first
+    state->pos = rate;
+}
+
+static void keccak_squeeze(uint8_t *out, size_t outlen,
+                           keccak_state *state, unsigned rate)
+{
+    unsigned pos = state->pos;
+
+    while (outlen)
+    {
+        if (pos == rate)
+        {
+            KeccakF1600_StatePermute(state->s);
+            pos = 0;
+        }
+        for (; pos < rate && outlen; pos++, outlen--)
+        {
+            *out++ = keccak_byte(state, pos);
+        }
+    }
+    state->pos = pos;
+}
+
+static void keccak_squeezeblocks(uint8_t *out, size_t nblocks,
+                                 keccak_state *state, unsigned rate)
+{
+    while (nblocks)
+    {
+        KeccakF1600_StatePermute(state->s);
+        for (unsigned i = 0; i < rate; i++)
+        {
+            out[i] = keccak_byte(state, i);
+        }
+        out += rate;
+        --nblocks;
+    }
+    state->pos = rate;
+}
+
+// ================ SHAKE128 ========================
+
+void shake128_init(keccak_state *state)
+{
+    keccak_init(state);
+}
+
+void shake128_absorb(keccak_state *state, const uint8_t *in, size_t inlen)
+{
+    keccak_absorb(state, SHAKE128_RATE, in, inlen);
+}
+
+void shake128_finalize(keccak_state *state)
+{
+    keccak_finalize(state, SHAKE128_RATE, 0x1F);
+}
+
+void shake128_squeeze(uint8_t *out, size_t outlen, keccak_state *state)
+{
+    keccak_squeeze(out, outlen, state, SHAKE128_RATE);
+}
+
+void shake128_squeezeblocks(uint8_t *out, size_t nblocks, keccak_state *state)
+{
+    keccak_squeezeblocks(out, nblocks, state, SHAKE128_RATE);
+}
+
+void shake128(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen)
+{
+    keccak_state state;
+
+    shake128_init(&state);
+    shake128_absorb(&state, in, inlen);
+    shake128_finalize(&state);
+    shake128_squeeze(out, outlen, &state);
+}
+
+// ================ SHAKE256 ========================
+
+void shake256_init(keccak_state *state)
+{
+    keccak_init(state);
+}
+
+void shake256_absorb(keccak_state *state, const uint8_t *in, size_t inlen)
+{
+    keccak_absorb(state, SHAKE256_RATE, in, inlen);
+}
+
+void shake256_finalize(keccak_state *state)
+{
+    keccak_finalize(state, SHAKE256_RATE, 0x1F);
+}
+
+void shake256_squeeze(uint8_t *out, size_t outlen, keccak_state *state)
+{
+    keccak_squeeze(out, outlen, state, SHAKE256_RATE);
+}
+
+void shake256_squeezeblocks(uint8_t *out, size_t nblocks, keccak_state *state)
+{
+    keccak_squeezeblocks(out, nblocks, state, SHAKE256_RATE);
+}
+
+void shake256(uint8_t *out, size_t outlen, const uint8_t *in, size_t inlen)
+{
+    keccak_state state;
+
+    shake256_init(&state);
+    shake256_absorb(&state, in, inlen);
+    shake256_finalize(&state);
+    shake256_squeeze(out, outlen, &state);
+}
@@ -0,0 +1,85 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "kat.h"
+
+static int hex_value(int c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+int read_kat(uint8_t *out, size_t outlen, const char *name, int sec_lvl,
+             unsigned index)
+{
+    char path[256];
+    FILE *f;
+    int c, hi = -1, v;
+    size_t n = 0;
+    unsigned line = 0;
+
+    snprintf(path, sizeof(path), "%s%s_%d.txt", KAT_DIR, name, sec_lvl);
+    f = fopen(path, "r");
+    if (f == NULL)
+    {
+        printf("Cannot open %s\n", path);
+        return -1;
+    }
+
+    // Skip to the requested line
+    while (line < index && (c = fgetc(f)) != EOF)
+    {
+        if (c == '\n')
+            ++line;
+    }
+
+    while ((c = fgetc(f)) != EOF && c != '\n' && n < outlen)
+    {
+        v = hex_value(c);
+        if (v < 0)
+            continue;
+        if (hi < 0)
+        {
+            hi = v;
+        }
+        else
+        {
+            out[n++] = (uint8_t)((hi << 4) | v);
+            hi = -1;
+        }
+    }
+    fclose(f);
+
+    if (line != index)
+    {
+        return -1;
+    }
+    return (int)n;
+}
@@ -0,0 +1,45 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef KAT_H
+#define KAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Same files as read by $readmemh in rtl_tb
+#ifndef KAT_DIR
+#define KAT_DIR "../../KAT/"
+#endif
+
+#define KAT_NUM 100
+
+/*
+ * Read line `index` of KAT_DIR/<name>_<sec_lvl>.txt as hex bytes.
+ * Input: name, sec_lvl, index, outlen
+ * Output: out, return number of bytes read, -1 on error
+ */
+int read_kat(uint8_t *out, size_t outlen, const char *name, int sec_lvl,
+             unsigned index);
+
+#endif
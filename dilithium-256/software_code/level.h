@@ -0,0 +1,111 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "config.h"
+
+/*
+ * Security level as a compile-time constant.
+ * The values come from the tables of config.h, so the runtime
+ * get_params(sec_lvl) path and the level_traits<LVL> path cannot drift.
+ */
+template <int LVL>
+struct level_traits
+{
+    static_assert(LVL == 2 || LVL == 3 || LVL == 5, "sec_lvl must be 2, 3 or 5");
+
+    static constexpr const dilithium_params &P = (LVL == 2)   ? dilithium_params_2
+                                                 : (LVL == 3) ? dilithium_params_3
+                                                              : dilithium_params_5;
+    static constexpr unsigned K = P.K;
+    static constexpr unsigned L = P.L;
+    static constexpr data_t ETA = P.ETA;
+    static constexpr unsigned TAU = P.TAU;
+    static constexpr data_t BETA = P.BETA;
+    static constexpr data_t GAMMA1 = P.GAMMA1;
+    static constexpr data_t GAMMA2 = P.GAMMA2;
+    static constexpr unsigned OMEGA = P.OMEGA;
+
+    static constexpr unsigned POLYETA_PACKEDBYTES = P.POLYETA_PACKEDBYTES;
+    static constexpr unsigned POLYZ_PACKEDBYTES = P.POLYZ_PACKEDBYTES;
+    static constexpr unsigned POLYW1_PACKEDBYTES = P.POLYW1_PACKEDBYTES;
+    static constexpr unsigned PUBLICKEYBYTES = P.PUBLICKEYBYTES;
+    static constexpr unsigned SECRETKEYBYTES = P.SECRETKEYBYTES;
+    static constexpr unsigned BYTES = P.BYTES;
+
+    static_assert(K <= K_MAX && L <= L_MAX && TAU <= TAU_MAX, "K_MAX, L_MAX, TAU_MAX too small");
+    static_assert(GAMMA2 < GAMMA1, "sign checks r0 before z, the tighter bound first");
+};
+
+/*
+ * Scratch of the per-level flows of sign_level.h, arrays sized by the
+ * level instead of K_MAX x L_MAX
+ */
+template <int LVL>
+struct level_keygen_scratch
+{
+    poly mat[level_traits<LVL>::K][level_traits<LVL>::L];
+    poly s1[level_traits<LVL>::L];
+    poly s1hat[level_traits<LVL>::L];
+    poly s2[level_traits<LVL>::K];
+    poly t1[level_traits<LVL>::K];
+    poly t0[level_traits<LVL>::K];
+};
+
+template <int LVL>
+struct level_sign_scratch
+{
+    poly mat[level_traits<LVL>::K][level_traits<LVL>::L];
+    poly s1[level_traits<LVL>::L];
+    poly s2[level_traits<LVL>::K];
+    poly t0[level_traits<LVL>::K];
+    poly y[level_traits<LVL>::L];
+    poly yz[level_traits<LVL>::L]; // NTT(y), then z
+    poly w0[level_traits<LVL>::K]; // w0, then r0
+    poly w1[level_traits<LVL>::K];
+    poly h[level_traits<LVL>::K];
+    uint8_t w1_packed[level_traits<LVL>::K * level_traits<LVL>::POLYW1_PACKEDBYTES];
+};
+
+template <int LVL>
+struct level_verify_scratch
+{
+    poly mat[level_traits<LVL>::K][level_traits<LVL>::L];
+    poly t1hat[level_traits<LVL>::K];
+    poly z[level_traits<LVL>::L];
+    poly h[level_traits<LVL>::K];
+    poly w1[level_traits<LVL>::K];
+    uint8_t w1_packed[level_traits<LVL>::K * level_traits<LVL>::POLYW1_PACKEDBYTES];
+};
+
+template <int LVL>
+union level_scratch
+{
+    level_keygen_scratch<LVL> keygen;
+    level_sign_scratch<LVL> sign;
+    level_verify_scratch<LVL> verify;
+};
+
+#endif
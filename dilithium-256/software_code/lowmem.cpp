@@ -0,0 +1,288 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "fips202.h"
+#include "sampler.h"
+#include "challenge.h"
+#include "rounding.h"
+#include "packing.h"
+#include "poly.h"
+#include "context.h"
+#include "lowmem.h"
+#include "sign_stats.h"
+
+/*
+ * Everything else on the stack of one call: seeds, mu, the Keccak states
+ * of this file and of the samplers, the sparse challenge, call frames.
+ */
+#define LOWMEM_STACK_SLACK 3072
+
+typedef struct
+{
+    poly yhat[L_MAX]; // NTT(y), y itself is sampled again for z
+    poly w[K_MAX];    // A * y, decomposed when the hints are made
+    poly a, b, t;
+    uint8_t w1_packed[K_MAX * POLYW1_PACKEDBYTES_MAX];
+} lowmem_sign_ws;
+
+typedef struct
+{
+    poly zhat[L_MAX];
+    poly w, a, b, t;
+    uint8_t w1_packed[K_MAX * POLYW1_PACKEDBYTES_MAX];
+} lowmem_verify_ws;
+
+static_assert(sizeof(lowmem_sign_ws) + LOWMEM_STACK_SLACK <= LOWMEM_STACK_LIMIT,
+              "LOWMEM_STACK_LIMIT too small for the sign workspace");
+static_assert(sizeof(lowmem_verify_ws) + LOWMEM_STACK_SLACK <= LOWMEM_STACK_LIMIT,
+              "LOWMEM_STACK_LIMIT too small for the verify workspace");
+
+/*
+ * w = sum_j A[i][j] o v[j], A[i][j] sampled on the fly into a,
+ * then back to normal domain in [0, Q)
+ */
+static void row_mul(poly *w, poly *a, poly *b, const uint8_t rho[SEEDBYTES],
+                    unsigned i, const poly *v, const dilithium_params *p)
+{
+    for (unsigned j = 0; j < p->L; ++j)
+    {
+        poly_uniform(a, rho, (uint16_t)((i << 8) + j));
+        if (j == 0)
+        {
+            poly_pointwise(w, a, &v[0]);
+        }
+        else
+        {
+            // Each product in (-Q, Q), L of them fit data_t
+            poly_pointwise(b, a, &v[j]);
+            poly_add(w, w, b);
+        }
+    }
+    poly_reduce(w);
+    poly_invntt(w);
+    poly_caddq(w);
+}
+
+// mu = CRH(H(pk) || M), H(pk) is the tr stored in sk
+static void lowmem_mu(uint8_t mu[CRHBYTES], const uint8_t tr[SEEDBYTES],
+                      const uint8_t *m, size_t mlen)
+{
+    keccak_state state;
+
+    shake256_init(&state);
+    shake256_absorb(&state, tr, SEEDBYTES);
+    shake256_absorb(&state, m, mlen);
+    shake256_finalize(&state);
+    shake256_squeeze(mu, CRHBYTES, &state);
+}
+
+// ================ SIGN ========================
+
+/*
+ * One attempt with mask nonce `nonce`: SIGN_ACCEPT if sig was written,
+ * else the sign_reject of the failed check.
+ * Checks run row by row, so a reject may leave a partial sig behind, and
+ * a ct0 reject of row i is reported before an r0 reject of a later row.
+ */
+static int lowmem_attempt(uint8_t *sig, lowmem_sign_ws *ws, const uint8_t *sk,
+                          const uint8_t mu[CRHBYTES], const uint8_t rhoprime[CRHBYTES],
+                          uint16_t nonce, const dilithium_params *p)
+{
+    const uint8_t *rho = sk;
+    const uint8_t *s1 = sk + 3 * SEEDBYTES;
+    const uint8_t *s2 = s1 + p->L * p->POLYETA_PACKEDBYTES;
+    const uint8_t *t0 = s2 + p->K * p->POLYETA_PACKEDBYTES;
+    uint8_t *zs = sig + SEEDBYTES;
+    uint8_t *hs = zs + p->L * p->POLYZ_PACKEDBYTES;
+    unsigned n = 0, k = 0;
+    keccak_state state;
+    sparse_poly c;
+
+    // w = A * y
+    for (unsigned j = 0; j < p->L; ++j)
+    {
+        poly_uniform_gamma1(&ws->yhat[j], rhoprime, (uint16_t)(nonce + j), p->GAMMA1);
+        poly_ntt(&ws->yhat[j]);
+    }
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        row_mul(&ws->w[i], &ws->a, &ws->b, rho, i, ws->yhat, p);
+        poly_decompose(&ws->a, &ws->b, &ws->w[i], p->GAMMA2);
+        polyw1_pack(ws->w1_packed + i * p->POLYW1_PACKEDBYTES, &ws->a, p->GAMMA2);
+    }
+
+    // ctilde = H(mu || w1)
+    shake256_init(&state);
+    shake256_absorb(&state, mu, CRHBYTES);
+    shake256_absorb(&state, ws->w1_packed, p->K * p->POLYW1_PACKEDBYTES);
+    shake256_finalize(&state);
+    shake256_squeeze(sig, SEEDBYTES, &state);
+    sample_in_ball(NULL, &c, sig, p);
+
+    // z = y + c * s1, y sampled again instead of kept
+    for (unsigned j = 0; j < p->L; ++j)
+    {
+        poly_uniform_gamma1(&ws->a, rhoprime, (uint16_t)(nonce + j), p->GAMMA1);
+        polyeta_unpack(&ws->t, s1 + j * p->POLYETA_PACKEDBYTES, p->ETA);
+        poly_sparse_mul(&ws->b, &c, &ws->t);
+        poly_add(&ws->a, &ws->a, &ws->b);
+        if (poly_chknorm(&ws->a, p->GAMMA1 - p->BETA))
+        {
+            return SIGN_REJECT_Z;
+        }
+        polyz_pack(zs + j * p->POLYZ_PACKEDBYTES, &ws->a, p->GAMMA1);
+    }
+
+    // Per row: r0 = LowBits(w - c * s2), then the hint for r0 + c * t0
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        poly_decompose(&ws->a, &ws->b, &ws->w[i], p->GAMMA2);
+
+        polyeta_unpack(&ws->t, s2 + i * p->POLYETA_PACKEDBYTES, p->ETA);
+        poly_sparse_mul(&ws->w[i], &c, &ws->t);
+        poly_sub(&ws->b, &ws->b, &ws->w[i]);
+        if (poly_chknorm(&ws->b, p->GAMMA2 - p->BETA))
+        {
+            return SIGN_REJECT_R0;
+        }
+
+        polyt0_unpack(&ws->t, t0 + i * POLYT0_PACKEDBYTES);
+        poly_sparse_mul(&ws->w[i], &c, &ws->t);
+        if (poly_chknorm(&ws->w[i], p->GAMMA2))
+        {
+            return SIGN_REJECT_CT0;
+        }
+        poly_add(&ws->b, &ws->b, &ws->w[i]);
+
+        n += poly_make_hint(&ws->t, &ws->b, &ws->a, p->GAMMA2);
+        if (n > p->OMEGA)
+        {
+            return SIGN_REJECT_HINT;
+        }
+        k = pack_hint_row(hs, &ws->t, i, k, p);
+    }
+    return SIGN_ACCEPT;
+}
+
+int crypto_sign_signature_lowmem(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen,
+                                 const uint8_t *sk, int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    uint8_t mu[CRHBYTES], rhoprime[CRHBYTES];
+    uint16_t nonce = 0;
+    unsigned attempts = 1;
+    int reason;
+    lowmem_sign_ws ws;
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    // sk = rho || key || tr || s1 || s2 || t0
+    lowmem_mu(mu, sk + 2 * SEEDBYTES, m, mlen);
+
+    sign_rhoprime(rhoprime, sk + SEEDBYTES, mu);
+
+    while ((reason = lowmem_attempt(sig, &ws, sk, mu, rhoprime, nonce, p)) != SIGN_ACCEPT)
+    {
+        sign_stats_attempt(sec_lvl, (enum sign_reject)reason);
+        nonce += p->L;
+        attempts++;
+    }
+    sign_stats_attempt(sec_lvl, SIGN_ACCEPT);
+    sign_stats_signature(sec_lvl, attempts);
+
+    *siglen = p->BYTES;
+    return 0;
+}
+
+// ================ VERIFY ========================
+
+int crypto_sign_verify_lowmem(const uint8_t *sig, size_t siglen,
+                              const uint8_t *m, size_t mlen,
+                              const uint8_t *pk, int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    const uint8_t *zs = sig + SEEDBYTES, *hs;
+    uint8_t tr[SEEDBYTES], mu[CRHBYTES], ctilde2[SEEDBYTES];
+    keccak_state state;
+    sparse_poly c;
+    lowmem_verify_ws ws;
+
+    if (p == NULL || siglen != p->BYTES)
+    {
+        return -1;
+    }
+    hs = zs + p->L * p->POLYZ_PACKEDBYTES;
+
+    for (unsigned j = 0; j < p->L; ++j)
+    {
+        polyz_unpack(&ws.zhat[j], zs + j * p->POLYZ_PACKEDBYTES, p->GAMMA1);
+        if (poly_chknorm(&ws.zhat[j], p->GAMMA1 - p->BETA))
+        {
+            return -1;
+        }
+        poly_ntt(&ws.zhat[j]);
+    }
+
+    shake256(tr, SEEDBYTES, pk, p->PUBLICKEYBYTES);
+    lowmem_mu(mu, tr, m, mlen);
+    sample_in_ball(NULL, &c, sig, p);
+
+    // Row i of w' = A * z - c * t1 * 2^D, hint applied as soon as it is ready
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        row_mul(&ws.w, &ws.a, &ws.b, pk, i, ws.zhat, p);
+
+        polyt1_unpack(&ws.t, pk + SEEDBYTES + i * POLYT1_PACKEDBYTES);
+        poly_shiftl(&ws.t);
+        poly_sparse_mul(&ws.a, &c, &ws.t);
+        poly_sub(&ws.w, &ws.w, &ws.a);
+        poly_reduce(&ws.w);
+        poly_caddq(&ws.w);
+
+        if (unpack_hint_row(&ws.t, hs, i, p))
+        {
+            return -1;
+        }
+        poly_use_hint(&ws.w, &ws.w, &ws.t, p->GAMMA2);
+        polyw1_pack(ws.w1_packed + i * p->POLYW1_PACKEDBYTES, &ws.w, p->GAMMA2);
+    }
+
+    shake256_init(&state);
+    shake256_absorb(&state, mu, CRHBYTES);
+    shake256_absorb(&state, ws.w1_packed, p->K * p->POLYW1_PACKEDBYTES);
+    shake256_finalize(&state);
+    shake256_squeeze(ctilde2, SEEDBYTES, &state);
+
+    if (memcmp(sig, ctilde2, SEEDBYTES) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef LOWMEM_H
+#define LOWMEM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+/*
+ * Memory-minimal sign and verify.
+ * A is never stored: each A[i][j] is sampled from rho inside the
+ * multiply-accumulate of row i and dropped right after, as gen_a_ext.v
+ * feeds the point-wise unit. s1, s2, t0 and t1 are decoded one polynomial
+ * at a time straight from sk / pk, z and h are packed into sig row by row.
+ * Output is bit-identical to crypto_sign_signature / crypto_sign_verify,
+ * at the cost of sampling A again on every rejected attempt.
+ *
+ * LOWMEM_STACK_LIMIT bounds the stack of one call in bytes. The
+ * polynomial workspace is sized for K_MAX x L_MAX and checked against it
+ * at compile time; lowering the limit below what the workspace needs is
+ * a build error.
+ */
+#ifndef LOWMEM_STACK_LIMIT
+#define LOWMEM_STACK_LIMIT (24 * 1024)
+#endif
+
+int crypto_sign_signature_lowmem(uint8_t *sig, size_t *siglen,
+                                 const uint8_t *m, size_t mlen,
+                                 const uint8_t *sk, int sec_lvl);
+
+int crypto_sign_verify_lowmem(const uint8_t *sig, size_t siglen,
+                              const uint8_t *m, size_t mlen,
+                              const uint8_t *pk, int sec_lvl);
+
+#endif
@@ -0,0 +1,496 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "packing.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+// ================ AVX2 ========================
+
+/*
+ * 8 coefficients of `width` bits fill exactly `width` bytes, so a polynomial
+ * is 32 byte-aligned groups of one __m256i each.
+ * Pack merges bit fields 2 -> 4 -> 8 coefficients with 64-bit variable
+ * shifts; unpack gathers 4 bytes per coefficient with a byte shuffle and
+ * shifts them into place. width <= 20 everywhere.
+ */
+typedef struct
+{
+    __m256i w;             // pair of coefficients per 64-bit slot
+    __m256i sl, sr;        // pairs to 4 coefficients per 128-bit lane
+    __m256i lo;            // low lane, already in place
+    __m256i idx, keep;     // high lane moved to 64-bit slot 4w / 64
+    __m256i idx_c, keep_c; // same one slot up, for the bits crossing a slot
+    __m256i b, c;          // 4w % 64 and 64 - 4w % 64
+} pack_consts;
+
+// 64-bit slots `at` and `at + 1` take the high lane of q, the others are zero
+static inline void hi_lane_to_slot(__m256i *idx, __m256i *keep, unsigned at)
+{
+    if (at == 0)
+    {
+        *idx = _mm256_setr_epi32(4, 5, 6, 7, 0, 0, 0, 0);
+        *keep = _mm256_setr_epi64x(-1, -1, 0, 0);
+    }
+    else if (at == 1)
+    {
+        *idx = _mm256_setr_epi32(0, 0, 4, 5, 6, 7, 0, 0);
+        *keep = _mm256_setr_epi64x(0, -1, -1, 0);
+    }
+    else
+    {
+        *idx = _mm256_setr_epi32(0, 0, 0, 0, 4, 5, 6, 7);
+        *keep = _mm256_setr_epi64x(0, 0, -1, -1);
+    }
+}
+
+static inline void pack_consts_init(pack_consts *k, unsigned width)
+{
+    const long long w2 = 2 * width;
+
+    k->w = _mm256_set1_epi64x(width);
+    k->sl = _mm256_setr_epi64x(0, w2, 0, w2);
+    k->sr = _mm256_setr_epi64x(64, 64 - w2, 64, 64 - w2);
+    k->lo = _mm256_setr_epi64x(-1, -1, 0, 0);
+    hi_lane_to_slot(&k->idx, &k->keep, 4 * width / 64);
+    hi_lane_to_slot(&k->idx_c, &k->keep_c, 4 * width / 64 + 1);
+    k->b = _mm256_set1_epi64x(4 * width % 64);
+    k->c = _mm256_set1_epi64x(64 - 4 * width % 64);
+}
+
+// v holds 8 stored values, return them as a (8 * width)-bit little-endian string
+static inline __m256i pack_group(__m256i v, const pack_consts *k)
+{
+    const __m256i mask32 = _mm256_set1_epi64x(0xFFFFFFFF);
+    __m256i p, t, u, q, a, c;
+
+    // c0 | c1 << w in each 64-bit slot
+    p = _mm256_srli_epi64(v, 32);
+    p = _mm256_or_si256(_mm256_and_si256(v, mask32), _mm256_sllv_epi64(p, k->w));
+
+    // p0 | p1 << 2w in each 128-bit lane, up to 80 bits
+    t = _mm256_sllv_epi64(p, k->sl);
+    u = _mm256_srlv_epi64(p, k->sr);
+    q = _mm256_or_si256(t, _mm256_shuffle_epi32(t, 0x4E));
+    q = _mm256_blend_epi32(q, u, 0xCC);
+
+    // low lane | high lane << 4w
+    a = _mm256_and_si256(_mm256_permutevar8x32_epi32(q, k->idx), k->keep);
+    c = _mm256_and_si256(_mm256_permutevar8x32_epi32(q, k->idx_c), k->keep_c);
+    a = _mm256_or_si256(_mm256_sllv_epi64(a, k->b), _mm256_srlv_epi64(c, k->c));
+    return _mm256_or_si256(_mm256_and_si256(q, k->lo), a);
+}
+
+static inline void pack_poly(uint8_t *r, const poly *a, unsigned width,
+                             data_t offset, data_t sign)
+{
+    const __m256i off = _mm256_set1_epi32(offset);
+    pack_consts k;
+    uint8_t buf[32];
+    __m256i v;
+
+    pack_consts_init(&k, width);
+    for (unsigned g = 0; g < DILITHIUM_N / 8; ++g)
+    {
+        v = _mm256_loadu_si256((const __m256i *)&a->coeffs[8 * g]);
+        v = (sign < 0) ? _mm256_sub_epi32(off, v) : _mm256_add_epi32(v, off);
+        v = pack_group(v, &k);
+
+        // The 32-byte store spills over the next groups, which rewrite it
+        if (g * width + 32 <= DILITHIUM_N / 8 * width)
+        {
+            _mm256_storeu_si256((__m256i *)(r + g * width), v);
+        }
+        else
+        {
+            _mm256_storeu_si256((__m256i *)buf, v);
+            memcpy(r + g * width, buf, width);
+        }
+    }
+}
+
+static inline void unpack_poly(poly *r, const uint8_t *a, unsigned width,
+                               data_t offset, data_t sign)
+{
+    const __m256i off = _mm256_set1_epi32(offset);
+    const __m256i mask = _mm256_set1_epi32((1 << width) - 1);
+    uint8_t buf[32] = {0};
+    int8_t idx[32];
+    uint32_t sh[8];
+    unsigned bit;
+    const uint8_t *src;
+    __m256i x, vidx, vsh;
+
+    // Coefficients 4..7 are read from byte width / 2 = floor(4w / 8)
+    for (unsigned i = 0; i < 8; ++i)
+    {
+        bit = i * width;
+        sh[i] = bit % 8;
+        for (unsigned j = 0; j < 4; ++j)
+        {
+            idx[4 * i + j] = (int8_t)(bit / 8 - (i / 4) * (width / 2) + j);
+        }
+    }
+    vidx = _mm256_loadu_si256((const __m256i *)idx);
+    vsh = _mm256_loadu_si256((const __m256i *)sh);
+
+    for (unsigned g = 0; g < DILITHIUM_N / 8; ++g)
+    {
+        src = a + g * width;
+        // The two 16-byte loads read past the group, bounce the last ones
+        if (g * width + width / 2 + 16 > DILITHIUM_N / 8 * width)
+        {
+            memcpy(buf, src, width);
+            src = buf;
+        }
+        x = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src));
+        x = _mm256_inserti128_si256(x, _mm_loadu_si128((const __m128i *)(src + width / 2)), 1);
+        x = _mm256_shuffle_epi8(x, vidx);
+        x = _mm256_and_si256(_mm256_srlv_epi32(x, vsh), mask);
+        x = (sign < 0) ? _mm256_sub_epi32(off, x) : _mm256_sub_epi32(x, off);
+        _mm256_storeu_si256((__m256i *)&r->coeffs[8 * g], x);
+    }
+}
+
+#else
+
+// ================ SCALAR ========================
+
+/*
+ * Generic little-endian bit packer, stored value = offset + sign * a
+ */
+static inline void pack_poly(uint8_t *r, const poly *a, unsigned width,
+                             data_t offset, data_t sign)
+{
+    uint64_t acc = 0;
+    unsigned bits = 0;
+
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        acc |= (uint64_t)(uint32_t)(offset + sign * a->coeffs[i]) << bits;
+        bits += width;
+        while (bits >= 8)
+        {
+            *r++ = (uint8_t)acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+}
+
+static inline void unpack_poly(poly *r, const uint8_t *a, unsigned width,
+                               data_t offset, data_t sign)
+{
+    const uint64_t mask = (1ULL << width) - 1;
+    uint64_t acc = 0;
+    unsigned bits = 0;
+
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        while (bits < width)
+        {
+            acc |= (uint64_t)*a++ << bits;
+            bits += 8;
+        }
+        r->coeffs[i] = sign * ((data_t)(acc & mask) - offset);
+        acc >>= width;
+        bits -= width;
+    }
+}
+
+#endif
+
+void polyt1_pack(uint8_t *r, const poly *a)
+{
+    pack_poly(r, a, 10, 0, 1);
+}
+
+void polyt1_unpack(poly *r, const uint8_t *a)
+{
+    unpack_poly(r, a, 10, 0, 1);
+}
+
+void polyt0_pack(uint8_t *r, const poly *a)
+{
+    pack_poly(r, a, 13, 1 << (DILITHIUM_D - 1), -1);
+}
+
+void polyt0_unpack(poly *r, const uint8_t *a)
+{
+    unpack_poly(r, a, 13, 1 << (DILITHIUM_D - 1), -1);
+}
+
+void polyeta_pack(uint8_t *r, const poly *a, data_t eta)
+{
+    pack_poly(r, a, (eta == 2) ? 3 : 4, eta, -1);
+}
+
+void polyeta_unpack(poly *r, const uint8_t *a, data_t eta)
+{
+    unpack_poly(r, a, (eta == 2) ? 3 : 4, eta, -1);
+}
+
+void polyz_pack(uint8_t *r, const poly *a, data_t gamma1)
+{
+    pack_poly(r, a, (gamma1 == (1 << 17)) ? 18 : 20, gamma1, -1);
+}
+
+void polyz_unpack(poly *r, const uint8_t *a, data_t gamma1)
+{
+    unpack_poly(r, a, (gamma1 == (1 << 17)) ? 18 : 20, gamma1, -1);
+}
+
+void polyw1_pack(uint8_t *r, const poly *a, data_t gamma2)
+{
+    pack_poly(r, a, (gamma2 == (DILITHIUM_Q - 1) / 88) ? 6 : 4, 0, 1);
+}
+
+void polyw1_unpack(poly *r, const uint8_t *a, data_t gamma2)
+{
+    unpack_poly(r, a, (gamma2 == (DILITHIUM_Q - 1) / 88) ? 6 : 4, 0, 1);
+}
+
+// ================ KEYS ========================
+
+void pack_pk(uint8_t *pk, const uint8_t rho[SEEDBYTES], const poly t1[K_MAX],
+             const dilithium_params *p)
+{
+    memcpy(pk, rho, SEEDBYTES);
+    pk += SEEDBYTES;
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        polyt1_pack(pk + i * POLYT1_PACKEDBYTES, &t1[i]);
+    }
+}
+
+void unpack_pk(uint8_t rho[SEEDBYTES], poly t1[K_MAX], const uint8_t *pk,
+               const dilithium_params *p)
+{
+    memcpy(rho, pk, SEEDBYTES);
+    pk += SEEDBYTES;
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        polyt1_unpack(&t1[i], pk + i * POLYT1_PACKEDBYTES);
+    }
+}
+
+void pack_sk(uint8_t *sk, const uint8_t rho[SEEDBYTES], const uint8_t tr[SEEDBYTES],
+             const uint8_t key[SEEDBYTES], const poly t0[K_MAX],
+             const poly s1[L_MAX], const poly s2[K_MAX], const dilithium_params *p)
+{
+    memcpy(sk, rho, SEEDBYTES);
+    sk += SEEDBYTES;
+    memcpy(sk, key, SEEDBYTES);
+    sk += SEEDBYTES;
+    memcpy(sk, tr, SEEDBYTES);
+    sk += SEEDBYTES;
+
+    for (unsigned i = 0; i < p->L; ++i)
+    {
+        polyeta_pack(sk, &s1[i], p->ETA);
+        sk += p->POLYETA_PACKEDBYTES;
+    }
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        polyeta_pack(sk, &s2[i], p->ETA);
+        sk += p->POLYETA_PACKEDBYTES;
+    }
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        polyt0_pack(sk, &t0[i]);
+        sk += POLYT0_PACKEDBYTES;
+    }
+}
+
+void unpack_sk(uint8_t rho[SEEDBYTES], uint8_t tr[SEEDBYTES], uint8_t key[SEEDBYTES],
+               poly t0[K_MAX], poly s1[L_MAX], poly s2[K_MAX],
+               const uint8_t *sk, const dilithium_params *p)
+{
+    memcpy(rho, sk, SEEDBYTES);
+    sk += SEEDBYTES;
+    memcpy(key, sk, SEEDBYTES);
+    sk += SEEDBYTES;
+    memcpy(tr, sk, SEEDBYTES);
+    sk += SEEDBYTES;
+
+    for (unsigned i = 0; i < p->L; ++i)
+    {
+        polyeta_unpack(&s1[i], sk, p->ETA);
+        sk += p->POLYETA_PACKEDBYTES;
+    }
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        polyeta_unpack(&s2[i], sk, p->ETA);
+        sk += p->POLYETA_PACKEDBYTES;
+    }
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        polyt0_unpack(&t0[i], sk);
+        sk += POLYT0_PACKEDBYTES;
+    }
+}
+
+// ================ HINT ========================
+
+// Bit j of the result is set when h[j] != 0, for 64 coefficients
+static inline uint64_t hint_mask64(const data_t *h)
+{
+#ifdef __AVX2__
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t m = 0;
+    __m256i x;
+
+    for (unsigned j = 0; j < 64; j += 8)
+    {
+        x = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)&h[j]), zero);
+        m |= (uint64_t)(uint8_t)~_mm256_movemask_ps(_mm256_castsi256_ps(x)) << j;
+    }
+    return m;
+#else
+    uint64_t m = 0;
+
+    for (unsigned j = 0; j < 64; ++j)
+    {
+        m |= (uint64_t)(h[j] != 0) << j;
+    }
+    return m;
+#endif
+}
+
+unsigned pack_hint_row(uint8_t *r, const poly *h, unsigned i, unsigned k,
+                       const dilithium_params *p)
+{
+    uint64_t m;
+
+    if (i == 0)
+    {
+        memset(r, 0, p->OMEGA + p->K);
+    }
+    for (unsigned j = 0; j < DILITHIUM_N; j += 64)
+    {
+        m = hint_mask64(&h->coeffs[j]);
+        // A valid h has at most OMEGA ones, never write past them
+        while (m && k < p->OMEGA)
+        {
+            r[k++] = (uint8_t)(j + __builtin_ctzll(m));
+            m &= m - 1;
+        }
+    }
+    r[p->OMEGA + i] = (uint8_t)k;
+    return k;
+}
+
+void pack_hint(uint8_t *r, const poly h[K_MAX], const dilithium_params *p)
+{
+    unsigned k = 0;
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        k = pack_hint_row(r, &h[i], i, k, p);
+    }
+}
+
+int unpack_hint_row(poly *h, const uint8_t *r, unsigned i, const dilithium_params *p)
+{
+    const unsigned k = (i == 0) ? 0 : r[p->OMEGA + i - 1];
+
+    memset(h->coeffs, 0, sizeof(h->coeffs));
+
+    // Reject non-canonical hints: counts must grow, positions strictly increase
+    if (r[p->OMEGA + i] < k || r[p->OMEGA + i] > p->OMEGA)
+    {
+        return 1;
+    }
+
+    for (unsigned j = k; j < r[p->OMEGA + i]; ++j)
+    {
+        if (j > k && r[j] <= r[j - 1])
+        {
+            return 1;
+        }
+        h->coeffs[r[j]] = 1;
+    }
+
+    // Unused positions after the last row must be zero
+    if (i == p->K - 1)
+    {
+        for (unsigned j = r[p->OMEGA + i]; j < p->OMEGA; ++j)
+        {
+            if (r[j])
+            {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int unpack_hint(poly h[K_MAX], const uint8_t *r, const dilithium_params *p)
+{
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        if (unpack_hint_row(&h[i], r, i, p))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ================ SIGNATURE ========================
+
+void pack_sig(uint8_t *sig, const uint8_t c[SEEDBYTES], const poly z[L_MAX],
+              const poly h[K_MAX], const dilithium_params *p)
+{
+    memcpy(sig, c, SEEDBYTES);
+    sig += SEEDBYTES;
+
+    for (unsigned i = 0; i < p->L; ++i)
+    {
+        polyz_pack(sig, &z[i], p->GAMMA1);
+        sig += p->POLYZ_PACKEDBYTES;
+    }
+
+    pack_hint(sig, h, p);
+}
+
+int unpack_sig(uint8_t c[SEEDBYTES], poly z[L_MAX], poly h[K_MAX],
+               const uint8_t *sig, const dilithium_params *p)
+{
+    memcpy(c, sig, SEEDBYTES);
+    sig += SEEDBYTES;
+
+    for (unsigned i = 0; i < p->L; ++i)
+    {
+        polyz_unpack(&z[i], sig, p->GAMMA1);
+        sig += p->POLYZ_PACKEDBYTES;
+    }
+
+    return unpack_hint(h, sig, p);
+}
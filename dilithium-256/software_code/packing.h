@@ -0,0 +1,94 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef PACKING_H
+#define PACKING_H
+
+#include <stdint.h>
+#include "config.h"
+
+/*
+ * Bit-packed formats of pk, sk and signature, same layout as
+ * ENCODE_* in encoder.v and the KAT files:
+ * t1 10 bits, t0 13 bits, s1/s2 3 or 4 bits, z 18 or 20 bits, w1 6 or 4 bits.
+ * With AVX2, 8 coefficients at a time are packed into (unpacked from)
+ * `width` bytes with shifts and shuffles, otherwise a bit accumulator.
+ */
+
+void polyt1_pack(uint8_t *r, const poly *a);
+void polyt1_unpack(poly *r, const uint8_t *a);
+
+void polyt0_pack(uint8_t *r, const poly *a);
+void polyt0_unpack(poly *r, const uint8_t *a);
+
+void polyeta_pack(uint8_t *r, const poly *a, data_t eta);
+void polyeta_unpack(poly *r, const uint8_t *a, data_t eta);
+
+void polyz_pack(uint8_t *r, const poly *a, data_t gamma1);
+void polyz_unpack(poly *r, const uint8_t *a, data_t gamma1);
+
+void polyw1_pack(uint8_t *r, const poly *a, data_t gamma2);
+void polyw1_unpack(poly *r, const uint8_t *a, data_t gamma2);
+
+// pk = rho || t1
+void pack_pk(uint8_t *pk, const uint8_t rho[SEEDBYTES], const poly t1[K_MAX],
+             const dilithium_params *p);
+
+void unpack_pk(uint8_t rho[SEEDBYTES], poly t1[K_MAX], const uint8_t *pk,
+               const dilithium_params *p);
+
+// sk = rho || key || tr || s1 || s2 || t0
+void pack_sk(uint8_t *sk, const uint8_t rho[SEEDBYTES], const uint8_t tr[SEEDBYTES],
+             const uint8_t key[SEEDBYTES], const poly t0[K_MAX],
+             const poly s1[L_MAX], const poly s2[K_MAX], const dilithium_params *p);
+
+void unpack_sk(uint8_t rho[SEEDBYTES], uint8_t tr[SEEDBYTES], uint8_t key[SEEDBYTES],
+               poly t0[K_MAX], poly s1[L_MAX], poly s2[K_MAX],
+               const uint8_t *sk, const dilithium_params *p);
+
+/*
+ * Hint h: positions of the ones, zero padded to OMEGA bytes,
+ * then K bytes of running count per polynomial.
+ * unpack_hint returns 1 if the encoding is malformed, 0 otherwise.
+ */
+void pack_hint(uint8_t *r, const poly h[K_MAX], const dilithium_params *p);
+int unpack_hint(poly h[K_MAX], const uint8_t *r, const dilithium_params *p);
+
+/*
+ * Same format one polynomial at a time, rows in order 0 .. K-1.
+ * pack_hint_row takes and returns the number k of ones written so far,
+ * unpack_hint_row checks row i, and the zero padding after the last row.
+ */
+unsigned pack_hint_row(uint8_t *r, const poly *h, unsigned i, unsigned k,
+                       const dilithium_params *p);
+int unpack_hint_row(poly *h, const uint8_t *r, unsigned i, const dilithium_params *p);
+
+// sig = c || z || h
+void pack_sig(uint8_t *sig, const uint8_t c[SEEDBYTES], const poly z[L_MAX],
+              const poly h[K_MAX], const dilithium_params *p);
+
+// Return 1 if the hint encoding is malformed, 0 otherwise
+int unpack_sig(uint8_t c[SEEDBYTES], poly z[L_MAX], poly h[K_MAX],
+               const uint8_t *sig, const dilithium_params *p);
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "packing.h"
+#include "kat.h"
+
+#define TESTS 10000
+
+/*
+ * Bit-by-bit pack/unpack, stored value = offset + sign * a,
+ * used as golden model for every width
+ */
+static void pack_gold(uint8_t *r, const poly *a, unsigned width, data_t offset, data_t sign)
+{
+    unsigned bit;
+    uint32_t t;
+
+    memset(r, 0, width * DILITHIUM_N / 8);
+    for (unsigned i = 0; i < DILITHIUM_N; i++)
+    {
+        t = (uint32_t)(offset + sign * a->coeffs[i]);
+        for (unsigned b = 0; b < width; b++)
+        {
+            bit = i * width + b;
+            r[bit / 8] |= ((t >> b) & 1) << (bit % 8);
+        }
+    }
+}
+
+static void unpack_gold(poly *r, const uint8_t *a, unsigned width, data_t offset, data_t sign)
+{
+    unsigned bit;
+    uint32_t t;
+
+    for (unsigned i = 0; i < DILITHIUM_N; i++)
+    {
+        t = 0;
+        for (unsigned b = 0; b < width; b++)
+        {
+            bit = i * width + b;
+            t |= (uint32_t)((a[bit / 8] >> (bit % 8)) & 1) << b;
+        }
+        r->coeffs[i] = sign * ((data_t)t - offset);
+    }
+}
+
+typedef struct
+{
+    const char *name;
+    unsigned width;
+    data_t offset, sign;
+    void (*pack)(uint8_t *r, const poly *a, data_t param);
+    void (*unpack)(poly *r, const uint8_t *a, data_t param);
+    data_t param;
+} format;
+
+static void t1_pack(uint8_t *r, const poly *a, data_t) { polyt1_pack(r, a); }
+static void t1_unpack(poly *r, const uint8_t *a, data_t) { polyt1_unpack(r, a); }
+static void t0_pack(uint8_t *r, const poly *a, data_t) { polyt0_pack(r, a); }
+static void t0_unpack(poly *r, const uint8_t *a, data_t) { polyt0_unpack(r, a); }
+
+static const format formats[] = {
+    {"eta 2", 3, 2, -1, polyeta_pack, polyeta_unpack, 2},
+    {"eta 4", 4, 4, -1, polyeta_pack, polyeta_unpack, 4},
+    {"w1 32", 4, 0, 1, polyw1_pack, polyw1_unpack, (DILITHIUM_Q - 1) / 32},
+    {"w1 88", 6, 0, 1, polyw1_pack, polyw1_unpack, (DILITHIUM_Q - 1) / 88},
+    {"t1", 10, 0, 1, t1_pack, t1_unpack, 0},
+    {"t0", 13, 1 << (DILITHIUM_D - 1), -1, t0_pack, t0_unpack, 0},
+    {"z 17", 18, 1 << 17, -1, polyz_pack, polyz_unpack, 1 << 17},
+    {"z 19", 20, 1 << 19, -1, polyz_pack, polyz_unpack, 1 << 19},
+};
+
+static int compare_poly(const poly *a, const poly *b, const char *string)
+{
+    for (int i = 0; i < DILITHIUM_N; i++)
+    {
+        if (a->coeffs[i] != b->coeffs[i])
+        {
+            printf("%s: [%d] %d != %d\n", string, i, a->coeffs[i], b->coeffs[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Random stored values for every width, checked against the golden model.
+ * The guard bytes after the packed polynomial must stay untouched.
+ */
+static int test_random()
+{
+    uint8_t buf[20 * DILITHIUM_N / 8 + 32], gold[20 * DILITHIUM_N / 8];
+    poly a, b;
+    const format *f;
+    unsigned len;
+
+    for (unsigned n = 0; n < sizeof(formats) / sizeof(formats[0]); n++)
+    {
+        f = &formats[n];
+        len = f->width * DILITHIUM_N / 8;
+        for (int j = 0; j < TESTS; j++)
+        {
+            for (int i = 0; i < DILITHIUM_N; i++)
+            {
+                a.coeffs[i] = f->sign * ((data_t)(rand() & ((1 << f->width) - 1)) - f->offset);
+                if (j == 0)
+                    a.coeffs[i] = f->sign * ((i & 1) ? (1 << f->width) - 1 - f->offset : -f->offset);
+            }
+
+            memset(buf, 0xA5, sizeof(buf));
+            f->pack(buf, &a, f->param);
+            pack_gold(gold, &a, f->width, f->offset, f->sign);
+            if (memcmp(buf, gold, len))
+            {
+                printf("%s: pack\n", f->name);
+                return 1;
+            }
+            for (unsigned i = len; i < sizeof(buf); i++)
+            {
+                if (buf[i] != 0xA5)
+                {
+                    printf("%s: pack writes past %u bytes\n", f->name, len);
+                    return 1;
+                }
+            }
+
+            f->unpack(&b, gold, f->param);
+            if (compare_poly(&a, &b, f->name))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Unpack and pack again every t1, t0, z and h of the KAT files,
+ * the bytes must come back unchanged.
+ */
+static int roundtrip(const char *name, int sec_lvl, unsigned t, unsigned n,
+                     unsigned polybytes,
+                     void (*unpack)(poly *, const uint8_t *, data_t),
+                     void (*pack)(uint8_t *, const poly *, data_t), data_t param,
+                     unsigned width, data_t offset, data_t sign)
+{
+    uint8_t in[L_MAX * 20 * DILITHIUM_N / 8], out[L_MAX * 20 * DILITHIUM_N / 8];
+    poly a, b;
+
+    if (read_kat(in, n * polybytes, name, sec_lvl, t) != (int)(n * polybytes))
+        return 1;
+
+    for (unsigned i = 0; i < n; i++)
+    {
+        unpack(&a, in + i * polybytes, param);
+        unpack_gold(&b, in + i * polybytes, width, offset, sign);
+        if (compare_poly(&b, &a, name))
+            return 1;
+        pack(out + i * polybytes, &a, param);
+    }
+    if (memcmp(in, out, n * polybytes))
+    {
+        printf("%s level %d, KAT %u\n", name, sec_lvl, t);
+        return 1;
+    }
+    return 0;
+}
+
+static int test_kat()
+{
+    const int levels[3] = {2, 3, 5};
+    uint8_t in[BYTES_MAX], out[BYTES_MAX];
+    poly h[K_MAX];
+    const dilithium_params *p;
+    unsigned width;
+
+    for (int l = 0; l < 3; l++)
+    {
+        p = get_params(levels[l]);
+        width = (p->GAMMA1 == (1 << 17)) ? 18 : 20;
+        for (unsigned t = 0; t < KAT_NUM; t++)
+        {
+            if (roundtrip("t1", p->sec_lvl, t, p->K, POLYT1_PACKEDBYTES,
+                          t1_unpack, t1_pack, 0, 10, 0, 1) ||
+                roundtrip("t0", p->sec_lvl, t, p->K, POLYT0_PACKEDBYTES,
+                          t0_unpack, t0_pack, 0, 13, 1 << (DILITHIUM_D - 1), -1) ||
+                roundtrip("zs", p->sec_lvl, t, p->L, p->POLYZ_PACKEDBYTES,
+                          polyz_unpack, polyz_pack, p->GAMMA1, width, p->GAMMA1, -1) ||
+                roundtrip("s1", p->sec_lvl, t, p->L, p->POLYETA_PACKEDBYTES,
+                          polyeta_unpack, polyeta_pack, p->ETA, (p->ETA == 2) ? 3 : 4, p->ETA, -1) ||
+                roundtrip("s2", p->sec_lvl, t, p->K, p->POLYETA_PACKEDBYTES,
+                          polyeta_unpack, polyeta_pack, p->ETA, (p->ETA == 2) ? 3 : 4, p->ETA, -1))
+                return 1;
+
+            if (read_kat(in, p->OMEGA + p->K, "h", p->sec_lvl, t) != (int)(p->OMEGA + p->K) ||
+                unpack_hint(h, in, p))
+                return 1;
+            pack_hint(out, h, p);
+            if (memcmp(in, out, p->OMEGA + p->K))
+            {
+                printf("h level %d, KAT %u\n", p->sec_lvl, t);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    int ret = 0;
+    srand(0);
+
+    printf("Test pack/unpack all widths = %u :", TESTS);
+    ret |= test_random();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test t1/t0/z/s1/s2/h KAT round trip :");
+    ret |= test_kat();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    return ret;
+}
@@ -0,0 +1,590 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "config.h"
+#include "fips202.h"
+#include "sampler.h"
+#include "challenge.h"
+#include "rounding.h"
+#include "packing.h"
+#include "poly.h"
+#include "context.h"
+#include "sign_stats.h"
+#include "thread_pool.h"
+#include "parallel.h"
+#include "arena.h"
+#include "profile.h"
+
+// ================ SPECULATIVE SIGN ========================
+
+typedef struct
+{
+    const sign_ctx *ctx;
+    const uint8_t *mu;
+    const uint8_t *rhoprime;
+    unsigned base;              // index of the first attempt of the round
+    uint8_t *sig;               // the caller's, lowest accepted attempt so far
+    size_t written;             // attempt in sig, SIZE_MAX for none
+    std::mutex lock;            // sig and written
+    int reason[SPEC_ROUND_MAX]; // sign_reject of every attempt that ran
+    std::atomic<size_t> winner; // lowest accepted attempt of the round
+} spec_round;
+
+static void spec_attempt(void *arg, size_t i)
+{
+    spec_round *r = (spec_round *)arg;
+    const unsigned L = r->ctx->p->L;
+    // The attempt lives on the stack of the worker that runs it
+    commitment cm;
+    uint8_t sig[BYTES_MAX];
+
+    if (r->winner.load() < i)
+    {
+        return;
+    }
+    sign_commit(&cm, r->rhoprime, (uint16_t)((r->base + i) * L), r->ctx);
+
+    if (r->winner.load() < i)
+    {
+        commitment_wipe(&cm);
+        return;
+    }
+    r->reason[i] = sign_respond(sig, &cm, r->mu, r->ctx);
+    commitment_wipe(&cm);
+    if (r->reason[i] == SIGN_ACCEPT)
+    {
+        size_t w = r->winner.load();
+        while (i < w && !r->winner.compare_exchange_weak(w, i))
+        {
+        }
+
+        std::lock_guard<std::mutex> guard(r->lock);
+        if (i < r->written)
+        {
+            memcpy(r->sig, sig, r->ctx->p->BYTES);
+            r->written = i;
+        }
+    }
+}
+
+int crypto_sign_signature_spec(uint8_t *sig, size_t *siglen,
+                               const uint8_t *m, size_t mlen,
+                               const sign_ctx *ctx, thread_pool *pool,
+                               unsigned attempts)
+{
+    const dilithium_params *p = ctx->p;
+    uint8_t mu[CRHBYTES], rhoprime[CRHBYTES];
+    spec_round r;
+
+    if (attempts == 0)
+    {
+        attempts = thread_pool_width(pool);
+    }
+    attempts = std::min(attempts, (unsigned)SPEC_ROUND_MAX);
+
+    sign_mu(mu, m, mlen, ctx);
+    sign_rhoprime(rhoprime, ctx->key, mu);
+
+    r.ctx = ctx;
+    r.mu = mu;
+    r.rhoprime = rhoprime;
+    r.sig = sig;
+    r.written = SIZE_MAX;
+
+    for (r.base = 0;; r.base += attempts)
+    {
+        r.winner = attempts;
+        thread_pool_run(pool, spec_attempt, &r, attempts);
+
+        // Attempts past the winner are not part of the deterministic loop
+        for (size_t i = 0; i < attempts && i <= r.winner; ++i)
+        {
+            sign_stats_attempt(p->sec_lvl, (enum sign_reject)r.reason[i]);
+        }
+        if (r.winner < attempts)
+        {
+            break;
+        }
+    }
+    sign_stats_signature(p->sec_lvl, (unsigned)(r.base + r.winner + 1));
+
+    *siglen = p->BYTES;
+    return 0;
+}
+
+// ================ ROW PARALLEL ========================
+
+typedef struct
+{
+    poly (*mat)[L_MAX];
+    const uint8_t *rho;
+    const dilithium_params *p;
+} expand_a_job;
+
+static void expand_a_row(void *arg, size_t i)
+{
+    expand_a_job *job = (expand_a_job *)arg;
+
+    for (unsigned j = 0; j < job->p->L; ++j)
+    {
+        poly_uniform(&job->mat[i][j], job->rho, (uint16_t)((i << 8) + j));
+    }
+}
+
+static void expand_a_par(poly mat[K_MAX][L_MAX], const uint8_t rho[SEEDBYTES],
+                         const dilithium_params *p, thread_pool *pool)
+{
+    expand_a_job job = {mat, rho, p};
+
+    thread_pool_run(pool, expand_a_row, &job, p->K);
+}
+
+int sign_ctx_init_par(sign_ctx *ctx, const uint8_t *sk, int sec_lvl, thread_pool *pool)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    uint8_t rho[SEEDBYTES];
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    ctx->p = p;
+    unpack_sk(rho, ctx->tr, ctx->key, ctx->t0hat, ctx->s1hat, ctx->s2hat, sk, p);
+    {
+        PROFILE_SCOPE(FSM0_NTT_S1);
+        polyvec_ntt(ctx->s1hat, p->L);
+    }
+    {
+        PROFILE_SCOPE(FSM0_NTT_S2);
+        polyvec_ntt(ctx->s2hat, p->K);
+    }
+    {
+        PROFILE_SCOPE(FSM0_NTT_T0);
+        polyvec_ntt(ctx->t0hat, p->K);
+    }
+    tr_state_init(&ctx->tr_state, ctx->tr);
+    expand_a_par(ctx->mat, rho, p, pool);
+
+    return 0;
+}
+
+int verify_ctx_init_par(verify_ctx *ctx, const uint8_t *pk, int sec_lvl, thread_pool *pool)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    uint8_t rho[SEEDBYTES];
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    ctx->p = p;
+    shake256(ctx->tr, SEEDBYTES, pk, p->PUBLICKEYBYTES);
+    tr_state_init(&ctx->tr_state, ctx->tr);
+    unpack_pk(rho, ctx->t1hat, pk, p);
+    expand_a_par(ctx->mat, rho, p, pool);
+
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        poly_shiftl(&ctx->t1hat[i]);
+    }
+    polyvec_ntt(ctx->t1hat, p->K);
+
+    return 0;
+}
+
+typedef struct
+{
+    commitment *cm;
+    poly *yhat;
+    const uint8_t *rhoprime;
+    uint16_t nonce;
+    const sign_ctx *ctx;
+} commit_job;
+
+static void commit_column(void *arg, size_t j)
+{
+    commit_job *job = (commit_job *)arg;
+    const dilithium_params *p = job->ctx->p;
+
+    poly_uniform_gamma1(&job->cm->y[j], job->rhoprime, (uint16_t)(job->nonce + j), p->GAMMA1);
+    job->yhat[j] = job->cm->y[j];
+    poly_ntt(&job->yhat[j]);
+}
+
+static void commit_row(void *arg, size_t i)
+{
+    commit_job *job = (commit_job *)arg;
+    const dilithium_params *p = job->ctx->p;
+    commitment *cm = job->cm;
+
+    polyvec_pointwise_acc(&cm->w1[i], job->ctx->mat[i], job->yhat, p->L);
+    poly_invntt(&cm->w1[i]);
+    poly_caddq(&cm->w1[i]);
+    poly_decompose(&cm->w1[i], &cm->w0[i], &cm->w1[i], p->GAMMA2);
+    polyw1_pack(cm->w1_packed + i * p->POLYW1_PACKEDBYTES, &cm->w1[i], p->GAMMA2);
+}
+
+void sign_commit_par(commitment *cm, const uint8_t rhoprime[CRHBYTES], uint16_t nonce,
+                     const sign_ctx *ctx, thread_pool *pool)
+{
+    poly yhat[L_MAX];
+    commit_job job = {cm, yhat, rhoprime, nonce, ctx};
+
+    thread_pool_run(pool, commit_column, &job, ctx->p->L);
+    thread_pool_run(pool, commit_row, &job, ctx->p->K);
+}
+
+int crypto_sign_signature_par(uint8_t *sig, size_t *siglen,
+                              const uint8_t *m, size_t mlen,
+                              const sign_ctx *ctx, thread_pool *pool)
+{
+    const dilithium_params *p = ctx->p;
+    uint8_t mu[CRHBYTES], rhoprime[CRHBYTES];
+    uint16_t nonce = 0;
+    unsigned attempts = 0;
+    int reason;
+    commitment cm;
+
+    sign_mu(mu, m, mlen, ctx);
+    sign_rhoprime(rhoprime, ctx->key, mu);
+
+    do
+    {
+        sign_commit_par(&cm, rhoprime, nonce, ctx, pool);
+        nonce += p->L;
+        reason = sign_respond(sig, &cm, mu, ctx);
+        sign_stats_attempt(p->sec_lvl, (enum sign_reject)reason);
+        attempts++;
+    } while (reason != SIGN_ACCEPT);
+    sign_stats_signature(p->sec_lvl, attempts);
+
+    *siglen = p->BYTES;
+    return 0;
+}
+
+typedef struct
+{
+    poly *z;
+    const poly *h;
+    poly *w1;
+    const poly *c;
+    uint8_t *w1_packed;
+    const verify_ctx *ctx;
+} verify_job;
+
+static void verify_column(void *arg, size_t j)
+{
+    verify_job *job = (verify_job *)arg;
+
+    poly_ntt(&job->z[j]);
+}
+
+static void verify_row(void *arg, size_t i)
+{
+    verify_job *job = (verify_job *)arg;
+    const dilithium_params *p = job->ctx->p;
+    poly cp;
+
+    polyvec_pointwise_acc(&job->w1[i], job->ctx->mat[i], job->z, p->L);
+    poly_pointwise(&cp, job->c, &job->ctx->t1hat[i]);
+    poly_sub(&job->w1[i], &job->w1[i], &cp);
+    poly_invntt(&job->w1[i]);
+    poly_caddq(&job->w1[i]);
+    poly_use_hint(&job->w1[i], &job->w1[i], &job->h[i], p->GAMMA2);
+    polyw1_pack(job->w1_packed + i * p->POLYW1_PACKEDBYTES, &job->w1[i], p->GAMMA2);
+}
+
+int crypto_sign_verify_par(const uint8_t *sig, size_t siglen,
+                           const uint8_t *m, size_t mlen,
+                           const verify_ctx *ctx, thread_pool *pool)
+{
+    const dilithium_params *p = ctx->p;
+    uint8_t mu[CRHBYTES];
+    uint8_t ctilde[SEEDBYTES], ctilde2[SEEDBYTES];
+    uint8_t w1_packed[K_MAX * POLYW1_PACKEDBYTES_MAX];
+    keccak_state state;
+    poly z[L_MAX], h[K_MAX], w1[K_MAX], c;
+    verify_job job = {z, h, w1, &c, w1_packed, ctx};
+
+    if (siglen != p->BYTES)
+    {
+        return -1;
+    }
+
+    if (unpack_sig(ctilde, z, h, sig, p))
+    {
+        return -1;
+    }
+    if (polyvec_chknorm(z, p->L, p->GAMMA1 - p->BETA))
+    {
+        return -1;
+    }
+
+    verify_mu(mu, m, mlen, ctx);
+
+    sample_in_ball(&c, NULL, ctilde, p);
+    poly_ntt(&c);
+
+    thread_pool_run(pool, verify_column, &job, p->L);
+    thread_pool_run(pool, verify_row, &job, p->K);
+
+    shake256_init(&state);
+    shake256_absorb(&state, mu, CRHBYTES);
+    shake256_absorb(&state, w1_packed, p->K * p->POLYW1_PACKEDBYTES);
+    shake256_finalize(&state);
+    shake256_squeeze(ctilde2, SEEDBYTES, &state);
+
+    if (memcmp(ctilde, ctilde2, SEEDBYTES) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// ================ BATCH VERIFY ========================
+
+typedef struct
+{
+    size_t first, count; // range of `order` sharing one public key
+    verify_ctx *ctx;
+    int ok; // ctx was built, every item of the group fails otherwise
+} key_group;
+
+typedef struct
+{
+    size_t group, first, count; // block of `order` within one group
+} verify_block;
+
+typedef struct
+{
+    const verify_item *items;
+    int *results;
+    const dilithium_params *p;
+    int sec_lvl;
+    std::vector<size_t> order;
+    std::vector<key_group> groups;
+    std::vector<verify_block> blocks;
+} batch_job;
+
+static void batch_ctx(void *arg, size_t g)
+{
+    batch_job *job = (batch_job *)arg;
+    key_group *grp = &job->groups[g];
+
+    grp->ok = verify_ctx_init(grp->ctx, job->items[job->order[grp->first]].pk, job->sec_lvl) == 0;
+}
+
+// Public keys by bytes, a NULL key before all others
+static int pk_less(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    if (a == b || b == NULL)
+    {
+        return 0;
+    }
+    return a == NULL || memcmp(a, b, len) < 0;
+}
+
+/*
+ * Per block: unpack and NTT every z, then for each row of A one pass over
+ * A[i][j] accumulating into all signatures of the block, then the rest of
+ * the verification per signature.
+ */
+static void batch_block(void *arg, size_t k)
+{
+    batch_job *job = (batch_job *)arg;
+    const verify_block *blk = &job->blocks[k];
+    const verify_ctx *ctx = job->groups[blk->group].ctx;
+    const dilithium_params *p = job->p;
+    uint8_t mu[CRHBYTES], ctilde[VERIFY_BLOCK][SEEDBYTES], ctilde2[SEEDBYTES];
+    uint8_t w1_packed[K_MAX * POLYW1_PACKEDBYTES_MAX];
+    int live[VERIFY_BLOCK];
+    keccak_state state;
+    batch_arena *arena = batch_arena_get();
+    poly(*z)[L_MAX], (*h)[K_MAX], (*w)[K_MAX];
+    data2_t(*acc)[DILITHIUM_N];
+    poly c, cp;
+    const verify_item *it;
+
+    if (!job->groups[blk->group].ok || arena == NULL)
+    {
+        for (size_t b = 0; b < blk->count; ++b)
+        {
+            job->results[job->order[blk->first + b]] = -1;
+        }
+        return;
+    }
+    z = arena->verify.z;
+    h = arena->verify.h;
+    w = arena->verify.w;
+    acc = arena->verify.acc;
+    for (size_t b = 0; b < blk->count; ++b)
+    {
+        it = &job->items[job->order[blk->first + b]];
+        live[b] = it->siglen == p->BYTES &&
+                  !unpack_sig(ctilde[b], z[b], h[b], it->sig, p) &&
+                  !polyvec_chknorm(z[b], p->L, p->GAMMA1 - p->BETA);
+        if (live[b])
+        {
+            polyvec_ntt(z[b], p->L);
+        }
+    }
+
+    // w[b] = A * z[b], A[i][j] is read once per block
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        memset(acc, 0, sizeof(arena->verify.acc));
+        for (unsigned j = 0; j < p->L; ++j)
+        {
+            const data_t *a = ctx->mat[i][j].coeffs;
+            for (size_t b = 0; b < blk->count; ++b)
+            {
+                if (!live[b])
+                {
+                    continue;
+                }
+                for (unsigned x = 0; x < DILITHIUM_N; ++x)
+                {
+                    acc[b][x] += (data2_t)a[x] * z[b][j].coeffs[x];
+                }
+            }
+        }
+        for (size_t b = 0; b < blk->count; ++b)
+        {
+            for (unsigned x = 0; x < DILITHIUM_N; ++x)
+            {
+                w[b][i].coeffs[x] = acc[b][x] % DILITHIUM_Q;
+            }
+        }
+    }
+
+    for (size_t b = 0; b < blk->count; ++b)
+    {
+        it = &job->items[job->order[blk->first + b]];
+        if (!live[b])
+        {
+            job->results[job->order[blk->first + b]] = -1;
+            continue;
+        }
+
+        verify_mu(mu, it->m, it->mlen, ctx);
+
+        sample_in_ball(&c, NULL, ctilde[b], p);
+        poly_ntt(&c);
+
+        for (unsigned i = 0; i < p->K; ++i)
+        {
+            poly_pointwise(&cp, &c, &ctx->t1hat[i]);
+            poly_sub(&w[b][i], &w[b][i], &cp);
+            poly_invntt(&w[b][i]);
+            poly_caddq(&w[b][i]);
+            poly_use_hint(&w[b][i], &w[b][i], &h[b][i], p->GAMMA2);
+            polyw1_pack(w1_packed + i * p->POLYW1_PACKEDBYTES, &w[b][i], p->GAMMA2);
+        }
+
+        shake256_init(&state);
+        shake256_absorb(&state, mu, CRHBYTES);
+        shake256_absorb(&state, w1_packed, p->K * p->POLYW1_PACKEDBYTES);
+        shake256_finalize(&state);
+        shake256_squeeze(ctilde2, SEEDBYTES, &state);
+
+        job->results[job->order[blk->first + b]] =
+            memcmp(ctilde[b], ctilde2, SEEDBYTES) ? -1 : 0;
+    }
+}
+
+int verify_batch(int *results, const verify_item *items, size_t n, int sec_lvl,
+                 thread_pool *pool)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    batch_job job;
+    verify_ctx *ctxs;
+    size_t first;
+    int ret = 0;
+
+    if (p == NULL)
+    {
+        return -1;
+    }
+
+    job.items = items;
+    job.results = results;
+    job.p = p;
+    job.sec_lvl = sec_lvl;
+
+    // Group equal public keys, stable so a key's items keep their order
+    job.order.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        job.order[i] = i;
+    }
+    std::stable_sort(job.order.begin(), job.order.end(), [&](size_t a, size_t b) {
+        return pk_less(items[a].pk, items[b].pk, p->PUBLICKEYBYTES);
+    });
+
+    for (size_t i = 0; i < n; i = first)
+    {
+        for (first = i + 1; first < n; ++first)
+        {
+            const uint8_t *a = items[job.order[i]].pk, *b = items[job.order[first]].pk;
+            if (pk_less(a, b, p->PUBLICKEYBYTES))
+            {
+                break;
+            }
+        }
+        job.groups.push_back({i, first - i, NULL, 0});
+        for (size_t k = i; k < first; k += VERIFY_BLOCK)
+        {
+            job.blocks.push_back({job.groups.size() - 1, k, std::min<size_t>(VERIFY_BLOCK, first - k)});
+        }
+    }
+
+    ctxs = new (std::nothrow) verify_ctx[job.groups.size()];
+    if (ctxs == NULL)
+    {
+        return -1;
+    }
+    for (size_t g = 0; g < job.groups.size(); ++g)
+    {
+        job.groups[g].ctx = &ctxs[g];
+    }
+
+    thread_pool_run(pool, batch_ctx, &job, job.groups.size());
+    thread_pool_run(pool, batch_block, &job, job.blocks.size());
+
+    delete[] ctxs;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        ret |= results[i];
+    }
+    return ret ? -1 : 0;
+}
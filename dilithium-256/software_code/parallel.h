@@ -0,0 +1,109 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "context.h"
+#include "thread_pool.h"
+
+/*
+ * Speculative signing: rounds of `attempts` rejection-loop attempts with
+ * nonces kappa, kappa + L, ... run in parallel on `pool`, the first
+ * accepted attempt in nonce order wins. The signature is therefore the
+ * same as crypto_sign_signature_ctx. attempts = 0 uses the pool width,
+ * at most SPEC_ROUND_MAX run per round.
+ * Attempts beyond an accepted one are skipped as soon as it is known.
+ * Each attempt is kept on the stack of the worker running it, nothing is
+ * taken from the heap.
+ */
+#define SPEC_ROUND_MAX 64
+
+int crypto_sign_signature_spec(uint8_t *sig, size_t *siglen,
+                               const uint8_t *m, size_t mlen,
+                               const sign_ctx *ctx, thread_pool *pool,
+                               unsigned attempts);
+
+/*
+ * Row-level work splitting for one sign or verify in flight.
+ * Each phase is one thread_pool_run over the rows (or columns) of A, its
+ * join is the barrier before the next phase:
+ *   ExpandA        one task per row of A
+ *   commit         ExpandMask + NTT per column, then per row
+ *                  MAC, invNTT, Decompose and w1 packing
+ *   verify         NTT(z) per column, then per row MAC,
+ *                  - c * t1 * 2^D, invNTT and UseHint
+ * Results are identical to the sequential functions.
+ */
+int sign_ctx_init_par(sign_ctx *ctx, const uint8_t *sk, int sec_lvl, thread_pool *pool);
+
+int verify_ctx_init_par(verify_ctx *ctx, const uint8_t *pk, int sec_lvl, thread_pool *pool);
+
+void sign_commit_par(commitment *cm, const uint8_t rhoprime[CRHBYTES], uint16_t nonce,
+                     const sign_ctx *ctx, thread_pool *pool);
+
+int crypto_sign_signature_par(uint8_t *sig, size_t *siglen,
+                              const uint8_t *m, size_t mlen,
+                              const sign_ctx *ctx, thread_pool *pool);
+
+int crypto_sign_verify_par(const uint8_t *sig, size_t siglen,
+                           const uint8_t *m, size_t mlen,
+                           const verify_ctx *ctx, thread_pool *pool);
+
+/*
+ * Batch verification.
+ * Items are grouped by public key, one verify_ctx is built per key, then
+ * each key's signatures are verified in blocks of VERIFY_BLOCK: A is
+ * streamed once per block against all z of the block, GEMM-like.
+ * Blocks are spread over `pool`.
+ * results[i] = crypto_sign_verify of item i; return 0 if all are valid.
+ * Every item of a key verify_ctx_init rejects, a NULL pk included, gets -1,
+ * and so does every item if the batch arena of arena.h cannot be allocated.
+ */
+#define VERIFY_BLOCK 8
+
+// Per-thread scratch of one block, taken from the batch arena of arena.h
+typedef struct
+{
+    poly z[VERIFY_BLOCK][L_MAX];
+    poly h[VERIFY_BLOCK][K_MAX];
+    poly w[VERIFY_BLOCK][K_MAX];
+    data2_t acc[VERIFY_BLOCK][DILITHIUM_N];
+} verify_batch_scratch;
+
+typedef struct
+{
+    const uint8_t *sig;
+    size_t siglen;
+    const uint8_t *m;
+    size_t mlen;
+    const uint8_t *pk;
+} verify_item;
+
+int verify_batch(int *results, const verify_item *items, size_t n, int sec_lvl,
+                 thread_pool *pool);
+
+#endif
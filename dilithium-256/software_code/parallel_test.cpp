@@ -0,0 +1,248 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "sign.h"
+#include "context.h"
+#include "thread_pool.h"
+#include "parallel.h"
+#include "kat.h"
+
+#define MLEN_MAX 3300
+#define TESTS 20
+
+static uint8_t m[MLEN_MAX];
+static sign_ctx ctx;
+
+// KAT message i signed with KAT key i
+static int load_signer(uint8_t *pk, uint8_t *c, size_t *mlen, int sec_lvl, unsigned i)
+{
+    uint8_t zeta[SEEDBYTES], sk[SECRETKEYBYTES_MAX], len[2];
+
+    if (read_kat(zeta, SEEDBYTES, "z", sec_lvl, i) != SEEDBYTES ||
+        read_kat(m, MLEN_MAX, "m", sec_lvl, i) < 0 ||
+        read_kat(len, 2, "mlen", sec_lvl, i) != 2 ||
+        read_kat(c, SEEDBYTES, "c", sec_lvl, i) != SEEDBYTES)
+        return 1;
+    *mlen = (len[0] << 8) | len[1];
+
+    crypto_sign_keypair_seed(pk, sk, zeta, sec_lvl);
+    return sign_ctx_init(&ctx, sk, sec_lvl);
+}
+
+/*
+ * Speculative signatures, with 0, 1 and 3 workers and 1 to 5 attempts per
+ * round, must equal the sequential KAT signatures
+ */
+static int test_spec(int sec_lvl)
+{
+    const unsigned workers[3] = {0, 1, 3};
+    uint8_t pk[PUBLICKEYBYTES_MAX], c[SEEDBYTES];
+    uint8_t sig[BYTES_MAX], gold[BYTES_MAX];
+    size_t mlen, siglen, goldlen;
+    thread_pool *pool;
+    int ret = 0;
+
+    for (unsigned w = 0; w < 3 && !ret; w++)
+    {
+        pool = thread_pool_new(workers[w]);
+        ret |= pool == NULL || thread_pool_width(pool) != workers[w] + 1;
+        for (unsigned t = 0; t < TESTS && !ret; t++)
+        {
+            if (load_signer(pk, c, &mlen, sec_lvl, t))
+                return 1;
+            crypto_sign_signature_ctx(gold, &goldlen, m, mlen, &ctx);
+            ret |= memcmp(gold, c, SEEDBYTES) != 0;
+
+            for (unsigned a = 0; a <= 5; a++)
+            {
+                ret |= crypto_sign_signature_spec(sig, &siglen, m, mlen, &ctx, pool, a);
+                ret |= siglen != goldlen || memcmp(sig, gold, goldlen);
+            }
+            if (ret)
+                printf("workers %u, KAT %u\n", workers[w], t);
+        }
+        thread_pool_free(pool);
+    }
+    return ret;
+}
+
+/*
+ * Row-parallel contexts, sign and verify against the sequential ones
+ */
+static int test_rows(int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    const unsigned workers[3] = {0, 1, 3};
+    static sign_ctx ctx_par;
+    static verify_ctx vctx, vctx_par;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], zeta[SEEDBYTES], c[SEEDBYTES];
+    uint8_t sig[BYTES_MAX], gold[BYTES_MAX];
+    size_t mlen, siglen, goldlen;
+    thread_pool *pool;
+    int ret = 0;
+
+    for (unsigned w = 0; w < 3 && !ret; w++)
+    {
+        pool = thread_pool_new(workers[w]);
+        for (unsigned t = 0; t < TESTS && !ret; t++)
+        {
+            if (load_signer(pk, c, &mlen, sec_lvl, t) ||
+                read_kat(zeta, SEEDBYTES, "z", sec_lvl, t) != SEEDBYTES)
+                return 1;
+            crypto_sign_keypair_seed(pk, sk, zeta, sec_lvl);
+
+            ret |= sign_ctx_init_par(&ctx_par, sk, sec_lvl, pool);
+            ret |= memcmp(ctx.mat, ctx_par.mat, sizeof(ctx.mat)) != 0;
+            ret |= verify_ctx_init(&vctx, pk, sec_lvl);
+            ret |= verify_ctx_init_par(&vctx_par, pk, sec_lvl, pool);
+            ret |= memcmp(vctx.mat, vctx_par.mat, sizeof(vctx.mat)) != 0;
+            ret |= memcmp(vctx.t1hat, vctx_par.t1hat, p->K * sizeof(poly)) != 0;
+
+            crypto_sign_signature_ctx(gold, &goldlen, m, mlen, &ctx);
+            ret |= crypto_sign_signature_par(sig, &siglen, m, mlen, &ctx_par, pool);
+            ret |= siglen != goldlen || memcmp(sig, gold, goldlen);
+
+            ret |= crypto_sign_verify_par(sig, siglen, m, mlen, &vctx_par, pool) != 0;
+            m[0] ^= 1;
+            ret |= crypto_sign_verify_par(sig, siglen, m, mlen, &vctx_par, pool) == 0;
+            m[0] ^= 1;
+            sig[SEEDBYTES] ^= 1;
+            ret |= crypto_sign_verify_par(sig, siglen, m, mlen, &vctx_par, pool) == 0;
+            if (ret)
+                printf("workers %u, KAT %u\n", workers[w], t);
+        }
+        thread_pool_free(pool);
+    }
+    return ret;
+}
+
+/*
+ * verify_batch over KEYS keys in shuffled order, every fourth signature
+ * tampered, against crypto_sign_verify item by item
+ */
+#define KEYS 3
+#define ITEMS 45
+
+static int test_batch(int sec_lvl)
+{
+    static uint8_t pk[KEYS][PUBLICKEYBYTES_MAX], sk[KEYS][SECRETKEYBYTES_MAX];
+    static uint8_t pk_copy[PUBLICKEYBYTES_MAX];
+    static uint8_t msg[ITEMS][32], sig[ITEMS][BYTES_MAX];
+    verify_item items[ITEMS];
+    int results[ITEMS], expected[ITEMS], gold;
+    const uint8_t *saved[2];
+    uint8_t zeta[SEEDBYTES];
+    size_t siglen;
+    unsigned key;
+    thread_pool *pool;
+    int ret = 0;
+
+    for (unsigned k = 0; k < KEYS; k++)
+    {
+        if (read_kat(zeta, SEEDBYTES, "z", sec_lvl, k) != SEEDBYTES)
+            return 1;
+        crypto_sign_keypair_seed(pk[k], sk[k], zeta, sec_lvl);
+    }
+    memcpy(pk_copy, pk[0], PUBLICKEYBYTES_MAX);
+
+    for (unsigned i = 0; i < ITEMS; i++)
+    {
+        key = rand() % KEYS;
+        for (unsigned j = 0; j < sizeof(msg[i]); j++)
+            msg[i][j] = rand() & 0xFF;
+        crypto_sign_signature(sig[i], &siglen, msg[i], sizeof(msg[i]), sk[key], sec_lvl);
+
+        // Keys are grouped by value, not by address
+        items[i].pk = (key == 0 && i % 2) ? pk_copy : pk[key];
+        items[i].sig = sig[i];
+        items[i].siglen = siglen;
+        items[i].m = msg[i];
+        items[i].mlen = sizeof(msg[i]);
+        if (i % 4 == 1)
+            msg[i][0] ^= 1;
+        if (i % 8 == 3)
+            items[i].siglen = siglen - 1;
+    }
+    items[ITEMS - 1].sig = sig[0];
+
+    for (unsigned w = 0; w < 4 && !ret; w++)
+    {
+        pool = thread_pool_new(w);
+        ret |= verify_batch(results, items, ITEMS, sec_lvl, pool) != -1;
+        for (unsigned i = 0; i < ITEMS; i++)
+        {
+            gold = crypto_sign_verify(items[i].sig, items[i].siglen, items[i].m, items[i].mlen,
+                                      items[i].pk, sec_lvl);
+            if (results[i] != gold)
+            {
+                printf("workers %u, item %u: %d != %d\n", w, i, results[i], gold);
+                ret = 1;
+            }
+        }
+        memcpy(expected, results, sizeof(results));
+
+        // Items without a key fail, the others keep their results
+        saved[0] = items[0].pk;
+        saved[1] = items[2].pk;
+        items[0].pk = items[2].pk = NULL;
+        ret |= verify_batch(results, items, ITEMS, sec_lvl, pool) != -1;
+        for (unsigned i = 0; i < ITEMS; i++)
+            ret |= results[i] != (i == 0 || i == 2 ? -1 : expected[i]);
+        items[0].pk = saved[0];
+        items[2].pk = saved[1];
+
+        // All valid
+        ret |= verify_batch(results, items, 1, sec_lvl, pool) != 0;
+        ret |= verify_batch(results, items, 0, sec_lvl, pool) != 0;
+        thread_pool_free(pool);
+    }
+    return ret;
+}
+
+int main()
+{
+    const int levels[3] = {2, 3, 5};
+    int ret = 0;
+
+    for (int l = 0; l < 3; l++)
+    {
+        printf("Test speculative sign level %d = %u :", levels[l], TESTS);
+        ret |= test_spec(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+
+        printf("Test row-parallel sign/verify level %d = %u :", levels[l], TESTS);
+        ret |= test_rows(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+
+        printf("Test verify_batch level %d = %u :", levels[l], ITEMS);
+        ret |= test_batch(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+    }
+    return ret;
+}
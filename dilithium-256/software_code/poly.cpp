@@ -0,0 +1,278 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include "config.h"
+#include "poly.h"
+#include "../consts.h"
+#include "../reference_code/ref_ntt.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+void poly_add(poly *c, const poly *a, const poly *b)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        c->coeffs[i] = a->coeffs[i] + b->coeffs[i];
+    }
+}
+
+void poly_sub(poly *c, const poly *a, const poly *b)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        c->coeffs[i] = a->coeffs[i] - b->coeffs[i];
+    }
+}
+
+void poly_shiftl(poly *a)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        a->coeffs[i] <<= DILITHIUM_D;
+    }
+}
+
+void poly_reduce(poly *a)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        a->coeffs[i] %= DILITHIUM_Q;
+    }
+}
+
+void poly_caddq(poly *a)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        a->coeffs[i] += (a->coeffs[i] >> 31) & DILITHIUM_Q;
+    }
+}
+
+void poly_center(poly *a)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        a->coeffs[i] += (a->coeffs[i] >> 31) & DILITHIUM_Q;
+        a->coeffs[i] -= (((DILITHIUM_Q - 1) / 2 - a->coeffs[i]) >> 31) & DILITHIUM_Q;
+    }
+}
+
+/*
+ * Same butterflies as ref_ntt.cpp, with zetas_mont and a Montgomery
+ * reduction instead of three divisions per butterfly. Only the
+ * multiplied half is reduced, the other grows by less than Q per layer.
+ */
+#define QINV 58728449 // Q^-1 mod 2^32
+#define MONT_F 16382  // 2^32 / 256 mod Q
+
+// a * 2^-32 mod Q in (-Q, Q), for |a| < 2^31 * Q
+static inline data_t montgomery_reduce(data2_t a)
+{
+    data_t t = (data_t)((data2_t)(data_t)a * QINV);
+
+    return (data_t)((a - (data2_t)t * DILITHIUM_Q) >> 32);
+}
+
+// a mod Q in (-Q, Q), for a < 2^31 - 2^22
+static inline data_t reduce32(data_t a)
+{
+    data_t t = (a + (1 << 22)) >> 23;
+
+    return a - t * DILITHIUM_Q;
+}
+
+void poly_ntt(poly *a)
+{
+    unsigned len, start, j, k = 0;
+    data_t zeta, t;
+
+    for (len = DILITHIUM_N / 2; len > 0; len >>= 1)
+    {
+        for (start = 0; start < DILITHIUM_N; start = j + len)
+        {
+            zeta = zetas_mont[++k];
+            for (j = start; j < start + len; ++j)
+            {
+                t = montgomery_reduce((data2_t)zeta * a->coeffs[j + len]);
+                a->coeffs[j + len] = a->coeffs[j] - t;
+                a->coeffs[j] = a->coeffs[j] + t;
+            }
+        }
+    }
+    for (j = 0; j < DILITHIUM_N; ++j)
+    {
+        a->coeffs[j] = reduce32(a->coeffs[j]);
+    }
+}
+
+void poly_invntt(poly *a)
+{
+    unsigned len, start, j, k = DILITHIUM_N;
+    data_t zeta, t;
+
+    // The sums double every layer, start from below Q
+    for (j = 0; j < DILITHIUM_N; ++j)
+    {
+        a->coeffs[j] = reduce32(a->coeffs[j]);
+    }
+    for (len = 1; len < DILITHIUM_N; len <<= 1)
+    {
+        for (start = 0; start < DILITHIUM_N; start = j + len)
+        {
+            zeta = -zetas_mont[--k];
+            for (j = start; j < start + len; ++j)
+            {
+                t = a->coeffs[j];
+                a->coeffs[j] = t + a->coeffs[j + len];
+                a->coeffs[j + len] = montgomery_reduce((data2_t)zeta * (t - a->coeffs[j + len]));
+            }
+        }
+    }
+    for (j = 0; j < DILITHIUM_N; ++j)
+    {
+        a->coeffs[j] = montgomery_reduce((data2_t)MONT_F * a->coeffs[j]);
+    }
+}
+
+void poly_pointwise(poly *c, const poly *a, const poly *b)
+{
+    pointwise_barrett(c->coeffs, a->coeffs, b->coeffs);
+}
+
+/*
+ * Which block fails only depends on the rejected candidate, so leaking it
+ * through the early exit is fine, same as `rej` of norm_check.v.
+ */
+#ifdef __AVX2__
+
+int poly_chknorm(const poly *a, data_t bound)
+{
+    const __m256i b = _mm256_set1_epi32(bound - 1);
+    __m256i f, g;
+
+    for (unsigned i = 0; i < DILITHIUM_N; i += CHKNORM_BLOCK)
+    {
+        g = _mm256_setzero_si256();
+        for (unsigned j = i; j < i + CHKNORM_BLOCK; j += 8)
+        {
+            f = _mm256_loadu_si256((const __m256i *)&a->coeffs[j]);
+            f = _mm256_abs_epi32(f);
+            g = _mm256_or_si256(g, _mm256_cmpgt_epi32(f, b));
+        }
+        if (_mm256_movemask_epi8(g))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#else
+
+int poly_chknorm(const poly *a, data_t bound)
+{
+    data_t t, g;
+
+    for (unsigned i = 0; i < DILITHIUM_N; i += CHKNORM_BLOCK)
+    {
+        g = 0;
+        for (unsigned j = i; j < i + CHKNORM_BLOCK; ++j)
+        {
+            // Absolute value without a branch
+            t = a->coeffs[j] >> 31;
+            t = a->coeffs[j] - (t & 2 * a->coeffs[j]);
+            g |= (bound - 1) - t;
+        }
+        if (g < 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+#endif
+
+void polyvec_ntt(poly *v, unsigned n)
+{
+    for (unsigned i = 0; i < n; ++i)
+    {
+        poly_ntt(&v[i]);
+    }
+}
+
+void polyvec_invntt(poly *v, unsigned n)
+{
+    for (unsigned i = 0; i < n; ++i)
+    {
+        poly_invntt(&v[i]);
+    }
+}
+
+void polyvec_caddq(poly *v, unsigned n)
+{
+    for (unsigned i = 0; i < n; ++i)
+    {
+        poly_caddq(&v[i]);
+    }
+}
+
+int polyvec_chknorm(const poly *v, unsigned n, data_t bound)
+{
+    for (unsigned i = 0; i < n; ++i)
+    {
+        if (poly_chknorm(&v[i], bound))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void polyvec_pointwise_acc(poly *w, const poly *u, const poly *v, unsigned n)
+{
+    data2_t t;
+
+    // Products are below Q^2 < 2^46, so n <= L_MAX of them fit data2_t
+    for (unsigned j = 0; j < DILITHIUM_N; ++j)
+    {
+        t = 0;
+        for (unsigned i = 0; i < n; ++i)
+        {
+            t += (data2_t)u[i].coeffs[j] * v[i].coeffs[j];
+        }
+        w->coeffs[j] = t % DILITHIUM_Q;
+    }
+}
+
+void polyvec_matrix_mul(poly w[K_MAX], const poly mat[K_MAX][L_MAX],
+                        const poly v[L_MAX], const dilithium_params *p)
+{
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        polyvec_pointwise_acc(&w[i], mat[i], v, p->L);
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef POLY_H
+#define POLY_H
+
+#include <stdint.h>
+#include "config.h"
+
+/*
+ * Coefficient-wise arithmetic on one polynomial.
+ * Point-wise multiplication reuses reference_code, the NTT and invNTT
+ * are Montgomery versions of it. Outputs lie in (-Q, Q), inputs may be
+ * anywhere below 2^30 in absolute value.
+ */
+
+void poly_add(poly *c, const poly *a, const poly *b);
+
+void poly_sub(poly *c, const poly *a, const poly *b);
+
+// a = a * 2^D
+void poly_shiftl(poly *a);
+
+// Map any a to (-Q, Q)
+void poly_reduce(poly *a);
+
+// Map (-Q, Q) to [0, Q)
+void poly_caddq(poly *a);
+
+// Map (-Q, Q) to [-(Q - 1) / 2, (Q - 1) / 2]
+void poly_center(poly *a);
+
+void poly_ntt(poly *a);
+
+void poly_invntt(poly *a);
+
+void poly_pointwise(poly *c, const poly *a, const poly *b);
+
+/*
+ * Return 1 if some |a[i]| >= bound, 0 otherwise.
+ * Scans CHKNORM_BLOCK coefficients at a time and stops at the first
+ * block holding a violation. The polyvec version stops at the first
+ * failing polynomial.
+ */
+#define CHKNORM_BLOCK 64
+
+int poly_chknorm(const poly *a, data_t bound);
+
+/*
+ * Vectors of n polynomials
+ */
+
+void polyvec_ntt(poly *v, unsigned n);
+
+void polyvec_invntt(poly *v, unsigned n);
+
+void polyvec_caddq(poly *v, unsigned n);
+
+int polyvec_chknorm(const poly *v, unsigned n, data_t bound);
+
+// w = sum_i u[i] o v[i], all in NTT domain
+void polyvec_pointwise_acc(poly *w, const poly *u, const poly *v, unsigned n);
+
+// w = mat * v, K x L matrix times L vector, all in NTT domain
+void polyvec_matrix_mul(poly w[K_MAX], const poly mat[K_MAX][L_MAX],
+                        const poly v[L_MAX], const dilithium_params *p);
+
+#endif
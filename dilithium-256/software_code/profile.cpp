@@ -0,0 +1,110 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include "profile.h"
+
+#ifdef DILITHIUM_PROFILE
+
+#include <string.h>
+#include <list>
+#include <mutex>
+
+#define PROFILE_NAME(name) #name,
+static const char *const phase_names[PROFILE_PHASES] = {PROFILE_PHASE_LIST(PROFILE_NAME)};
+#undef PROFILE_NAME
+
+/*
+ * Tables live in the registry for the whole run, a thread keeps a pointer
+ * to its own, so nothing dangles when it exits
+ */
+static std::mutex registry_lock;
+static std::list<profile_table> registry;
+
+profile_table *profile_thread(void)
+{
+    static thread_local profile_table *table = NULL;
+
+    if (table == NULL)
+    {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        registry.emplace_back();
+        table = &registry.back();
+        memset(table, 0, sizeof(*table));
+    }
+    return table;
+}
+
+void profile_reset(void)
+{
+    std::lock_guard<std::mutex> guard(registry_lock);
+
+    for (profile_table &t : registry)
+    {
+        memset(&t, 0, sizeof(t));
+    }
+}
+
+static void dump_table(FILE *f, const profile_table *t)
+{
+    for (unsigned ph = 0; ph < PROFILE_PHASES; ph++)
+    {
+        if (t->count[ph] == 0)
+        {
+            continue;
+        }
+        fprintf(f, "  %-16s count %9llu  cycles %12llu  mean %9.0f  log2 hist", phase_names[ph],
+                (unsigned long long)t->count[ph], (unsigned long long)t->cycles[ph],
+                (double)t->cycles[ph] / t->count[ph]);
+        for (unsigned b = 0; b < PROFILE_BUCKETS; b++)
+        {
+            if (t->hist[ph][b])
+                fprintf(f, " %u:%llu", b, (unsigned long long)t->hist[ph][b]);
+        }
+        fprintf(f, "\n");
+    }
+}
+
+void profile_dump(FILE *f)
+{
+    std::lock_guard<std::mutex> guard(registry_lock);
+    static profile_table total;
+    unsigned n = 0;
+
+    memset(&total, 0, sizeof(total));
+    for (const profile_table &t : registry)
+    {
+        fprintf(f, "Thread %u\n", n++);
+        dump_table(f, &t);
+        for (unsigned ph = 0; ph < PROFILE_PHASES; ph++)
+        {
+            total.count[ph] += t.count[ph];
+            total.cycles[ph] += t.cycles[ph];
+            for (unsigned b = 0; b < PROFILE_BUCKETS; b++)
+                total.hist[ph][b] += t.hist[ph][b];
+        }
+    }
+    fprintf(f, "All threads\n");
+    dump_table(f, &total);
+}
+
+#endif
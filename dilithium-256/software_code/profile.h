@@ -0,0 +1,115 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Per-phase profiler, phases named after the states of combined_top.v.
+ * PROFILE_SCOPE(KG_MULT_AS1); times the rest of the enclosing block and
+ * adds it to the histogram of that phase for the calling thread.
+ * Without -DDILITHIUM_PROFILE the macro is an empty statement and none
+ * of the functions below exist.
+ */
+
+#define PROFILE_PHASE_LIST(X)                                                  \
+    X(KG_HASH_Z) X(KG_SAMPLE_S1) X(KG_SAMPLE_S2) X(KG_MULT_AS1) X(KG_NTTI_T)   \
+    X(KG_ADD_T_S2) X(KG_ENCODE_T0) X(KG_UNLOAD_TR)                             \
+    X(VY_LOAD_RHO) X(VY_LOAD_C) X(VY_DECODE_Z) X(VY_NTT_Z) X(VY_NTT_T1)        \
+    X(VY_NTT_C) X(VY_MULT_AZ) X(VY_MULT_CT1) X(VY_SUB_AZ_CT1) X(VY_INTT)       \
+    X(VY_GENW1) X(VY_HASH_CH) X(VY_COMPARE)                                    \
+    X(FSM0_LOAD_RHO) X(FSM0_LOAD_MU) X(FSM0_DECODE_S1) X(FSM0_NTT_S1)          \
+    X(FSM0_NTT_S2) X(FSM0_NTT_T0) X(FSM0_UNLOAD_Z) X(FSM0_UNLOAD_H)            \
+    X(FSM0_UNLOAD_C)                                                           \
+    X(FSM1_GENY) X(FSM1_NTT_Y) X(FSM1_MULT_A_Y) X(FSM1_NTTI_W)                 \
+    X(FSM2_DECOMP) X(FSM2_GEN_C) X(FSM2_NTT_C) X(FSM2_MULTACC)                 \
+    X(FSM2_MULT_CS2) X(FSM2_MULT_CT0) X(FSM2_NTTI_Z) X(FSM2_NTTI_CS2)          \
+    X(FSM2_NTTI_CT0) X(FSM2_SUB_W0_CS2) X(FSM2_MAKEHINT)
+
+#ifdef DILITHIUM_PROFILE
+
+#include <x86intrin.h>
+
+#define PROFILE_ENUM(name) PROFILE_##name,
+enum profile_phase
+{
+    PROFILE_PHASE_LIST(PROFILE_ENUM)
+    PROFILE_PHASES
+};
+#undef PROFILE_ENUM
+
+// Bucket b counts durations in [2^b, 2^(b+1)) cycles
+#define PROFILE_BUCKETS 40
+
+typedef struct
+{
+    uint64_t count[PROFILE_PHASES];
+    uint64_t cycles[PROFILE_PHASES];
+    uint64_t hist[PROFILE_PHASES][PROFILE_BUCKETS];
+} profile_table;
+
+// The table of the calling thread, registered for profile_dump on first use
+profile_table *profile_thread(void);
+
+static inline void profile_add(profile_table *t, enum profile_phase ph, uint64_t cycles)
+{
+    unsigned b = cycles ? 63 - __builtin_clzll(cycles) : 0;
+
+    t->count[ph]++;
+    t->cycles[ph] += cycles;
+    t->hist[ph][b < PROFILE_BUCKETS ? b : PROFILE_BUCKETS - 1]++;
+}
+
+struct profile_scope
+{
+    enum profile_phase ph;
+    uint64_t start;
+
+    explicit profile_scope(enum profile_phase p) : ph(p), start(__rdtsc()) {}
+    ~profile_scope() { profile_add(profile_thread(), ph, __rdtsc() - start); }
+};
+
+#define PROFILE_CAT2(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT2(a, b)
+#define PROFILE_SCOPE(phase) \
+    profile_scope PROFILE_CAT(profile_scope_, __LINE__)(PROFILE_##phase)
+
+// Zero the tables of all threads
+void profile_reset(void);
+
+/*
+ * One histogram block per thread that ever profiled, then the sum over
+ * threads. Call it while the profiled threads are idle.
+ */
+void profile_dump(FILE *f);
+
+#else
+
+#define PROFILE_SCOPE(phase) ((void)0)
+
+#endif
+
+#endif
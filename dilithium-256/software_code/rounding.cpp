@@ -0,0 +1,262 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include "config.h"
+#include "rounding.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define GAMMA2_88 ((DILITHIUM_Q - 1) / 88)
+#define GAMMA2_32 ((DILITHIUM_Q - 1) / 32)
+
+// ================ SCALAR ========================
+
+data_t power2round(data_t *a0, data_t a)
+{
+    data_t a1;
+
+    a1 = (a + (1 << (DILITHIUM_D - 1)) - 1) >> DILITHIUM_D;
+    *a0 = a - (a1 << DILITHIUM_D);
+    return a1;
+}
+
+data_t decompose(data_t *a0, data_t a, data_t gamma2)
+{
+    data_t a1;
+
+    // ceil(a / 128), then multiply-shift instead of division by 2 * gamma2
+    a1 = (a + 127) >> 7;
+    if (gamma2 == GAMMA2_32)
+    {
+        a1 = (a1 * 1025 + (1 << 21)) >> 22;
+        a1 &= 15;
+    }
+    else
+    {
+        a1 = (a1 * 11275 + (1 << 23)) >> 24;
+        // (Q-1) / (2 * gamma2) = 44 wraps to 0
+        a1 ^= ((43 - a1) >> 31) & a1;
+    }
+
+    *a0 = a - a1 * 2 * gamma2;
+    *a0 -= (((DILITHIUM_Q - 1) / 2 - *a0) >> 31) & DILITHIUM_Q;
+    return a1;
+}
+
+data_t make_hint(data_t a0, data_t a1, data_t gamma2)
+{
+    if (a0 > gamma2 || a0 < -gamma2 || (a0 == -gamma2 && a1 != 0))
+    {
+        return 1;
+    }
+    return 0;
+}
+
+data_t use_hint(data_t a, data_t hint, data_t gamma2)
+{
+    data_t a0, a1;
+
+    a1 = decompose(&a0, a, gamma2);
+    if (hint == 0)
+    {
+        return a1;
+    }
+
+    if (gamma2 == GAMMA2_32)
+    {
+        return (a0 > 0) ? (a1 + 1) & 15 : (a1 - 1) & 15;
+    }
+    if (a0 > 0)
+    {
+        return (a1 == 43) ? 0 : a1 + 1;
+    }
+    return (a1 == 0) ? 43 : a1 - 1;
+}
+
+#ifdef __AVX2__
+
+// ================ AVX2 ========================
+
+static inline __m256i decompose_avx(__m256i *a0, __m256i a, data_t gamma2)
+{
+    const __m256i q = _mm256_set1_epi32(DILITHIUM_Q);
+    const __m256i hq = _mm256_set1_epi32((DILITHIUM_Q - 1) / 2);
+    const __m256i g2x2 = _mm256_set1_epi32(2 * gamma2);
+    __m256i a1, t;
+
+    a1 = _mm256_add_epi32(a, _mm256_set1_epi32(127));
+    a1 = _mm256_srai_epi32(a1, 7);
+    if (gamma2 == GAMMA2_32)
+    {
+        a1 = _mm256_mullo_epi32(a1, _mm256_set1_epi32(1025));
+        a1 = _mm256_add_epi32(a1, _mm256_set1_epi32(1 << 21));
+        a1 = _mm256_srai_epi32(a1, 22);
+        a1 = _mm256_and_si256(a1, _mm256_set1_epi32(15));
+    }
+    else
+    {
+        a1 = _mm256_mullo_epi32(a1, _mm256_set1_epi32(11275));
+        a1 = _mm256_add_epi32(a1, _mm256_set1_epi32(1 << 23));
+        a1 = _mm256_srai_epi32(a1, 24);
+        t = _mm256_sub_epi32(_mm256_set1_epi32(43), a1);
+        t = _mm256_srai_epi32(t, 31);
+        a1 = _mm256_xor_si256(a1, _mm256_and_si256(t, a1));
+    }
+
+    t = _mm256_sub_epi32(a, _mm256_mullo_epi32(a1, g2x2));
+    a = _mm256_srai_epi32(_mm256_sub_epi32(hq, t), 31);
+    *a0 = _mm256_sub_epi32(t, _mm256_and_si256(a, q));
+    return a1;
+}
+
+void poly_power2round(poly *a1, poly *a0, const poly *a)
+{
+    const __m256i r = _mm256_set1_epi32((1 << (DILITHIUM_D - 1)) - 1);
+    __m256i f, f1;
+
+    for (unsigned i = 0; i < DILITHIUM_N; i += 8)
+    {
+        f = _mm256_loadu_si256((const __m256i *)&a->coeffs[i]);
+        f1 = _mm256_srai_epi32(_mm256_add_epi32(f, r), DILITHIUM_D);
+        _mm256_storeu_si256((__m256i *)&a1->coeffs[i], f1);
+        f = _mm256_sub_epi32(f, _mm256_slli_epi32(f1, DILITHIUM_D));
+        _mm256_storeu_si256((__m256i *)&a0->coeffs[i], f);
+    }
+}
+
+void poly_decompose(poly *a1, poly *a0, const poly *a, data_t gamma2)
+{
+    __m256i f, f0, f1;
+
+    for (unsigned i = 0; i < DILITHIUM_N; i += 8)
+    {
+        f = _mm256_loadu_si256((const __m256i *)&a->coeffs[i]);
+        f1 = decompose_avx(&f0, f, gamma2);
+        _mm256_storeu_si256((__m256i *)&a1->coeffs[i], f1);
+        _mm256_storeu_si256((__m256i *)&a0->coeffs[i], f0);
+    }
+}
+
+unsigned poly_make_hint(poly *h, const poly *a0, const poly *a1, data_t gamma2)
+{
+    const __m256i g2 = _mm256_set1_epi32(gamma2);
+    const __m256i ng2 = _mm256_set1_epi32(-gamma2);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i f0, f1, g, t;
+    unsigned n = 0;
+
+    for (unsigned i = 0; i < DILITHIUM_N; i += 8)
+    {
+        f0 = _mm256_loadu_si256((const __m256i *)&a0->coeffs[i]);
+        f1 = _mm256_loadu_si256((const __m256i *)&a1->coeffs[i]);
+
+        // a0 > gamma2 || a0 < -gamma2 || (a0 == -gamma2 && a1 != 0)
+        g = _mm256_cmpgt_epi32(f0, g2);
+        g = _mm256_or_si256(g, _mm256_cmpgt_epi32(ng2, f0));
+        t = _mm256_andnot_si256(_mm256_cmpeq_epi32(f1, zero),
+                                _mm256_cmpeq_epi32(f0, ng2));
+        g = _mm256_or_si256(g, t);
+
+        n += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(g)));
+        _mm256_storeu_si256((__m256i *)&h->coeffs[i], _mm256_and_si256(g, one));
+    }
+    return n;
+}
+
+void poly_use_hint(poly *b, const poly *a, const poly *h, data_t gamma2)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i f, f0, f1, g, d;
+
+    for (unsigned i = 0; i < DILITHIUM_N; i += 8)
+    {
+        f = _mm256_loadu_si256((const __m256i *)&a->coeffs[i]);
+        g = _mm256_loadu_si256((const __m256i *)&h->coeffs[i]);
+        f1 = decompose_avx(&f0, f, gamma2);
+
+        // d = hint ? (a0 > 0 ? 1 : -1) : 0
+        d = _mm256_and_si256(_mm256_cmpgt_epi32(f0, zero), _mm256_set1_epi32(2));
+        d = _mm256_sub_epi32(d, _mm256_set1_epi32(1));
+        d = _mm256_sign_epi32(d, g);
+        f1 = _mm256_add_epi32(f1, d);
+
+        if (gamma2 == GAMMA2_32)
+        {
+            f1 = _mm256_and_si256(f1, _mm256_set1_epi32(15));
+        }
+        else
+        {
+            // 44 -> 0, -1 -> 43
+            f1 = _mm256_andnot_si256(_mm256_cmpeq_epi32(f1, _mm256_set1_epi32(44)), f1);
+            f1 = _mm256_blendv_epi8(f1, _mm256_set1_epi32(43),
+                                    _mm256_cmpgt_epi32(zero, f1));
+        }
+        _mm256_storeu_si256((__m256i *)&b->coeffs[i], f1);
+    }
+}
+
+#else
+
+// ================ SCALAR FALLBACK ========================
+
+void poly_power2round(poly *a1, poly *a0, const poly *a)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        a1->coeffs[i] = power2round(&a0->coeffs[i], a->coeffs[i]);
+    }
+}
+
+void poly_decompose(poly *a1, poly *a0, const poly *a, data_t gamma2)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        a1->coeffs[i] = decompose(&a0->coeffs[i], a->coeffs[i], gamma2);
+    }
+}
+
+unsigned poly_make_hint(poly *h, const poly *a0, const poly *a1, data_t gamma2)
+{
+    unsigned n = 0;
+
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        h->coeffs[i] = make_hint(a0->coeffs[i], a1->coeffs[i], gamma2);
+        n += h->coeffs[i];
+    }
+    return n;
+}
+
+void poly_use_hint(poly *b, const poly *a, const poly *h, data_t gamma2)
+{
+    for (unsigned i = 0; i < DILITHIUM_N; ++i)
+    {
+        b->coeffs[i] = use_hint(a->coeffs[i], h->coeffs[i], gamma2);
+    }
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef ROUNDING_H
+#define ROUNDING_H
+
+#include <stdint.h>
+#include "config.h"
+
+/*
+ * Scalar kernels, also the golden model of the poly_* versions.
+ * Inputs a are standard representatives in [0, Q).
+ */
+
+// a = a1 * 2^D + a0, -2^(D-1) < a0 <= 2^(D-1)
+data_t power2round(data_t *a0, data_t a);
+
+// a = a1 * 2 * GAMMA2 + a0, -GAMMA2 < a0 <= GAMMA2, as in decomp_map1.v
+data_t decompose(data_t *a0, data_t a, data_t gamma2);
+
+// 1 if the low part a0 carries into the high part a1, as in makehint.v
+data_t make_hint(data_t a0, data_t a1, data_t gamma2);
+
+// Corrected high bits of a, as in usehint.v
+data_t use_hint(data_t a, data_t hint, data_t gamma2);
+
+/*
+ * Polynomial kernels, AVX2 when available.
+ * Division by 2 * GAMMA2 is done with multiply-shift for
+ * GAMMA2 = (Q-1)/88 and (Q-1)/32, without branches.
+ */
+
+void poly_power2round(poly *a1, poly *a0, const poly *a);
+
+void poly_decompose(poly *a1, poly *a0, const poly *a, data_t gamma2);
+
+// Return the number of hints set, i.e. popcount of h
+unsigned poly_make_hint(poly *h, const poly *a0, const poly *a1, data_t gamma2);
+
+void poly_use_hint(poly *b, const poly *a, const poly *h, data_t gamma2);
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "rounding.h"
+#include "poly.h"
+
+#define TESTS 1000000
+
+/*
+ * Decompose from the specification, with the division by 2 * gamma2
+ */
+static data_t decompose_gold(data_t *a0, data_t a, data_t gamma2)
+{
+    data_t t = a % (2 * gamma2);
+    if (t > gamma2)
+        t -= 2 * gamma2;
+
+    if (a - t == DILITHIUM_Q - 1)
+    {
+        *a0 = t - 1;
+        return 0;
+    }
+    *a0 = t;
+    return (a - t) / (2 * gamma2);
+}
+
+// Every a in [0, Q), poly kernels against scalar, scalar against specification
+static int test_decompose(data_t gamma2)
+{
+    poly a, a1, a0, p1, p0;
+    data_t t0, t1, g0, g1;
+
+    for (data_t base = 0; base < DILITHIUM_Q; base += DILITHIUM_N)
+    {
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            a.coeffs[i] = (base + i < DILITHIUM_Q) ? base + i : 0;
+        }
+        poly_decompose(&a1, &a0, &a, gamma2);
+        poly_power2round(&p1, &p0, &a);
+
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            t1 = decompose(&t0, a.coeffs[i], gamma2);
+            g1 = decompose_gold(&g0, a.coeffs[i], gamma2);
+            if (t1 != g1 || t0 != g0 || a1.coeffs[i] != t1 || a0.coeffs[i] != t0)
+            {
+                printf("decompose(%d): gold %d %d, scalar %d %d, poly %d %d\n",
+                       a.coeffs[i], g1, g0, t1, t0, a1.coeffs[i], a0.coeffs[i]);
+                return 1;
+            }
+
+            t1 = power2round(&t0, a.coeffs[i]);
+            if (p1.coeffs[i] != t1 || p0.coeffs[i] != t0 ||
+                (t1 << DILITHIUM_D) + t0 != a.coeffs[i])
+            {
+                printf("power2round(%d)\n", a.coeffs[i]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_use_hint(data_t gamma2)
+{
+    poly a, h, b;
+
+    for (data_t base = 0; base < DILITHIUM_Q; base += DILITHIUM_N)
+    {
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            a.coeffs[i] = (base + i < DILITHIUM_Q) ? base + i : 0;
+            h.coeffs[i] = (i ^ (base >> 8)) & 1;
+        }
+        poly_use_hint(&b, &a, &h, gamma2);
+
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            if (b.coeffs[i] != use_hint(a.coeffs[i], h.coeffs[i], gamma2))
+            {
+                printf("use_hint(%d, %d)\n", a.coeffs[i], h.coeffs[i]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Hints as in sign and verify: a0 = LowBits(w) - e + f, a1 = HighBits(w),
+ * then UseHint(h, w - e + f) must give back HighBits(w).
+ */
+static int test_make_hint(data_t gamma2, data_t beta)
+{
+    poly w, w1, w0, r, h, b;
+    data_t e[DILITHIUM_N], f, t0;
+    unsigned n, n_gold;
+
+    for (int j = 0; j < TESTS / DILITHIUM_N; j++)
+    {
+        // Same bounds as the r0 and ct0 checks of the signing loop
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            do
+            {
+                w.coeffs[i] = rand() % DILITHIUM_Q;
+                e[i] = rand() % (2 * beta + 1) - beta;
+                decompose(&t0, w.coeffs[i], gamma2);
+            } while (t0 - e[i] >= gamma2 - beta || t0 - e[i] <= beta - gamma2);
+        }
+        poly_decompose(&w1, &w0, &w, gamma2);
+
+        n_gold = 0;
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            f = rand() % (2 * gamma2 - 1) - (gamma2 - 1);
+            if ((j & 7) == 0)
+                f = (i & 1) ? gamma2 - 1 : 1 - gamma2;
+
+            w0.coeffs[i] += f - e[i];
+            r.coeffs[i] = ((w.coeffs[i] - e[i] + f) % DILITHIUM_Q + DILITHIUM_Q) % DILITHIUM_Q;
+            n_gold += make_hint(w0.coeffs[i], w1.coeffs[i], gamma2);
+        }
+
+        n = poly_make_hint(&h, &w0, &w1, gamma2);
+        poly_use_hint(&b, &r, &h, gamma2);
+
+        if (n != n_gold)
+        {
+            printf("make_hint count %u != %u\n", n, n_gold);
+            return 1;
+        }
+        for (int i = 0; i < DILITHIUM_N; i++)
+        {
+            if (h.coeffs[i] != make_hint(w0.coeffs[i], w1.coeffs[i], gamma2) ||
+                b.coeffs[i] != w1.coeffs[i])
+            {
+                printf("make_hint(%d, %d) = %d, use_hint = %d != %d\n",
+                       w0.coeffs[i], w1.coeffs[i], h.coeffs[i], b.coeffs[i], w1.coeffs[i]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Norm check of whole vectors against a coefficient-wise scan.
+ * One coefficient of one polynomial is pushed to +-(bound - 1) or +-bound,
+ * covering every block boundary and the sign of the violation.
+ */
+static int test_chknorm(data_t bound)
+{
+    poly v[L_MAX];
+    unsigned k, i;
+    int r, r_gold;
+
+    for (int j = 0; j < TESTS / DILITHIUM_N; j++)
+    {
+        for (k = 0; k < L_MAX; k++)
+            for (i = 0; i < DILITHIUM_N; i++)
+                v[k].coeffs[i] = rand() % (2 * bound - 1) - (bound - 1);
+
+        k = rand() % L_MAX;
+        i = rand() % DILITHIUM_N;
+        v[k].coeffs[i] = bound - (j & 1);
+        if (j & 2)
+            v[k].coeffs[i] = -v[k].coeffs[i];
+        if ((j & 12) == 0)
+            v[k].coeffs[i] = (j & 16) ? DILITHIUM_Q : -DILITHIUM_Q;
+
+        r_gold = 0;
+        for (k = 0; k < L_MAX; k++)
+            for (i = 0; i < DILITHIUM_N; i++)
+                r_gold |= v[k].coeffs[i] >= bound || v[k].coeffs[i] <= -bound;
+
+        r = polyvec_chknorm(v, L_MAX, bound);
+        if (r != r_gold)
+        {
+            printf("chknorm bound %d: %d != %d\n", bound, r, r_gold);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    const dilithium_params *p2 = get_params(2), *p3 = get_params(3);
+    int ret = 0;
+    srand(0);
+
+    printf("Test decompose/power2round, all coefficients :");
+    ret |= test_decompose(p2->GAMMA2);
+    ret |= test_decompose(p3->GAMMA2);
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test use_hint, all coefficients :");
+    ret |= test_use_hint(p2->GAMMA2);
+    ret |= test_use_hint(p3->GAMMA2);
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test make_hint = %u :", TESTS);
+    ret |= test_make_hint(p2->GAMMA2, p2->BETA);
+    ret |= test_make_hint(p3->GAMMA2, p3->BETA);
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test chknorm = %u :", TESTS / DILITHIUM_N);
+    ret |= test_chknorm(p2->GAMMA1 - p2->BETA);
+    ret |= test_chknorm(p3->GAMMA1 - p3->BETA);
+    ret |= test_chknorm(p2->GAMMA2 - p2->BETA);
+    ret |= test_chknorm(p3->GAMMA2);
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    return ret;
+}
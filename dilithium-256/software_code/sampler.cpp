@@ -0,0 +1,299 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include "config.h"
+#include "fips202.h"
+#include "sampler.h"
+
+/*
+ * Serial-in parallel-out view over the rate lanes of a Keccak state,
+ * the software counterpart of SIPO_IN in rejection_y.v.
+ * acc holds `len` unread bits, new lanes are shifted in on the left.
+ */
+typedef struct
+{
+    keccak_state *state;
+    unsigned lane;
+    unsigned rate_lanes;
+    uint64_t acc;
+    unsigned len;
+} lane_sipo;
+
+static inline void sipo_init(lane_sipo *sipo, keccak_state *state, unsigned rate)
+{
+    sipo->state = state;
+    sipo->rate_lanes = rate / 8;
+    sipo->lane = sipo->rate_lanes;
+    sipo->acc = 0;
+    sipo->len = 0;
+}
+
+static inline uint64_t sipo_next_lane(lane_sipo *sipo)
+{
+    if (sipo->lane == sipo->rate_lanes)
+    {
+        KeccakF1600_StatePermute(sipo->state->s);
+        sipo->lane = 0;
+    }
+    return sipo->state->s[sipo->lane++];
+}
+
+// Pop the next `width` bits (width < 64), little-endian as in the byte stream
+static inline uint32_t sipo_pop(lane_sipo *sipo, unsigned width)
+{
+    const uint64_t mask = (1ULL << width) - 1;
+    uint64_t lane, t;
+
+    if (sipo->len >= width)
+    {
+        t = sipo->acc & mask;
+        sipo->acc >>= width;
+        sipo->len -= width;
+    }
+    else
+    {
+        lane = sipo_next_lane(sipo);
+        t = (sipo->acc | (lane << sipo->len)) & mask;
+        sipo->acc = lane >> (width - sipo->len);
+        sipo->len = 64 - (width - sipo->len);
+    }
+    return (uint32_t)t;
+}
+
+static inline void absorb_seed_nonce(keccak_state *state, unsigned rate,
+                                     const uint8_t *seed, unsigned seedlen,
+                                     uint16_t nonce)
+{
+    // Seed and nonce are XORed into the lanes, no seed||nonce copy is built
+    for (unsigned i = 0; i < KECCAK_LANES; i++)
+    {
+        state->s[i] = 0;
+    }
+    for (unsigned i = 0; i < seedlen; i++)
+    {
+        state->s[i / 8] ^= (uint64_t)seed[i] << 8 * (i % 8);
+    }
+    state->s[seedlen / 8] ^= (uint64_t)nonce << 8 * (seedlen % 8);
+
+    // SHAKE padding, seedlen + 2 < rate for every caller
+    state->s[(seedlen + 2) / 8] ^= 0x1FULL << 8 * ((seedlen + 2) % 8);
+    state->s[rate / 8 - 1] ^= 1ULL << 63;
+    state->pos = rate;
+}
+
+// ================ ExpandA ========================
+
+/*
+ * Rejection sampling of 23-bit candidates, 3 lanes at a time.
+ * 3 lanes = 24 bytes = 8 candidates, and SHAKE128_RATE = 7 * 24 bytes,
+ * so a candidate never straddles two squeezed blocks.
+ */
+void poly_uniform(poly *a, const uint8_t rho[SEEDBYTES], uint16_t nonce)
+{
+    keccak_state state;
+    uint64_t l0, l1, l2;
+    uint32_t t[8];
+    unsigned ctr = 0;
+
+    absorb_seed_nonce(&state, SHAKE128_RATE, rho, SEEDBYTES, nonce);
+
+    while (ctr < DILITHIUM_N)
+    {
+        KeccakF1600_StatePermute(state.s);
+
+        for (unsigned i = 0; i < SHAKE128_RATE / 8 && ctr < DILITHIUM_N; i += 3)
+        {
+            l0 = state.s[i + 0];
+            l1 = state.s[i + 1];
+            l2 = state.s[i + 2];
+
+            t[0] = (uint32_t)l0;
+            t[1] = (uint32_t)(l0 >> 24);
+            t[2] = (uint32_t)((l0 >> 48) | (l1 << 16));
+            t[3] = (uint32_t)(l1 >> 8);
+            t[4] = (uint32_t)(l1 >> 32);
+            t[5] = (uint32_t)((l1 >> 56) | (l2 << 8));
+            t[6] = (uint32_t)(l2 >> 16);
+            t[7] = (uint32_t)(l2 >> 40);
+
+            for (unsigned k = 0; k < 8 && ctr < DILITHIUM_N; k++)
+            {
+                t[k] &= 0x7FFFFF;
+                if (t[k] < DILITHIUM_Q)
+                {
+                    a->coeffs[ctr++] = t[k];
+                }
+            }
+        }
+    }
+}
+
+// ================ ExpandS ========================
+
+void poly_uniform_eta(poly *a, const uint8_t seed[CRHBYTES], uint16_t nonce,
+                      data_t eta)
+{
+    keccak_state state;
+    uint64_t lane;
+    uint32_t t;
+    unsigned ctr = 0;
+
+    absorb_seed_nonce(&state, SHAKE256_RATE, seed, CRHBYTES, nonce);
+
+    while (ctr < DILITHIUM_N)
+    {
+        KeccakF1600_StatePermute(state.s);
+
+        for (unsigned i = 0; i < SHAKE256_RATE / 8 && ctr < DILITHIUM_N; i++)
+        {
+            lane = state.s[i];
+            // 16 nibbles per lane, low nibble of each byte first
+            for (unsigned k = 0; k < 16 && ctr < DILITHIUM_N; k++, lane >>= 4)
+            {
+                t = lane & 0xF;
+                if (eta == 2)
+                {
+                    if (t < 15)
+                    {
+                        // t mod 5 without a division
+                        t = t - ((205 * t) >> 10) * 5;
+                        a->coeffs[ctr++] = 2 - (data_t)t;
+                    }
+                }
+                else if (t < 9)
+                {
+                    a->coeffs[ctr++] = 4 - (data_t)t;
+                }
+            }
+        }
+    }
+}
+
+// ================ ExpandMask ========================
+
+void poly_uniform_gamma1(poly *a, const uint8_t seed[CRHBYTES], uint16_t nonce,
+                         data_t gamma1)
+{
+    keccak_state state;
+    lane_sipo sipo;
+    const unsigned width = (gamma1 == (1 << 17)) ? 18 : 20;
+
+    absorb_seed_nonce(&state, SHAKE256_RATE, seed, CRHBYTES, nonce);
+    sipo_init(&sipo, &state, SHAKE256_RATE);
+
+    for (unsigned i = 0; i < DILITHIUM_N; i++)
+    {
+        a->coeffs[i] = gamma1 - (data_t)sipo_pop(&sipo, width);
+    }
+}
+
+void poly_uniform_gamma1_4x(poly *const a[4], const uint8_t *const seed[4],
+                            const uint16_t nonce[4], data_t gamma1)
+{
+    keccak_state4x state;
+    keccak_state one;
+    const unsigned width = (gamma1 == (1 << 17)) ? 18 : 20;
+    const uint64_t mask = (1ULL << width) - 1;
+    uint64_t acc[4] = {0}, lane;
+    unsigned len[4] = {0}, ctr = 0, n;
+
+    for (unsigned k = 0; k < 4; k++)
+    {
+        absorb_seed_nonce(&one, SHAKE256_RATE, seed[k], CRHBYTES, nonce[k]);
+        for (unsigned i = 0; i < KECCAK_LANES; i++)
+        {
+            state.s[i][k] = one.s[i];
+        }
+    }
+
+    // Same bit stream as lane_sipo, one block of all four states per pass
+    while (ctr < DILITHIUM_N)
+    {
+        KeccakF1600_StatePermute4x(&state);
+        for (unsigned k = 0; k < 4; k++)
+        {
+            n = ctr;
+            for (unsigned i = 0; i < SHAKE256_RATE / 8 && n < DILITHIUM_N; i++)
+            {
+                // len < width bits are left over from the previous lane
+                lane = state.s[i][k];
+                a[k]->coeffs[n++] = gamma1 - (data_t)((acc[k] | (lane << len[k])) & mask);
+                acc[k] = lane >> (width - len[k]);
+                len[k] = 64 - (width - len[k]);
+                while (len[k] >= width && n < DILITHIUM_N)
+                {
+                    a[k]->coeffs[n++] = gamma1 - (data_t)(acc[k] & mask);
+                    acc[k] >>= width;
+                    len[k] -= width;
+                }
+            }
+        }
+        ctr = n;
+    }
+}
+
+void expand_a(poly mat[K_MAX][L_MAX], const uint8_t rho[SEEDBYTES],
+              const dilithium_params *p)
+{
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        for (unsigned j = 0; j < p->L; ++j)
+        {
+            poly_uniform(&mat[i][j], rho, (uint16_t)((i << 8) + j));
+        }
+    }
+}
+
+void expand_s(poly s1[L_MAX], poly s2[K_MAX], const uint8_t rhoprime[CRHBYTES],
+              const dilithium_params *p)
+{
+    for (unsigned i = 0; i < p->L; ++i)
+    {
+        poly_uniform_eta(&s1[i], rhoprime, (uint16_t)i, p->ETA);
+    }
+    for (unsigned i = 0; i < p->K; ++i)
+    {
+        poly_uniform_eta(&s2[i], rhoprime, (uint16_t)(p->L + i), p->ETA);
+    }
+}
+
+void expand_mask(poly y[L_MAX], const uint8_t rhoprime[CRHBYTES], uint16_t kappa,
+                 const dilithium_params *p)
+{
+    poly spare;
+    poly *a[4];
+    const uint8_t *seed[4] = {rhoprime, rhoprime, rhoprime, rhoprime};
+    uint16_t nonce[4];
+
+    // The slots past L of the last group sample into a spare polynomial
+    for (unsigned i = 0; i < p->L; i += 4)
+    {
+        for (unsigned k = 0; k < 4; k++)
+        {
+            a[k] = (i + k < p->L) ? &y[i + k] : &spare;
+            nonce[k] = (uint16_t)(kappa + i + k);
+        }
+        poly_uniform_gamma1_4x(a, seed, nonce, p->GAMMA1);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdint.h>
+#include "config.h"
+
+/*
+ * Fused squeeze-and-sample.
+ * Each sampler permutes the Keccak state in place and consumes the rate
+ * lanes directly, the way rejection_a.v / rejection_y.v consume `dout`.
+ * No output block is copied to a byte buffer and nothing is allocated.
+ */
+
+void poly_uniform(poly *a, const uint8_t rho[SEEDBYTES], uint16_t nonce);
+
+void poly_uniform_eta(poly *a, const uint8_t seed[CRHBYTES], uint16_t nonce,
+                      data_t eta);
+
+void poly_uniform_gamma1(poly *a, const uint8_t seed[CRHBYTES], uint16_t nonce,
+                         data_t gamma1);
+
+/*
+ * Four poly_uniform_gamma1 at once on the four-way Keccak, each with its
+ * own seed and nonce. ExpandMask squeezes a fixed number of blocks, so
+ * the four states stay in step.
+ */
+void poly_uniform_gamma1_4x(poly *const a[4], const uint8_t *const seed[4],
+                            const uint16_t nonce[4], data_t gamma1);
+
+// ExpandA: mat[i][j] = poly_uniform(rho, (i << 8) + j), already in NTT domain
+void expand_a(poly mat[K_MAX][L_MAX], const uint8_t rho[SEEDBYTES],
+              const dilithium_params *p);
+
+// ExpandS: s1[i] with nonce i, s2[i] with nonce L + i
+void expand_s(poly s1[L_MAX], poly s2[K_MAX], const uint8_t rhoprime[CRHBYTES],
+              const dilithium_params *p);
+
+// ExpandMask: y[i] with nonce kappa + i, four at a time
+void expand_mask(poly y[L_MAX], const uint8_t rhoprime[CRHBYTES], uint16_t kappa,
+                 const dilithium_params *p);
+
+#endif
@@ -0,0 +1,327 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "fips202.h"
+#include "sampler.h"
+#include "kat.h"
+
+#define TESTS 10000
+
+/*
+ * Buffered samplers: squeeze whole blocks into bytes, then parse.
+ * Straight from the specification, used as golden model.
+ */
+static void absorb_seed_nonce_gold(keccak_state *state, int shake256_mode,
+                                   const uint8_t *seed, unsigned seedlen,
+                                   uint16_t nonce)
+{
+    uint8_t t[2] = {(uint8_t)nonce, (uint8_t)(nonce >> 8)};
+    if (shake256_mode)
+    {
+        shake256_init(state);
+        shake256_absorb(state, seed, seedlen);
+        shake256_absorb(state, t, 2);
+        shake256_finalize(state);
+    }
+    else
+    {
+        shake128_init(state);
+        shake128_absorb(state, seed, seedlen);
+        shake128_absorb(state, t, 2);
+        shake128_finalize(state);
+    }
+}
+
+static void poly_uniform_gold(poly *a, const uint8_t rho[SEEDBYTES], uint16_t nonce)
+{
+    keccak_state state;
+    uint8_t buf[SHAKE128_RATE];
+    uint32_t t;
+    unsigned ctr = 0, pos;
+
+    absorb_seed_nonce_gold(&state, 0, rho, SEEDBYTES, nonce);
+    while (ctr < DILITHIUM_N)
+    {
+        shake128_squeezeblocks(buf, 1, &state);
+        pos = 0;
+        while (ctr < DILITHIUM_N && pos + 3 <= SHAKE128_RATE)
+        {
+            t = buf[pos] | (uint32_t)buf[pos + 1] << 8 | (uint32_t)buf[pos + 2] << 16;
+            t &= 0x7FFFFF;
+            pos += 3;
+            if (t < DILITHIUM_Q)
+                a->coeffs[ctr++] = t;
+        }
+    }
+}
+
+static void poly_uniform_eta_gold(poly *a, const uint8_t seed[CRHBYTES],
+                                  uint16_t nonce, data_t eta)
+{
+    keccak_state state;
+    uint8_t buf[SHAKE256_RATE];
+    uint32_t t[2];
+    unsigned ctr = 0;
+
+    absorb_seed_nonce_gold(&state, 1, seed, CRHBYTES, nonce);
+    while (ctr < DILITHIUM_N)
+    {
+        shake256_squeezeblocks(buf, 1, &state);
+        for (unsigned pos = 0; pos < SHAKE256_RATE && ctr < DILITHIUM_N; pos++)
+        {
+            t[0] = buf[pos] & 0x0F;
+            t[1] = buf[pos] >> 4;
+            for (unsigned k = 0; k < 2 && ctr < DILITHIUM_N; k++)
+            {
+                if (eta == 2 && t[k] < 15)
+                    a->coeffs[ctr++] = 2 - (data_t)(t[k] % 5);
+                else if (eta == 4 && t[k] < 9)
+                    a->coeffs[ctr++] = 4 - (data_t)t[k];
+            }
+        }
+    }
+}
+
+static void poly_uniform_gamma1_gold(poly *a, const uint8_t seed[CRHBYTES],
+                                     uint16_t nonce, data_t gamma1)
+{
+    keccak_state state;
+    uint8_t buf[5 * SHAKE256_RATE];
+    const unsigned width = (gamma1 == (1 << 17)) ? 18 : 20;
+    unsigned bit;
+    uint32_t t;
+
+    absorb_seed_nonce_gold(&state, 1, seed, CRHBYTES, nonce);
+    shake256_squeezeblocks(buf, 5, &state);
+    for (unsigned i = 0; i < DILITHIUM_N; i++)
+    {
+        t = 0;
+        for (unsigned b = 0; b < width; b++)
+        {
+            bit = i * width + b;
+            t |= (uint32_t)((buf[bit / 8] >> (bit % 8)) & 1) << b;
+        }
+        a->coeffs[i] = gamma1 - (data_t)t;
+    }
+}
+
+static int compare_poly(const poly *a, const poly *b, const char *string)
+{
+    for (int i = 0; i < DILITHIUM_N; i++)
+    {
+        if (a->coeffs[i] != b->coeffs[i])
+        {
+            printf("%s: [%d] %d != %d\n", string, i, a->coeffs[i], b->coeffs[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int test_shake()
+{
+    // SHAKE128("") and SHAKE256("abc"), first 32 bytes
+    const uint8_t gold128[32] = {
+        0x7f, 0x9c, 0x2b, 0xa4, 0xe8, 0x8f, 0x82, 0x7d, 0x61, 0x60, 0x45, 0x50,
+        0x76, 0x05, 0x85, 0x3e, 0xd7, 0x3b, 0x80, 0x93, 0xf6, 0xef, 0xbc, 0x88,
+        0xeb, 0x1a, 0x6e, 0xac, 0xfa, 0x66, 0xef, 0x26};
+    const uint8_t gold256[32] = {
+        0x48, 0x33, 0x66, 0x60, 0x13, 0x60, 0xa8, 0x77, 0x1c, 0x68, 0x63, 0x08,
+        0x0c, 0xc4, 0x11, 0x4d, 0x8d, 0xb4, 0x45, 0x30, 0xf8, 0xf1, 0xe1, 0xee,
+        0x4f, 0x94, 0xea, 0x37, 0xe7, 0x8b, 0x57, 0x39};
+    uint8_t out[32];
+
+    shake128(out, 32, NULL, 0);
+    if (memcmp(out, gold128, 32))
+        return 1;
+
+    shake256(out, 32, (const uint8_t *)"abc", 3);
+    if (memcmp(out, gold256, 32))
+        return 1;
+
+    return 0;
+}
+
+static int test_fused()
+{
+    uint8_t seed[CRHBYTES];
+    uint16_t nonce;
+    poly a, a_gold;
+    int ret = 0;
+
+    for (int j = 0; j < TESTS && !ret; j++)
+    {
+        for (int i = 0; i < CRHBYTES; i++)
+        {
+            seed[i] = rand() & 0xFF;
+        }
+        nonce = rand() & 0xFFFF;
+
+        poly_uniform(&a, seed, nonce);
+        poly_uniform_gold(&a_gold, seed, nonce);
+        ret |= compare_poly(&a_gold, &a, "poly_uniform");
+
+        poly_uniform_eta(&a, seed, nonce, 2);
+        poly_uniform_eta_gold(&a_gold, seed, nonce, 2);
+        ret |= compare_poly(&a_gold, &a, "poly_uniform_eta 2");
+
+        poly_uniform_eta(&a, seed, nonce, 4);
+        poly_uniform_eta_gold(&a_gold, seed, nonce, 4);
+        ret |= compare_poly(&a_gold, &a, "poly_uniform_eta 4");
+
+        poly_uniform_gamma1(&a, seed, nonce, 1 << 17);
+        poly_uniform_gamma1_gold(&a_gold, seed, nonce, 1 << 17);
+        ret |= compare_poly(&a_gold, &a, "poly_uniform_gamma1 17");
+
+        poly_uniform_gamma1(&a, seed, nonce, 1 << 19);
+        poly_uniform_gamma1_gold(&a_gold, seed, nonce, 1 << 19);
+        ret |= compare_poly(&a_gold, &a, "poly_uniform_gamma1 19");
+    }
+    return ret;
+}
+
+/*
+ * Four-way ExpandMask against four single ones, with a different seed
+ * and nonce per slot
+ */
+static int test_gamma1_4x()
+{
+    uint8_t seed[4][CRHBYTES];
+    const uint8_t *seeds[4] = {seed[0], seed[1], seed[2], seed[3]};
+    uint16_t nonce[4];
+    poly a[4], a_gold;
+    poly *const as[4] = {&a[0], &a[1], &a[2], &a[3]};
+    const data_t gamma1[2] = {1 << 17, 1 << 19};
+    int ret = 0;
+
+    for (int j = 0; j < TESTS / 4 && !ret; j++)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            for (int i = 0; i < CRHBYTES; i++)
+            {
+                seed[k][i] = rand() & 0xFF;
+            }
+            nonce[k] = rand() & 0xFFFF;
+        }
+        for (int g = 0; g < 2; g++)
+        {
+            poly_uniform_gamma1_4x(as, seeds, nonce, gamma1[g]);
+            for (int k = 0; k < 4; k++)
+            {
+                poly_uniform_gamma1_gold(&a_gold, seed[k], nonce[k], gamma1[g]);
+                ret |= compare_poly(&a_gold, &a[k], "poly_uniform_gamma1_4x");
+            }
+        }
+    }
+    return ret;
+}
+
+/*
+ * ExpandS against s1_*.txt and s2_*.txt, from the keygen seed in z_*.txt
+ */
+static int pack_eta_compare(const poly *s, unsigned n, data_t eta, const uint8_t *gold)
+{
+    const unsigned width = (eta == 2) ? 3 : 4;
+    unsigned bit;
+    uint32_t t;
+
+    for (unsigned k = 0; k < n; k++)
+    {
+        for (unsigned i = 0; i < DILITHIUM_N; i++)
+        {
+            t = 0;
+            for (unsigned b = 0; b < width; b++)
+            {
+                bit = (k * DILITHIUM_N + i) * width + b;
+                t |= (uint32_t)((gold[bit / 8] >> (bit % 8)) & 1) << b;
+            }
+            if ((data_t)t != eta - s[k].coeffs[i])
+                return 1;
+        }
+    }
+    return 0;
+}
+
+static int test_expand_s_kat()
+{
+    const int levels[3] = {2, 3, 5};
+    uint8_t zeta[SEEDBYTES], seedbuf[2 * SEEDBYTES + CRHBYTES];
+    uint8_t s1_gold[L_MAX * DILITHIUM_N / 2], s2_gold[K_MAX * DILITHIUM_N / 2];
+    poly s1[L_MAX], s2[K_MAX];
+    const dilithium_params *p;
+
+    for (int l = 0; l < 3; l++)
+    {
+        p = get_params(levels[l]);
+        for (unsigned t = 0; t < KAT_NUM; t++)
+        {
+            if (read_kat(zeta, SEEDBYTES, "z", p->sec_lvl, t) != SEEDBYTES ||
+                read_kat(s1_gold, sizeof(s1_gold), "s1", p->sec_lvl, t) < 0 ||
+                read_kat(s2_gold, sizeof(s2_gold), "s2", p->sec_lvl, t) < 0)
+                return 1;
+
+            // rho || rhoprime || key
+            shake256(seedbuf, sizeof(seedbuf), zeta, SEEDBYTES);
+            expand_s(s1, s2, seedbuf + SEEDBYTES, p);
+
+            if (pack_eta_compare(s1, p->L, p->ETA, s1_gold) ||
+                pack_eta_compare(s2, p->K, p->ETA, s2_gold))
+            {
+                printf("ExpandS level %d, KAT %u\n", p->sec_lvl, t);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    int ret = 0;
+    srand(0);
+
+    printf("Test SHAKE128/256 :");
+    ret |= test_shake();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test fused samplers = %u :", TESTS);
+    ret |= test_fused();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test four-way ExpandMask = %u :", TESTS / 4);
+    ret |= test_gamma1_4x();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    printf("Test ExpandS KAT :");
+    ret |= test_expand_s_kat();
+    printf(ret ? "ERROR\n" : "OK\n");
+
+    return ret;
+}
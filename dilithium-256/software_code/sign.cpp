@@ -0,0 +1,86 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include "config.h"
+#include "randombytes.h"
+#include "sign_level.h"
+#include "sign.h"
+
+int crypto_sign_keypair_seed(uint8_t *pk, uint8_t *sk, const uint8_t seed[SEEDBYTES],
+                             int sec_lvl)
+{
+    switch (sec_lvl)
+    {
+    case 2:
+        return crypto_sign_keypair_lvl<2>(pk, sk, seed);
+    case 3:
+        return crypto_sign_keypair_lvl<3>(pk, sk, seed);
+    case 5:
+        return crypto_sign_keypair_lvl<5>(pk, sk, seed);
+    default:
+        return -1;
+    }
+}
+
+int crypto_sign_keypair(uint8_t *pk, uint8_t *sk, int sec_lvl)
+{
+    uint8_t seed[SEEDBYTES];
+
+    randombytes(seed, SEEDBYTES);
+    return crypto_sign_keypair_seed(pk, sk, seed, sec_lvl);
+}
+
+int crypto_sign_signature(uint8_t *sig, size_t *siglen,
+                          const uint8_t *m, size_t mlen,
+                          const uint8_t *sk, int sec_lvl)
+{
+    switch (sec_lvl)
+    {
+    case 2:
+        return crypto_sign_signature_lvl<2>(sig, siglen, m, mlen, sk);
+    case 3:
+        return crypto_sign_signature_lvl<3>(sig, siglen, m, mlen, sk);
+    case 5:
+        return crypto_sign_signature_lvl<5>(sig, siglen, m, mlen, sk);
+    default:
+        return -1;
+    }
+}
+
+int crypto_sign_verify(const uint8_t *sig, size_t siglen,
+                       const uint8_t *m, size_t mlen,
+                       const uint8_t *pk, int sec_lvl)
+{
+    switch (sec_lvl)
+    {
+    case 2:
+        return crypto_sign_verify_lvl<2>(sig, siglen, m, mlen, pk);
+    case 3:
+        return crypto_sign_verify_lvl<3>(sig, siglen, m, mlen, pk);
+    case 5:
+        return crypto_sign_verify_lvl<5>(sig, siglen, m, mlen, pk);
+    default:
+        return -1;
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef SIGN_H
+#define SIGN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+/*
+ * Key generation, sign and verify for security level 2, 3 or 5.
+ * Same flows as combined_top.v in KG, sign and VY mode.
+ * Dispatch on sec_lvl to the per-level code of sign_level.h.
+ * All functions return 0 on success, -1 on error or invalid signature.
+ */
+
+// Deterministic key generation from the 32-byte seed zeta (KAT/z_*.txt)
+int crypto_sign_keypair_seed(uint8_t *pk, uint8_t *sk, const uint8_t seed[SEEDBYTES],
+                             int sec_lvl);
+
+int crypto_sign_keypair(uint8_t *pk, uint8_t *sk, int sec_lvl);
+
+// Deterministic signature, sig must hold p->BYTES bytes
+int crypto_sign_signature(uint8_t *sig, size_t *siglen,
+                          const uint8_t *m, size_t mlen,
+                          const uint8_t *sk, int sec_lvl);
+
+int crypto_sign_verify(const uint8_t *sig, size_t siglen,
+                       const uint8_t *m, size_t mlen,
+                       const uint8_t *pk, int sec_lvl);
+
+#endif
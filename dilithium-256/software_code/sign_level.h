@@ -0,0 +1,447 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef SIGN_LEVEL_H
+#define SIGN_LEVEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+#include "fips202.h"
+#include "sampler.h"
+#include "challenge.h"
+#include "rounding.h"
+#include "packing.h"
+#include "poly.h"
+#include "arena.h"
+#include "level.h"
+#include "profile.h"
+#include "sign_stats.h"
+
+/*
+ * Keygen, sign and verify specialized on the security level.
+ * Same flows and results as sign.h, but K, L and the bounds are
+ * constants: every loop over K or L has a fixed trip count and the
+ * compiler unrolls it, scratch arrays are sized for LVL, and nothing
+ * is looked up in dilithium_params. sign.h dispatches here on sec_lvl.
+ * Each step sits in a PROFILE_SCOPE named after its combined_top.v state.
+ * Only the one-shot crypto_sign_keypair_seed, crypto_sign_signature and
+ * crypto_sign_verify are specialized. The context, streaming, parallel
+ * and low-memory paths of context.h, parallel.h and lowmem.h still read
+ * K, L and the bounds from the runtime dilithium_params.
+ */
+
+template <int LVL>
+void expand_a_lvl(poly mat[level_traits<LVL>::K][level_traits<LVL>::L],
+                  const uint8_t rho[SEEDBYTES])
+{
+    for (unsigned i = 0; i < level_traits<LVL>::K; ++i)
+    {
+        for (unsigned j = 0; j < level_traits<LVL>::L; ++j)
+        {
+            poly_uniform(&mat[i][j], rho, (uint16_t)((i << 8) + j));
+        }
+    }
+}
+
+template <int LVL>
+int crypto_sign_keypair_lvl(uint8_t *pk, uint8_t *sk, const uint8_t seed[SEEDBYTES])
+{
+    typedef level_traits<LVL> T;
+    level_keygen_scratch<LVL> *ws = &scratch_level_get<LVL>()->keygen;
+    uint8_t seedbuf[2 * SEEDBYTES + CRHBYTES];
+    uint8_t tr[SEEDBYTES];
+    const uint8_t *rho, *rhoprime, *key;
+
+    // rho || rhoprime || key = H(zeta)
+    {
+        PROFILE_SCOPE(KG_HASH_Z);
+        shake256(seedbuf, sizeof(seedbuf), seed, SEEDBYTES);
+    }
+    rho = seedbuf;
+    rhoprime = rho + SEEDBYTES;
+    key = rhoprime + CRHBYTES;
+
+    {
+        PROFILE_SCOPE(KG_SAMPLE_S1);
+        for (unsigned i = 0; i < T::L; ++i)
+        {
+            poly_uniform_eta(&ws->s1[i], rhoprime, (uint16_t)i, T::ETA);
+        }
+    }
+    // The hardware transforms s1 while it samples s2
+    {
+        PROFILE_SCOPE(KG_SAMPLE_S2);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            poly_uniform_eta(&ws->s2[i], rhoprime, (uint16_t)(T::L + i), T::ETA);
+        }
+        memcpy(ws->s1hat, ws->s1, sizeof(ws->s1));
+        for (unsigned i = 0; i < T::L; ++i)
+        {
+            poly_ntt(&ws->s1hat[i]);
+        }
+    }
+
+    // t = A * s1 + s2, A sampled in KG_MULT_AS1 as gen_a does
+    {
+        PROFILE_SCOPE(KG_MULT_AS1);
+        expand_a_lvl<LVL>(ws->mat, rho);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            polyvec_pointwise_acc(&ws->t1[i], ws->mat[i], ws->s1hat, T::L);
+        }
+    }
+    {
+        PROFILE_SCOPE(KG_NTTI_T);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            poly_invntt(&ws->t1[i]);
+        }
+    }
+    {
+        PROFILE_SCOPE(KG_ADD_T_S2);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            poly_add(&ws->t1[i], &ws->t1[i], &ws->s2[i]);
+            poly_reduce(&ws->t1[i]);
+            poly_caddq(&ws->t1[i]);
+            poly_power2round(&ws->t1[i], &ws->t0[i], &ws->t1[i]);
+        }
+        pack_pk(pk, rho, ws->t1, &T::P);
+    }
+
+    {
+        PROFILE_SCOPE(KG_UNLOAD_TR);
+        shake256(tr, SEEDBYTES, pk, T::PUBLICKEYBYTES);
+    }
+    {
+        PROFILE_SCOPE(KG_ENCODE_T0);
+        pack_sk(sk, rho, tr, key, ws->t0, ws->s1, ws->s2, &T::P);
+    }
+
+    return 0;
+}
+
+template <int LVL>
+int crypto_sign_signature_lvl(uint8_t *sig, size_t *siglen,
+                              const uint8_t *m, size_t mlen, const uint8_t *sk)
+{
+    typedef level_traits<LVL> T;
+    level_sign_scratch<LVL> *ws = &scratch_level_get<LVL>()->sign;
+    uint8_t rho[SEEDBYTES], tr[SEEDBYTES], key[SEEDBYTES];
+    uint8_t mu[CRHBYTES], rhoprime[CRHBYTES], ctilde[SEEDBYTES];
+    keccak_state state;
+    sparse_poly c;
+    poly cp;
+    unsigned n, attempts = 0;
+    int reject;
+
+    {
+        PROFILE_SCOPE(FSM0_DECODE_S1);
+        unpack_sk(rho, tr, key, ws->t0, ws->s1, ws->s2, sk, &T::P);
+    }
+    // Sampled once here, the hardware samples A again in every FSM1_MULT_A_Y
+    {
+        PROFILE_SCOPE(FSM0_LOAD_RHO);
+        expand_a_lvl<LVL>(ws->mat, rho);
+    }
+
+    // mu = CRH(tr || M), rhoprime = CRH(key || mu)
+    {
+        PROFILE_SCOPE(FSM0_LOAD_MU);
+        shake256_init(&state);
+        shake256_absorb(&state, tr, SEEDBYTES);
+        shake256_absorb(&state, m, mlen);
+        shake256_finalize(&state);
+        shake256_squeeze(mu, CRHBYTES, &state);
+
+        shake256_init(&state);
+        shake256_absorb(&state, key, SEEDBYTES);
+        shake256_absorb(&state, mu, CRHBYTES);
+        shake256_finalize(&state);
+        shake256_squeeze(rhoprime, CRHBYTES, &state);
+    }
+
+    for (uint16_t nonce = 0;; nonce += T::L)
+    {
+        attempts++;
+
+        // w = A * y
+        {
+            PROFILE_SCOPE(FSM1_GENY);
+            for (unsigned j = 0; j < T::L; ++j)
+            {
+                poly_uniform_gamma1(&ws->y[j], rhoprime, (uint16_t)(nonce + j), T::GAMMA1);
+            }
+        }
+        {
+            PROFILE_SCOPE(FSM1_NTT_Y);
+            for (unsigned j = 0; j < T::L; ++j)
+            {
+                ws->yz[j] = ws->y[j];
+                poly_ntt(&ws->yz[j]);
+            }
+        }
+        {
+            PROFILE_SCOPE(FSM1_MULT_A_Y);
+            for (unsigned i = 0; i < T::K; ++i)
+            {
+                polyvec_pointwise_acc(&ws->w1[i], ws->mat[i], ws->yz, T::L);
+            }
+        }
+        {
+            PROFILE_SCOPE(FSM1_NTTI_W);
+            for (unsigned i = 0; i < T::K; ++i)
+            {
+                poly_invntt(&ws->w1[i]);
+                poly_caddq(&ws->w1[i]);
+            }
+        }
+        {
+            PROFILE_SCOPE(FSM2_DECOMP);
+            for (unsigned i = 0; i < T::K; ++i)
+            {
+                poly_decompose(&ws->w1[i], &ws->w0[i], &ws->w1[i], T::GAMMA2);
+                polyw1_pack(ws->w1_packed + i * T::POLYW1_PACKEDBYTES, &ws->w1[i], T::GAMMA2);
+            }
+        }
+
+        // ctilde = H(mu || w1)
+        {
+            PROFILE_SCOPE(FSM2_GEN_C);
+            shake256_init(&state);
+            shake256_absorb(&state, mu, CRHBYTES);
+            shake256_absorb(&state, ws->w1_packed, sizeof(ws->w1_packed));
+            shake256_finalize(&state);
+            shake256_squeeze(ctilde, SEEDBYTES, &state);
+            sample_in_ball(NULL, &c, ctilde, &T::P);
+        }
+
+        /*
+         * Early abort: the r0 and z checks cost one sparse product per
+         * polynomial, and GAMMA2 < GAMMA1 makes a polynomial of r0 the
+         * more likely to fail, so r0 runs first. Both stop at the first
+         * polynomial out of bounds.
+         */
+        // r0 = LowBits(w - c * s2)
+        reject = 0;
+        for (unsigned i = 0; i < T::K && !reject; ++i)
+        {
+            {
+                PROFILE_SCOPE(FSM2_MULT_CS2);
+                poly_sparse_mul(&cp, &c, &ws->s2[i]);
+            }
+            PROFILE_SCOPE(FSM2_SUB_W0_CS2);
+            poly_sub(&ws->w0[i], &ws->w0[i], &cp);
+            reject = poly_chknorm(&ws->w0[i], T::GAMMA2 - T::BETA);
+        }
+        if (reject)
+        {
+            sign_stats_attempt(LVL, SIGN_REJECT_R0);
+            continue;
+        }
+
+        // z = y + c * s1
+        for (unsigned j = 0; j < T::L && !reject; ++j)
+        {
+            PROFILE_SCOPE(FSM2_MULTACC);
+            poly_sparse_mul(&cp, &c, &ws->s1[j]);
+            poly_add(&ws->yz[j], &ws->y[j], &cp);
+            reject = poly_chknorm(&ws->yz[j], T::GAMMA1 - T::BETA);
+        }
+        if (reject)
+        {
+            sign_stats_attempt(LVL, SIGN_REJECT_Z);
+            continue;
+        }
+
+        // Hints for w - c * s2 + c * t0
+        n = 0;
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            {
+                PROFILE_SCOPE(FSM2_MULT_CT0);
+                poly_sparse_mul(&cp, &c, &ws->t0[i]);
+                reject = poly_chknorm(&cp, T::GAMMA2);
+            }
+            if (reject)
+            {
+                break;
+            }
+            PROFILE_SCOPE(FSM2_MAKEHINT);
+            poly_add(&ws->w0[i], &ws->w0[i], &cp);
+            n += poly_make_hint(&ws->h[i], &ws->w0[i], &ws->w1[i], T::GAMMA2);
+            if (n > T::OMEGA)
+            {
+                break;
+            }
+        }
+        if (reject || n > T::OMEGA)
+        {
+            sign_stats_attempt(LVL, reject ? SIGN_REJECT_CT0 : SIGN_REJECT_HINT);
+            continue;
+        }
+
+        // c~ || z || h, the order of FSM0_UNLOAD_C, _Z, _H
+        {
+            PROFILE_SCOPE(FSM0_UNLOAD_C);
+            memcpy(sig, ctilde, SEEDBYTES);
+        }
+        {
+            PROFILE_SCOPE(FSM0_UNLOAD_Z);
+            for (unsigned j = 0; j < T::L; ++j)
+            {
+                polyz_pack(sig + SEEDBYTES + j * T::POLYZ_PACKEDBYTES, &ws->yz[j], T::GAMMA1);
+            }
+        }
+        {
+            PROFILE_SCOPE(FSM0_UNLOAD_H);
+            pack_hint(sig + SEEDBYTES + T::L * T::POLYZ_PACKEDBYTES, ws->h, &T::P);
+        }
+        sign_stats_attempt(LVL, SIGN_ACCEPT);
+        sign_stats_signature(LVL, attempts);
+        *siglen = T::BYTES;
+        return 0;
+    }
+}
+
+template <int LVL>
+int crypto_sign_verify_lvl(const uint8_t *sig, size_t siglen,
+                           const uint8_t *m, size_t mlen, const uint8_t *pk)
+{
+    typedef level_traits<LVL> T;
+    level_verify_scratch<LVL> *ws = &scratch_level_get<LVL>()->verify;
+    uint8_t rho[SEEDBYTES], tr[SEEDBYTES], mu[CRHBYTES];
+    uint8_t ctilde[SEEDBYTES], ctilde2[SEEDBYTES];
+    keccak_state state;
+    poly c, cp;
+    int reject;
+
+    if (siglen != T::BYTES)
+    {
+        return -1;
+    }
+    {
+        PROFILE_SCOPE(VY_DECODE_Z);
+        reject = unpack_sig(ctilde, ws->z, ws->h, sig, &T::P) ||
+                 polyvec_chknorm(ws->z, T::L, T::GAMMA1 - T::BETA);
+    }
+    if (reject)
+    {
+        return -1;
+    }
+
+    // mu = CRH(H(pk) || M)
+    {
+        PROFILE_SCOPE(VY_LOAD_RHO);
+        shake256(tr, SEEDBYTES, pk, T::PUBLICKEYBYTES);
+        shake256_init(&state);
+        shake256_absorb(&state, tr, SEEDBYTES);
+        shake256_absorb(&state, m, mlen);
+        shake256_finalize(&state);
+        shake256_squeeze(mu, CRHBYTES, &state);
+
+        unpack_pk(rho, ws->t1hat, pk, &T::P);
+    }
+
+    {
+        PROFILE_SCOPE(VY_LOAD_C);
+        sample_in_ball(&c, NULL, ctilde, &T::P);
+    }
+    {
+        PROFILE_SCOPE(VY_NTT_C);
+        poly_ntt(&c);
+    }
+
+    // w' = invNTT(A * NTT(z) - NTT(c) * NTT(t1 * 2^D))
+    {
+        PROFILE_SCOPE(VY_NTT_Z);
+        for (unsigned j = 0; j < T::L; ++j)
+        {
+            poly_ntt(&ws->z[j]);
+        }
+    }
+    {
+        PROFILE_SCOPE(VY_NTT_T1);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            poly_shiftl(&ws->t1hat[i]);
+            poly_ntt(&ws->t1hat[i]);
+        }
+    }
+    // A sampled in VY_MULT_AZ as gen_a does
+    {
+        PROFILE_SCOPE(VY_MULT_AZ);
+        expand_a_lvl<LVL>(ws->mat, rho);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            polyvec_pointwise_acc(&ws->w1[i], ws->mat[i], ws->z, T::L);
+        }
+    }
+    for (unsigned i = 0; i < T::K; ++i)
+    {
+        {
+            PROFILE_SCOPE(VY_MULT_CT1);
+            poly_pointwise(&cp, &c, &ws->t1hat[i]);
+        }
+        // Difference in (-2Q, 2Q), the first invNTT layer reduces it
+        PROFILE_SCOPE(VY_SUB_AZ_CT1);
+        poly_sub(&ws->w1[i], &ws->w1[i], &cp);
+    }
+    {
+        PROFILE_SCOPE(VY_INTT);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            poly_invntt(&ws->w1[i]);
+            poly_caddq(&ws->w1[i]);
+        }
+    }
+    {
+        PROFILE_SCOPE(VY_GENW1);
+        for (unsigned i = 0; i < T::K; ++i)
+        {
+            poly_use_hint(&ws->w1[i], &ws->w1[i], &ws->h[i], T::GAMMA2);
+            polyw1_pack(ws->w1_packed + i * T::POLYW1_PACKEDBYTES, &ws->w1[i], T::GAMMA2);
+        }
+    }
+
+    {
+        PROFILE_SCOPE(VY_HASH_CH);
+        shake256_init(&state);
+        shake256_absorb(&state, mu, CRHBYTES);
+        shake256_absorb(&state, ws->w1_packed, sizeof(ws->w1_packed));
+        shake256_finalize(&state);
+        shake256_squeeze(ctilde2, SEEDBYTES, &state);
+    }
+
+    PROFILE_SCOPE(VY_COMPARE);
+    if (memcmp(ctilde, ctilde2, SEEDBYTES) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+#endif
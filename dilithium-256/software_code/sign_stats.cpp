@@ -0,0 +1,154 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <atomic>
+
+#include "sign_stats.h"
+
+typedef struct
+{
+    std::atomic<uint64_t> signatures;
+    std::atomic<uint64_t> attempts;
+    std::atomic<uint64_t> rejects[SIGN_REJECT_REASONS];
+    std::atomic<uint64_t> attempts_max;
+    std::atomic<uint64_t> histogram[SIGN_STATS_ATTEMPTS_MAX];
+} level_counters;
+
+static const int levels[3] = {2, 3, 5};
+static level_counters counters[3];
+
+static const char *const reason_names[SIGN_REJECT_REASONS] = {"accept", "z", "r0", "ct0", "hint"};
+
+static level_counters *level_get(int sec_lvl)
+{
+    for (unsigned l = 0; l < 3; l++)
+    {
+        if (levels[l] == sec_lvl)
+            return &counters[l];
+    }
+    return NULL;
+}
+
+void sign_stats_attempt(int sec_lvl, enum sign_reject reason)
+{
+    level_counters *c = level_get(sec_lvl);
+
+    if (c == NULL || (unsigned)reason >= SIGN_REJECT_REASONS)
+    {
+        return;
+    }
+    c->attempts.fetch_add(1, std::memory_order_relaxed);
+    c->rejects[reason].fetch_add(1, std::memory_order_relaxed);
+}
+
+void sign_stats_signature(int sec_lvl, unsigned attempts)
+{
+    level_counters *c = level_get(sec_lvl);
+    uint64_t max;
+
+    if (c == NULL || attempts == 0)
+    {
+        return;
+    }
+    c->signatures.fetch_add(1, std::memory_order_relaxed);
+    c->histogram[attempts < SIGN_STATS_ATTEMPTS_MAX ? attempts - 1 : SIGN_STATS_ATTEMPTS_MAX - 1]
+        .fetch_add(1, std::memory_order_relaxed);
+
+    max = c->attempts_max.load(std::memory_order_relaxed);
+    while (attempts > max &&
+           !c->attempts_max.compare_exchange_weak(max, attempts, std::memory_order_relaxed))
+    {
+    }
+}
+
+int sign_stats_get(int sec_lvl, sign_stats *stats)
+{
+    const level_counters *c = level_get(sec_lvl);
+
+    if (c == NULL)
+    {
+        return -1;
+    }
+    stats->signatures = c->signatures.load(std::memory_order_relaxed);
+    stats->attempts = c->attempts.load(std::memory_order_relaxed);
+    for (unsigned r = 0; r < SIGN_REJECT_REASONS; r++)
+    {
+        stats->rejects[r] = c->rejects[r].load(std::memory_order_relaxed);
+    }
+    stats->attempts_max = c->attempts_max.load(std::memory_order_relaxed);
+    for (unsigned a = 0; a < SIGN_STATS_ATTEMPTS_MAX; a++)
+    {
+        stats->histogram[a] = c->histogram[a].load(std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+void sign_stats_reset(void)
+{
+    for (unsigned l = 0; l < 3; l++)
+    {
+        level_counters *c = &counters[l];
+
+        c->signatures.store(0, std::memory_order_relaxed);
+        c->attempts.store(0, std::memory_order_relaxed);
+        for (unsigned r = 0; r < SIGN_REJECT_REASONS; r++)
+        {
+            c->rejects[r].store(0, std::memory_order_relaxed);
+        }
+        c->attempts_max.store(0, std::memory_order_relaxed);
+        for (unsigned a = 0; a < SIGN_STATS_ATTEMPTS_MAX; a++)
+        {
+            c->histogram[a].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void sign_stats_json(FILE *f)
+{
+    sign_stats s;
+
+    fprintf(f, "{\"levels\": [\n");
+    for (unsigned l = 0; l < 3; l++)
+    {
+        sign_stats_get(levels[l], &s);
+        fprintf(f, "  {\"level\": %d, \"signatures\": %llu, \"attempts\": %llu, \"attempts_mean\": %.3f, \"attempts_max\": %llu,\n",
+                levels[l], (unsigned long long)s.signatures, (unsigned long long)s.attempts,
+                s.signatures ? (double)s.attempts / s.signatures : 0.0,
+                (unsigned long long)s.attempts_max);
+        fprintf(f, "   \"rejects\": {");
+        for (unsigned r = SIGN_REJECT_Z; r < SIGN_REJECT_REASONS; r++)
+        {
+            fprintf(f, "\"%s\": %llu%s", reason_names[r], (unsigned long long)s.rejects[r],
+                    r + 1 < SIGN_REJECT_REASONS ? ", " : "");
+        }
+        // histogram[a - 1] = signatures that took a attempts, the last entry a or more
+        fprintf(f, "},\n   \"histogram\": [");
+        for (unsigned a = 0; a < SIGN_STATS_ATTEMPTS_MAX; a++)
+        {
+            fprintf(f, "%llu%s", (unsigned long long)s.histogram[a],
+                    a + 1 < SIGN_STATS_ATTEMPTS_MAX ? ", " : "");
+        }
+        fprintf(f, "]}%s\n", l < 2 ? "," : "");
+    }
+    fprintf(f, "]}\n");
+}
@@ -0,0 +1,75 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef SIGN_STATS_H
+#define SIGN_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Rejection-loop statistics, one set per security level, shared by every
+ * signer of this library and every thread.
+ * An attempt is rejected by the same checks as the hardware: the z, r0
+ * and ct0 bounds of norm_check.v, or too many hints (reject_hint of
+ * makehint.v). Counters are updated with relaxed atomics, one update
+ * per rejected attempt and one per signature.
+ */
+
+enum sign_reject
+{
+    SIGN_ACCEPT = 0,
+    SIGN_REJECT_Z,    // ||z||inf >= GAMMA1 - BETA
+    SIGN_REJECT_R0,   // ||r0||inf >= GAMMA2 - BETA
+    SIGN_REJECT_CT0,  // ||c * t0||inf >= GAMMA2
+    SIGN_REJECT_HINT, // more than OMEGA hints
+    SIGN_REJECT_REASONS
+};
+
+#define SIGN_STATS_ATTEMPTS_MAX 32 // last bucket holds everything above
+
+typedef struct
+{
+    uint64_t signatures;
+    uint64_t attempts;
+    uint64_t rejects[SIGN_REJECT_REASONS]; // rejects[SIGN_ACCEPT] == signatures
+    uint64_t attempts_max;
+    // histogram[a - 1] = signatures that took a attempts
+    uint64_t histogram[SIGN_STATS_ATTEMPTS_MAX];
+} sign_stats;
+
+// One attempt ended with `reason`, SIGN_ACCEPT included
+void sign_stats_attempt(int sec_lvl, enum sign_reject reason);
+
+// One signature needed `attempts` attempts
+void sign_stats_signature(int sec_lvl, unsigned attempts);
+
+// Return -1 on unsupported sec_lvl
+int sign_stats_get(int sec_lvl, sign_stats *stats);
+
+void sign_stats_reset(void);
+
+// {"levels": [{"level": 2, ...}, ...]}
+void sign_stats_json(FILE *f);
+
+#endif
@@ -0,0 +1,325 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "config.h"
+#include "sign.h"
+#include "lowmem.h"
+#include "context.h"
+#include "sign_stats.h"
+#include "kat.h"
+
+#define MLEN_MAX 3300
+#define TESTS 100
+
+typedef struct
+{
+    uint8_t z[SEEDBYTES];
+    uint8_t rho[SEEDBYTES];
+    uint8_t k[SEEDBYTES];
+    uint8_t tr[SEEDBYTES];
+    uint8_t s1[L_MAX * 128];
+    uint8_t s2[K_MAX * 128];
+    uint8_t t0[K_MAX * POLYT0_PACKEDBYTES];
+    uint8_t t1[K_MAX * POLYT1_PACKEDBYTES];
+    uint8_t m[MLEN_MAX];
+    size_t mlen;
+    uint8_t c[SEEDBYTES];
+    uint8_t zs[L_MAX * 640];
+    uint8_t h[BYTES_MAX];
+} kat_vector;
+
+static int load_kat(kat_vector *v, int sec_lvl, unsigned index)
+{
+    uint8_t mlen[2];
+    int ret = 0;
+
+    ret |= read_kat(v->z, sizeof(v->z), "z", sec_lvl, index) < 0;
+    ret |= read_kat(v->rho, sizeof(v->rho), "rho", sec_lvl, index) < 0;
+    ret |= read_kat(v->k, sizeof(v->k), "k", sec_lvl, index) < 0;
+    ret |= read_kat(v->tr, sizeof(v->tr), "tr", sec_lvl, index) < 0;
+    ret |= read_kat(v->s1, sizeof(v->s1), "s1", sec_lvl, index) < 0;
+    ret |= read_kat(v->s2, sizeof(v->s2), "s2", sec_lvl, index) < 0;
+    ret |= read_kat(v->t0, sizeof(v->t0), "t0", sec_lvl, index) < 0;
+    ret |= read_kat(v->t1, sizeof(v->t1), "t1", sec_lvl, index) < 0;
+    ret |= read_kat(v->m, sizeof(v->m), "m", sec_lvl, index) < 0;
+    ret |= read_kat(mlen, sizeof(mlen), "mlen", sec_lvl, index) != 2;
+    ret |= read_kat(v->c, sizeof(v->c), "c", sec_lvl, index) < 0;
+    ret |= read_kat(v->zs, sizeof(v->zs), "zs", sec_lvl, index) < 0;
+    ret |= read_kat(v->h, sizeof(v->h), "h", sec_lvl, index) < 0;
+
+    v->mlen = (mlen[0] << 8) | mlen[1];
+    return ret;
+}
+
+static int compare_bytes(const uint8_t *gold, const uint8_t *a, size_t len,
+                         const char *string)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (gold[i] != a[i])
+        {
+            printf("%s: [%zu] %02X != %02X\n", string, i, gold[i], a[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * KG, sign and VY against KAT/ for one security level
+ */
+static int test_kat(int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    kat_vector v;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[BYTES_MAX], sig2[BYTES_MAX];
+    const uint8_t *s;
+    size_t siglen;
+    int ret = 0;
+
+    for (unsigned t = 0; t < TESTS && !ret; t++)
+    {
+        if (load_kat(&v, sec_lvl, t))
+            return 1;
+
+        crypto_sign_keypair_seed(pk, sk, v.z, sec_lvl);
+
+        ret |= compare_bytes(v.rho, pk, SEEDBYTES, "pk rho");
+        ret |= compare_bytes(v.t1, pk + SEEDBYTES, p->K * POLYT1_PACKEDBYTES, "pk t1");
+        s = sk;
+        ret |= compare_bytes(v.rho, s, SEEDBYTES, "sk rho");
+        s += SEEDBYTES;
+        ret |= compare_bytes(v.k, s, SEEDBYTES, "sk key");
+        s += SEEDBYTES;
+        ret |= compare_bytes(v.tr, s, SEEDBYTES, "sk tr");
+        s += SEEDBYTES;
+        ret |= compare_bytes(v.s1, s, p->L * p->POLYETA_PACKEDBYTES, "sk s1");
+        s += p->L * p->POLYETA_PACKEDBYTES;
+        ret |= compare_bytes(v.s2, s, p->K * p->POLYETA_PACKEDBYTES, "sk s2");
+        s += p->K * p->POLYETA_PACKEDBYTES;
+        ret |= compare_bytes(v.t0, s, p->K * POLYT0_PACKEDBYTES, "sk t0");
+
+        crypto_sign_signature(sig, &siglen, v.m, v.mlen, sk, sec_lvl);
+
+        s = sig;
+        ret |= compare_bytes(v.c, s, SEEDBYTES, "sig c");
+        s += SEEDBYTES;
+        ret |= compare_bytes(v.zs, s, p->L * p->POLYZ_PACKEDBYTES, "sig z");
+        s += p->L * p->POLYZ_PACKEDBYTES;
+        ret |= compare_bytes(v.h, s, p->OMEGA + p->K, "sig h");
+
+        ret |= crypto_sign_verify(sig, siglen, v.m, v.mlen, pk, sec_lvl) != 0;
+
+        // Low-memory mode gives the same bytes
+        crypto_sign_signature_lowmem(sig2, &siglen, v.m, v.mlen, sk, sec_lvl);
+        ret |= compare_bytes(sig, sig2, siglen, "lowmem sig");
+        ret |= crypto_sign_verify_lowmem(sig, siglen, v.m, v.mlen, pk, sec_lvl) != 0;
+
+        // Flipped message bit, flipped z bit, out of order hint
+        v.m[0] ^= 1;
+        ret |= crypto_sign_verify(sig, siglen, v.m, v.mlen, pk, sec_lvl) == 0;
+        ret |= crypto_sign_verify_lowmem(sig, siglen, v.m, v.mlen, pk, sec_lvl) == 0;
+        v.m[0] ^= 1;
+
+        sig[SEEDBYTES + 1] ^= 4;
+        ret |= crypto_sign_verify(sig, siglen, v.m, v.mlen, pk, sec_lvl) == 0;
+        ret |= crypto_sign_verify_lowmem(sig, siglen, v.m, v.mlen, pk, sec_lvl) == 0;
+        sig[SEEDBYTES + 1] ^= 4;
+
+        sig[siglen - p->K - p->OMEGA] = 0xFF;
+        ret |= crypto_sign_verify(sig, siglen, v.m, v.mlen, pk, sec_lvl) == 0;
+        ret |= crypto_sign_verify_lowmem(sig, siglen, v.m, v.mlen, pk, sec_lvl) == 0;
+
+        if (ret)
+        {
+            printf("Level %d, KAT %u\n", sec_lvl, t);
+        }
+    }
+    return ret;
+}
+
+/*
+ * sign_stats: every signer counts the same attempts for the same
+ * signatures, one-shot and context signers the same reasons too.
+ * Low-memory checks z before r0, so its reasons differ.
+ */
+static int stats_consistent(const sign_stats *s)
+{
+    uint64_t n = 0, a = 0;
+
+    for (unsigned r = 0; r < SIGN_REJECT_REASONS; r++)
+        a += s->rejects[r];
+    for (unsigned i = 0; i < SIGN_STATS_ATTEMPTS_MAX; i++)
+        n += s->histogram[i];
+    return a != s->attempts || n != s->signatures || s->rejects[SIGN_ACCEPT] != s->signatures;
+}
+
+static int test_stats(int sec_lvl)
+{
+    static sign_ctx ctx;
+    kat_vector v;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[BYTES_MAX];
+    sign_stats s[3];
+    size_t siglen;
+    int ret = 0;
+
+    for (int signer = 0; signer < 3; signer++)
+    {
+        sign_stats_reset();
+        for (unsigned t = 0; t < TESTS; t++)
+        {
+            if (load_kat(&v, sec_lvl, t))
+                return 1;
+            crypto_sign_keypair_seed(pk, sk, v.z, sec_lvl);
+            if (signer == 0)
+            {
+                crypto_sign_signature(sig, &siglen, v.m, v.mlen, sk, sec_lvl);
+            }
+            else if (signer == 1)
+            {
+                sign_ctx_init(&ctx, sk, sec_lvl);
+                crypto_sign_signature_ctx(sig, &siglen, v.m, v.mlen, &ctx);
+            }
+            else
+            {
+                crypto_sign_signature_lowmem(sig, &siglen, v.m, v.mlen, sk, sec_lvl);
+            }
+        }
+        sign_stats_get(sec_lvl, &s[signer]);
+        ret |= s[signer].signatures != TESTS || stats_consistent(&s[signer]);
+    }
+
+    ret |= memcmp(&s[0], &s[1], sizeof(s[0])) != 0;
+    ret |= memcmp(s[0].histogram, s[2].histogram, sizeof(s[0].histogram)) != 0;
+    if (ret)
+        return ret;
+
+    printf("OK (mean %.2f, z %llu, r0 %llu, ct0 %llu, hint %llu)\n",
+           (double)s[0].attempts / s[0].signatures,
+           (unsigned long long)s[0].rejects[SIGN_REJECT_Z], (unsigned long long)s[0].rejects[SIGN_REJECT_R0],
+           (unsigned long long)s[0].rejects[SIGN_REJECT_CT0], (unsigned long long)s[0].rejects[SIGN_REJECT_HINT]);
+    return 0;
+}
+
+/*
+ * Peak stack of the low-memory calls: run them on a thread whose stack
+ * is filled with a pattern, then find the deepest byte overwritten
+ * below the frame of the thread function. glibc also puts the thread's
+ * TLS, scratch_arena included, at the top of that stack.
+ */
+#define PAINT_BYTES (512 * 1024)
+#define PAINT 0xA5
+
+typedef struct
+{
+    int sec_lvl;
+    uint8_t pk[PUBLICKEYBYTES_MAX], sk[SECRETKEYBYTES_MAX], sig[BYTES_MAX];
+    uint8_t *top;
+    int ret;
+} stack_job;
+
+static void *stack_worker(void *arg)
+{
+    stack_job *job = (stack_job *)arg;
+    const uint8_t m[32] = {0};
+    size_t siglen;
+
+    job->top = (uint8_t *)__builtin_frame_address(0);
+    job->ret = crypto_sign_signature_lowmem(job->sig, &siglen, m, sizeof(m), job->sk,
+                                            job->sec_lvl);
+    job->ret |= crypto_sign_verify_lowmem(job->sig, siglen, m, sizeof(m), job->pk,
+                                          job->sec_lvl);
+    return NULL;
+}
+
+static int test_lowmem_stack(int sec_lvl, size_t *peak)
+{
+    uint8_t *stack = (uint8_t *)aligned_alloc(4096, PAINT_BYTES);
+    const uint8_t seed[SEEDBYTES] = {0};
+    pthread_attr_t attr;
+    pthread_t thread;
+    stack_job job;
+    size_t low = 0;
+
+    if (stack == NULL)
+        return 1;
+
+    job.sec_lvl = sec_lvl;
+    crypto_sign_keypair_seed(job.pk, job.sk, seed, sec_lvl);
+
+    memset(stack, PAINT, PAINT_BYTES);
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, stack, PAINT_BYTES);
+    if (pthread_create(&thread, &attr, stack_worker, &job))
+    {
+        free(stack);
+        return 1;
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    while (low < PAINT_BYTES && stack[low] == PAINT)
+        low++;
+    *peak = (size_t)(job.top - (stack + low));
+    free(stack);
+
+    return job.ret || *peak > LOWMEM_STACK_LIMIT;
+}
+
+int main()
+{
+    const int levels[3] = {2, 3, 5};
+    int ret = 0;
+
+    for (int l = 0; l < 3; l++)
+    {
+        printf("Test KG/sign/VY level %d KAT = %u :", levels[l], TESTS);
+        ret |= test_kat(levels[l]);
+        printf(ret ? "ERROR\n" : "OK\n");
+    }
+
+    for (int l = 0; l < 3; l++)
+    {
+        printf("Test rejection stats level %d KAT = %u :", levels[l], TESTS);
+        if (test_stats(levels[l]))
+        {
+            ret = 1;
+            printf("ERROR\n");
+        }
+    }
+
+    for (int l = 0; l < 3; l++)
+    {
+        size_t peak = 0;
+        printf("Test low-memory stack level %d <= %u bytes :", levels[l], LOWMEM_STACK_LIMIT);
+        ret |= test_lowmem_stack(levels[l], &peak);
+        printf(ret ? "ERROR (%zu)\n" : "OK (%zu)\n", peak);
+    }
+    return ret;
+}
@@ -0,0 +1,231 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include "thread_pool.h"
+
+/*
+ * Work stealing over index ranges.
+ * Every participant (caller = 0, workers 1..) owns a range [begin, end)
+ * of the loop and takes indices from its front. An idle participant
+ * steals the back half of the largest range left. Contiguous ranges keep
+ * neighbouring indices, e.g. signatures under the same key, on one core.
+ */
+typedef struct
+{
+    std::mutex lock;
+    size_t begin, end;
+} task_range;
+
+/*
+ * One loop at a time: `generation` announces a new loop, the last
+ * participant to leave wakes the caller. The caller waits for every
+ * worker, so no worker can still be inside a loop when the next one
+ * is published.
+ */
+struct thread_pool
+{
+    std::vector<std::thread> workers;
+    std::vector<task_range> ranges;
+    std::mutex run_lock;
+    std::mutex lock;
+    std::condition_variable start, finish;
+    unsigned long generation;
+    unsigned busy;
+    bool stop;
+
+    thread_pool_fn fn;
+    void *arg;
+};
+
+static bool pop_front(task_range *r, size_t *i)
+{
+    std::lock_guard<std::mutex> guard(r->lock);
+
+    if (r->begin == r->end)
+    {
+        return false;
+    }
+    *i = r->begin++;
+    return true;
+}
+
+// Move the back half of the largest other range to `self`
+static bool steal(thread_pool *pool, unsigned self)
+{
+    const unsigned width = (unsigned)pool->ranges.size();
+    size_t best = 0, size, mid, end;
+    unsigned victim = self;
+
+    for (unsigned k = 1; k < width; ++k)
+    {
+        unsigned v = (self + k) % width;
+        std::lock_guard<std::mutex> guard(pool->ranges[v].lock);
+        size = pool->ranges[v].end - pool->ranges[v].begin;
+        if (size > best)
+        {
+            best = size;
+            victim = v;
+        }
+    }
+    if (victim == self)
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(pool->ranges[victim].lock);
+        task_range *r = &pool->ranges[victim];
+        if (r->begin == r->end)
+        {
+            // Emptied meanwhile, look again
+            return true;
+        }
+        mid = r->begin + (r->end - r->begin) / 2;
+        end = r->end;
+        r->end = mid;
+    }
+
+    std::lock_guard<std::mutex> guard(pool->ranges[self].lock);
+    pool->ranges[self].begin = mid;
+    pool->ranges[self].end = end;
+    return true;
+}
+
+static void drain(thread_pool *pool, unsigned self)
+{
+    size_t i;
+
+    do
+    {
+        while (pop_front(&pool->ranges[self], &i))
+        {
+            pool->fn(pool->arg, i);
+        }
+    } while (steal(pool, self));
+}
+
+static void worker_loop(thread_pool *pool, unsigned self)
+{
+    unsigned long seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> guard(pool->lock);
+            pool->start.wait(guard, [&] { return pool->stop || pool->generation != seen; });
+            if (pool->stop)
+            {
+                return;
+            }
+            seen = pool->generation;
+        }
+
+        drain(pool, self);
+
+        std::lock_guard<std::mutex> guard(pool->lock);
+        if (--pool->busy == 0)
+        {
+            pool->finish.notify_one();
+        }
+    }
+}
+
+thread_pool *thread_pool_new(unsigned nthreads)
+{
+    thread_pool *pool = new (std::nothrow) thread_pool;
+
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->generation = 0;
+    pool->busy = 0;
+    pool->stop = false;
+
+    try
+    {
+        pool->ranges = std::vector<task_range>(nthreads + 1);
+        for (unsigned i = 0; i < nthreads; ++i)
+        {
+            pool->workers.emplace_back(worker_loop, pool, i + 1);
+        }
+    }
+    catch (const std::exception &)
+    {
+        thread_pool_free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void thread_pool_free(thread_pool *pool)
+{
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->stop = true;
+    }
+    pool->start.notify_all();
+    for (auto &t : pool->workers)
+    {
+        t.join();
+    }
+    delete pool;
+}
+
+unsigned thread_pool_width(const thread_pool *pool)
+{
+    return (unsigned)pool->workers.size() + 1;
+}
+
+void thread_pool_run(thread_pool *pool, thread_pool_fn fn, void *arg, size_t n)
+{
+    const unsigned width = thread_pool_width(pool);
+    std::lock_guard<std::mutex> run_guard(pool->run_lock);
+
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->fn = fn;
+        pool->arg = arg;
+        // Participant t starts with the t-th contiguous share of [0, n)
+        for (unsigned t = 0; t < width; ++t)
+        {
+            std::lock_guard<std::mutex> range_guard(pool->ranges[t].lock);
+            pool->ranges[t].begin = n * t / width;
+            pool->ranges[t].end = n * (t + 1) / width;
+        }
+        ++pool->generation;
+        pool->busy = width;
+    }
+    pool->start.notify_all();
+
+    drain(pool, 0);
+
+    std::unique_lock<std::mutex> guard(pool->lock);
+    --pool->busy;
+    pool->finish.wait(guard, [pool] { return pool->busy == 0; });
+}
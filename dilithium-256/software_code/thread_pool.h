@@ -0,0 +1,52 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+
+/*
+ * Fixed set of worker threads running parallel loops.
+ * thread_pool_run calls fn(arg, i) once for every i in [0, n), on the
+ * workers and on the calling thread, and returns when all calls are done.
+ * Each thread starts on its own contiguous share of [0, n) in increasing
+ * order and steals from the others once it runs dry.
+ * Runs from different threads are serialized.
+ */
+
+typedef struct thread_pool thread_pool;
+
+typedef void (*thread_pool_fn)(void *arg, size_t i);
+
+// nthreads workers besides the caller, return NULL on failure
+thread_pool *thread_pool_new(unsigned nthreads);
+
+void thread_pool_free(thread_pool *pool);
+
+// Number of threads taking part in a run, caller included
+unsigned thread_pool_width(const thread_pool *pool);
+
+void thread_pool_run(thread_pool *pool, thread_pool_fn fn, void *arg, size_t n);
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#include <stdint.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "config.h"
+#include "fips202.h"
+#include "context.h"
+#include "verify_cache.h"
+
+typedef std::pair<std::string, std::shared_ptr<const verify_ctx>> lru_entry;
+
+/*
+ * Most recently used entry first. Contexts are handed out as shared_ptr,
+ * so an entry evicted while another thread still verifies with it stays
+ * alive until that verification returns.
+ */
+struct verify_cache
+{
+    std::mutex lock;
+    size_t capacity;
+    std::list<lru_entry> lru;
+    std::unordered_map<std::string, std::list<lru_entry>::iterator> index;
+    verify_cache_stats stats;
+};
+
+verify_cache *verify_cache_new(size_t budget)
+{
+    verify_cache *cache = new (std::nothrow) verify_cache;
+
+    if (cache == NULL)
+    {
+        return NULL;
+    }
+    cache->capacity = budget / VERIFY_CACHE_ENTRY_BYTES;
+    cache->stats = verify_cache_stats();
+    return cache;
+}
+
+void verify_cache_free(verify_cache *cache)
+{
+    delete cache;
+}
+
+void verify_cache_get_stats(verify_cache *cache, verify_cache_stats *stats)
+{
+    std::lock_guard<std::mutex> guard(cache->lock);
+
+    *stats = cache->stats;
+    stats->entries = cache->lru.size();
+}
+
+static std::shared_ptr<const verify_ctx> lookup(verify_cache *cache,
+                                                const std::string &key)
+{
+    std::lock_guard<std::mutex> guard(cache->lock);
+    auto it = cache->index.find(key);
+
+    if (it == cache->index.end())
+    {
+        ++cache->stats.misses;
+        return nullptr;
+    }
+    ++cache->stats.hits;
+    cache->lru.splice(cache->lru.begin(), cache->lru, it->second);
+    return it->second->second;
+}
+
+static std::shared_ptr<const verify_ctx> insert(verify_cache *cache, const std::string &key,
+                                                std::shared_ptr<const verify_ctx> ctx)
+{
+    std::lock_guard<std::mutex> guard(cache->lock);
+    auto it = cache->index.find(key);
+
+    // Another thread built the same key meanwhile, keep the resident copy
+    if (it != cache->index.end())
+    {
+        cache->lru.splice(cache->lru.begin(), cache->lru, it->second);
+        return it->second->second;
+    }
+
+    while (cache->lru.size() >= cache->capacity)
+    {
+        cache->index.erase(cache->lru.back().first);
+        cache->lru.pop_back();
+        ++cache->stats.evictions;
+    }
+    cache->lru.emplace_front(key, std::move(ctx));
+    cache->index[key] = cache->lru.begin();
+    return cache->lru.front().second;
+}
+
+int crypto_sign_verify_cached(verify_cache *cache,
+                              const uint8_t *sig, size_t siglen,
+                              const uint8_t *m, size_t mlen,
+                              const uint8_t *pk, int sec_lvl)
+{
+    const dilithium_params *p = get_params(sec_lvl);
+    uint8_t tr[SEEDBYTES];
+    std::shared_ptr<const verify_ctx> ctx;
+    std::string key;
+
+    if (p == NULL || pk == NULL)
+    {
+        return -1;
+    }
+
+    // No caching: the context is too large for the stack, use it once
+    if (cache->capacity == 0)
+    {
+        std::unique_ptr<verify_ctx> once(new (std::nothrow) verify_ctx);
+
+        if (once == nullptr || verify_ctx_init(once.get(), pk, sec_lvl))
+        {
+            return -1;
+        }
+        return crypto_sign_verify_ctx(sig, siglen, m, mlen, once.get());
+    }
+
+    // Key = sec_lvl || H(pk)
+    shake256(tr, SEEDBYTES, pk, p->PUBLICKEYBYTES);
+    key.assign(1, (char)sec_lvl);
+    key.append((const char *)tr, SEEDBYTES);
+
+    ctx = lookup(cache, key);
+    if (ctx == nullptr)
+    {
+        // ExpandA and NTT(t1) run outside the lock
+        std::shared_ptr<verify_ctx> fresh(new (std::nothrow) verify_ctx);
+        if (fresh == nullptr)
+        {
+            return -1;
+        }
+        // A context that failed to build is never cached
+        if (verify_ctx_init(fresh.get(), pk, sec_lvl))
+        {
+            return -1;
+        }
+        ctx = insert(cache, key, std::move(fresh));
+    }
+
+    return crypto_sign_verify_ctx(sig, siglen, m, mlen, ctx.get());
+}
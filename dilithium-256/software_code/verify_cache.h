@@ -0,0 +1,63 @@
+/*
+ * From our research paper "High-Performance Hardware Implementation of CRYSTALS-Dilithium"
+ * by Luke Beckwith, Duc Tri Nguyen, Kris Gaj
+ * at George Mason University, USA
+ * https://eprint.iacr.org/2021/1451.pdf
+ * =============================================================================
+ * Copyright (c) 2021 by Cryptographic Engineering Research Group (CERG)
+ * ECE Department, George Mason University
+ * Fairfax, VA, U.S.A.
+ * Author: Duc Tri Nguyen
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * =============================================================================
+ * @author   Duc Tri Nguyen <dnguye69@gmu.edu>
+ */
+
+#ifndef VERIFY_CACHE_H
+#define VERIFY_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "context.h"
+
+/*
+ * Thread-safe LRU cache of verify_ctx, keyed by sec_lvl and H(pk) = tr.
+ * At most `budget` bytes of contexts stay resident, the least recently
+ * used ones are dropped first. A budget below VERIFY_CACHE_ENTRY_BYTES
+ * disables caching, every call then builds its context on the heap.
+ */
+#define VERIFY_CACHE_ENTRY_BYTES sizeof(verify_ctx)
+
+typedef struct verify_cache verify_cache;
+
+typedef struct
+{
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t entries;
+} verify_cache_stats;
+
+// Return NULL on allocation failure
+verify_cache *verify_cache_new(size_t budget);
+
+void verify_cache_free(verify_cache *cache);
+
+void verify_cache_get_stats(verify_cache *cache, verify_cache_stats *stats);
+
+// Same result as crypto_sign_verify, reusing A and NTT(t1 * 2^D) of known keys
+int crypto_sign_verify_cached(verify_cache *cache,
+                              const uint8_t *sig, size_t siglen,
+                              const uint8_t *m, size_t mlen,
+                              const uint8_t *pk, int sec_lvl);
+
+#endif